@@ -0,0 +1,80 @@
+/*! \file aiScheduler.h
+* \brief Header file for deciding which AI tanks think each timestep (The AiScheduler class).
+*
+* Contains the level of detail settings, and the scheduler that gives each AI tank a think rate from how close it is to danger and keeps each timestep within a budget of thinks.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include "gameSnapshot.h"
+
+/*! \struct AiScheduleSettings
+* \brief How often AI tanks think, by how close the nearest enemy tank or shell is.
+*/
+struct AiScheduleSettings
+{
+	float fContactRange; //!< Tanks with an enemy tank or shell this close are in contact, and think every timestep.
+	float fNearRange; //!< Tanks with an enemy this close, but not in contact, think every other timestep.
+	int iMaxPeriod; //!< Timesteps between thinks for tanks further from any enemy, 1 to think every timestep. Also caps the near range's period.
+	int iBudget; //!< Most thinks in a timestep, never exceeded. Tanks in contact go first and take turns if there are more of them. 0 for no limit.
+	AiScheduleSettings() : fContactRange(400.f), fNearRange(800.f), iMaxPeriod(1), iBudget(0) {} //!< Defaults think every timestep, as the classic game always has, set iMaxPeriod to let tanks away from danger think less. Vision reaches 250 so contact starts well before anything can be seen.
+};
+
+/*! \class AiScheduler
+* \brief Level of detail for AI tanks.
+*
+* Each timestep the game reports the distance from every AI tank to its nearest enemy tank or shell, and decide picks the tanks that run their full NewTank::move.
+* The rest coast on their last controls. Tanks with the same period are staggered by index, so their thinks spread evenly over the timesteps.
+* The budget is a hard cap. Tanks in contact take the room first, then the rest, longest waiting first within each, so tanks kept waiting take turns and every tank thinks eventually.
+* The budget counts thinks rather than time, so a game plays the same however fast the machine is, and replays and snapshots stay exact.
+*/
+class AiScheduler
+{
+private:
+	AiScheduleSettings settings; //!< Think rates and budget.
+	std::vector<char> vbScheduled; //!< Does the scheduler pick when each tank thinks? The player's tank and DumbTanks aren't scheduled.
+	std::vector<float> vfDistance; //!< Distance from each tank to its nearest enemy tank or shell this timestep.
+	std::vector<int> viPeriod; //!< Timesteps between thinks for each tank.
+	std::vector<int> viSinceThink; //!< Timesteps since each tank last thought.
+	std::vector<char> vbThinks; //!< Does each tank think this timestep?
+	std::vector<int> viWaiting; //!< Tanks due to think, reused each timestep.
+	unsigned long long ullThinks; //!< Thinks so far.
+	unsigned long long ullCoasts; //!< Timesteps tanks have coasted so far.
+public:
+	AiScheduler(); //!< Default constructor for AiScheduler, with the default settings and no tanks.
+
+	void setSettings(const AiScheduleSettings &newSettings) { settings = newSettings; } //!< Changes the think rates and budget.
+	const AiScheduleSettings &getSettings() const { return settings; } //!< Returns the think rates and budget.
+
+	//! Sets the tanks, every scheduled tank thinks on the next timestep.
+	/*!
+	* \param vbNewScheduled Whether the scheduler picks when each tank thinks.
+	*/
+	void resize(const std::vector<char> &vbNewScheduled);
+
+	//! Starts a timestep, with every tank as far from any enemy as can be.
+	void begin();
+
+	//! Reports an enemy tank or shell near a tank, keeping the nearest.
+	/*!
+	* \param i Index of the tank.
+	* \param fDistance Distance to the enemy.
+	*/
+	void nearEnemy(int i, float fDistance) { if (fDistance < vfDistance[i]) vfDistance[i] = fDistance; }
+
+	//! Gives every AI tank its think rate and picks the tanks that think this timestep.
+	/*!
+	* \param uiTick The game's timestep, used to stagger tanks with the same rate.
+	*/
+	void decide(unsigned int uiTick);
+
+	bool thinks(int i) const { return vbThinks[i] != 0; } //!< Does tank i think this timestep?
+	int getPeriod(int i) const { return viPeriod[i]; } //!< Timesteps between thinks for tank i.
+	unsigned long long getThinks() const { return ullThinks; } //!< Thinks so far.
+	unsigned long long getCoasts() const { return ullCoasts; } //!< Timesteps tanks have coasted so far.
+
+	void saveState(GameSnapshot &snapshot) const; //!< Writes the settings and each tank's rate and wait into a snapshot.
+	bool loadState(GameSnapshot &snapshot); //!< Reads them back from a snapshot, returns false if it runs out or the number of tanks differs.
+};
@@ -1,16 +1,14 @@
 #ifndef BOUNDINGBOX_H
 #define BOUNDINGBOX_H
 
-#include <SFML/Graphics.hpp>
+#include <algorithm>
 
-class BoundingBox : public sf::Drawable
+class BoundingBox
 {
 private:
 	float x1, x2, y1, y2;
 public:
 	BoundingBox(); //!< Empty construtor
-	~BoundingBox(); // Destructor
-	virtual void draw(sf::RenderTarget &target, sf::RenderStates states) const; // Draw BB
 	void set(float xa, float ya, float xb, float yb);
 	float getX1() const { return x1; }
 	float getY1() const { return y1; }
@@ -18,7 +16,8 @@ public:
 	float getY2() const { return y2; }
 	float getXc() const { return (x1 + x2) / 2.0f; }
 	float getYc() const { return (y1 + y2) / 2.0f; }
-	bool collision(BoundingBox otherBb) const;
+	bool collision(const BoundingBox &otherBb) const;
 	bool lineCollision(float x1, float y1, float x2, float y2) const;
+	bool sweptCollision(const BoundingBox &otherBb, float dx, float dy, float &time) const; // Sweep otherBb by (dx, dy), time is the fraction of the move at first contact
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,56 @@
+/*! \file boxStore.h
+* \brief Header file for the packed bounding box container (The BoxStore class).
+*
+* Contains the corners of many bounding boxes laid out as separate arrays, and the SIMD kernel used to test a box against all of them.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include "boundingBox.h"
+
+/*! \class BoxStore
+* \brief Structure-of-arrays store of bounding boxes.
+*
+* Used for the obstacles, buildings and tanks, so a tank or shell can be tested against several boxes per instruction.
+*/
+class BoxStore
+{
+private:
+	static const int s_kiLanes = 8; //!< Arrays are padded to a multiple of this many boxes so the kernel never needs a scalar tail.
+
+	std::vector<float> vfX1; //!< Left edges.
+	std::vector<float> vfY1; //!< Top edges.
+	std::vector<float> vfX2; //!< Right edges.
+	std::vector<float> vfY2; //!< Bottom edges.
+	int iCount; //!< Number of boxes stored (The rest of the arrays is padding).
+
+	void setPadding(int i); //!< Makes slot i a box that nothing can collide with.
+public:
+	BoxStore(); //!< Default constructor for BoxStore.
+
+	void add(const BoundingBox &box); //!< Adds a box to the end of the store.
+	void set(int i, const BoundingBox &box); //!< Replaces box i.
+	void remove(int i); //!< Removes box i, keeping the order of the others.
+	void clear(); //!< Removes every box.
+	int size() const { return iCount; } //!< Number of boxes stored.
+	BoundingBox get(int i) const; //!< Returns box i.
+	float getXc(int i) const { return (vfX1[i] + vfX2[i]) / 2.0f; } //!< Centre of box i in x, as BoundingBox::getXc.
+	float getYc(int i) const { return (vfY1[i] + vfY2[i]) / 2.0f; } //!< Centre of box i in y, as BoundingBox::getYc.
+
+	//! Returns a bit mask of which of the 32 boxes starting at iFirst collide with a box.
+	/*!
+	* \param box The box to test.
+	* \param iFirst Index of the first box to test, bit 0 of the result.
+	*/
+	unsigned int collisionMask(const BoundingBox &box, int iFirst) const;
+
+	//! Returns the index of the first box colliding with a box, or -1 if there is none.
+	/*!
+	* \param box The box to test.
+	*/
+	int firstCollision(const BoundingBox &box) const;
+
+	bool collision(const BoundingBox &box) const { return firstCollision(box) >= 0; } //!< Does a box collide with any box in the store?
+};
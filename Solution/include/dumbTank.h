@@ -21,5 +21,7 @@ public:
 	void markShell(Position p);
 	bool isFiring();
 	void score(int thisScore, int enemyScore);
+	void saveState(GameSnapshot &snapshot) const;
+	bool loadState(GameSnapshot &snapshot);
 };
 #endif
\ No newline at end of file
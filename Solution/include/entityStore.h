@@ -0,0 +1,194 @@
+/*! \file entityStore.h
+* \brief Header file for the entities of the game (The EntityStore class).
+*
+* Contains every wall, building, tank and shell as sets of parallel component arrays, so the game's systems walk them in one pass.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include "boundingBox.h"
+#include "boxStore.h"
+#include "gameSnapshot.h"
+#include "position.h"
+
+#define COLOUR(r, g, b) ((unsigned int)(r) << 24 | (unsigned int)(g) << 16 | (unsigned int)(b) << 8 | 0xFFu) // Pack a colour as 0xRRGGBBAA, the layout sf::Color takes
+
+// What drives a tank, the game keeps one list of controllers of each kind
+enum TankControl { CONTROL_PLAYER, CONTROL_STATE_MACHINE, CONTROL_LOOKAHEAD, CONTROL_DUMB };
+
+/*! \class EntityStore
+* \brief Dense structure-of-arrays store of the game's entities.
+*
+* Entities of each kind share a table, and entity i of a kind is slot i of each of its component arrays.
+* Scenery is the walls and buildings. Walls have no team, buildings belong to one and are destroyed by a single hit. Removing scenery keeps the order of the rest, so systems that stop at the first hit behave the same however the store got there.
+* Tanks have a position and heading, the turret's heading, a bounding box, team, health, ammo, reload and visibility, and an AI-state component saying which of the game's controllers drives them. The Tank objects hold only their controls and work on their slot here.
+* Shells have a position and heading, the position they last moved from and were fired from, a team and visibility. Live shells are the first shellCount() slots of arrays allocated up front, and destroying one moves the last live shell into its slot.
+*/
+class EntityStore
+{
+private:
+	BoxStore boxes; //!< Bounding box component, packed for the SIMD collision kernel.
+	std::vector<int> viTeam; //!< Team component, s_kiNoTeam for walls.
+	std::vector<unsigned int> vuiColour; //!< Colour component, packed by COLOUR.
+	std::vector<unsigned char> vbVisible; //!< Seen by the player component, walls are always shown.
+	std::vector<int> viTeamCount; //!< Number of buildings each team has left.
+
+	std::vector<float> vfTankX; //!< Tank position component, x.
+	std::vector<float> vfTankY; //!< Tank position component, y.
+	std::vector<float> vfTankHeading; //!< Tank heading component.
+	std::vector<float> vfTankOldX; //!< Tank position before its last move, x, to back out of collisions.
+	std::vector<float> vfTankOldY; //!< Tank position before its last move, y.
+	std::vector<float> vfTankOldHeading; //!< Tank heading before its last move.
+	std::vector<float> vfTurret; //!< Turret heading component.
+	BoxStore tankBoxes; //!< Tank bounding box component, kept in step with the position.
+	std::vector<int> viTankTeam; //!< Tank team component.
+	std::vector<int> viHealth; //!< Hits each tank can still take.
+	std::vector<int> viAmmo; //!< Shells each tank has left.
+	std::vector<int> viReload; //!< Game ticks until each tank can fire again.
+	std::vector<unsigned char> vbTankVisible; //!< Is each tank shown, AI tanks only while the player can see them.
+	std::vector<unsigned char> vucControl; //!< AI-state component, what drives each tank, a TankControl.
+	std::vector<int> viControlSlot; //!< AI-state component, index of each tank's controller in the game's list of that kind.
+
+	std::vector<float> vfShellX; //!< Shell position component, x.
+	std::vector<float> vfShellY; //!< Shell position component, y.
+	std::vector<float> vfShellHeading; //!< Shell heading component.
+	std::vector<float> vfShellPrevX; //!< Shell position at the start of the last move, x, for swept collisions.
+	std::vector<float> vfShellPrevY; //!< Shell position at the start of the last move, y.
+	std::vector<float> vfFiredX; //!< Where each shell was fired from, x, as only what the tank could see can be hit.
+	std::vector<float> vfFiredY; //!< Where each shell was fired from, y.
+	std::vector<float> vfFiredHeading; //!< Heading each shell was fired on.
+	std::vector<int> viShellTeam; //!< Team of the tank that fired each shell.
+	std::vector<unsigned char> vbShellVisible; //!< Has the player seen each shell?
+	int iShells; //!< Number of live shells.
+
+	void setTankBox(int i); //!< Moves tank i's bounding box to its position.
+public:
+	static const int s_kiNoTeam = -1; //!< Team of walls.
+	static const int s_kiTankHealth = 1; //!< Hits a tank takes before it is destroyed.
+	static const float s_kfTankHalfSize; //!< Half the width and height of a tank's bounding box.
+	static const float s_kfShellHalfSize; //!< Half the width and height of a shell's bounding box.
+	static const float s_kfShellSpeed; //!< Distance a shell travels each game tick.
+
+	EntityStore(); //!< Default constructor for EntityStore, holds nothing and has no room for shells.
+
+	//! Adds scenery to the end of the store.
+	/*!
+	* \param box Its bounding box.
+	* \param iTeam Team of a building, or s_kiNoTeam for a wall.
+	* \param uiColour Colour to draw it, packed by COLOUR.
+	*/
+	void add(const BoundingBox &box, int iTeam, unsigned int uiColour);
+
+	//! Adds scenery to the end of the store.
+	/*!
+	* \param fX1 Left edge.
+	* \param fY1 Top edge.
+	* \param fX2 Right edge.
+	* \param fY2 Bottom edge.
+	* \param iTeam Team of a building, or s_kiNoTeam for a wall.
+	* \param uiColour Colour to draw it, packed by COLOUR.
+	*/
+	void add(float fX1, float fY1, float fX2, float fY2, int iTeam, unsigned int uiColour);
+
+	void remove(int i); //!< Destroys scenery i, keeping the order of the others.
+	void clear(); //!< Removes all the scenery.
+
+	int size() const { return (int)viTeam.size(); } //!< Number of walls and buildings.
+	const BoxStore &getBoxes() const { return boxes; } //!< Bounding boxes of the walls and buildings, for collision masks.
+	BoundingBox getBox(int i) const { return boxes.get(i); } //!< Bounding box of scenery i.
+	int getTeam(int i) const { return viTeam[i]; } //!< Team of scenery i, s_kiNoTeam for a wall.
+	bool isBuilding(int i) const { return viTeam[i] != s_kiNoTeam; } //!< Is scenery i a building?
+	unsigned int getColour(int i) const { return vuiColour[i]; } //!< Colour of scenery i.
+	bool isVisible(int i) const { return vbVisible[i] != 0; } //!< Has the player seen scenery i?
+	void setVisible(int i) { vbVisible[i] = 1; } //!< Marks scenery i as seen by the player.
+	int buildingsLeft(int iTeam) const { return iTeam < (int)viTeamCount.size() ? viTeamCount[iTeam] : 0; } //!< Number of buildings a team has left.
+
+	//! Adds a tank to the end of the store, at the origin with full health and its turret facing the way it does, and returns its index.
+	/*!
+	* \param iTeam Its team.
+	* \param iControl What drives it, a TankControl.
+	* \param iSlot Index of its controller in the game's list of that kind.
+	* \param iAmmo Shells it starts with.
+	*/
+	int addTank(int iTeam, int iControl, int iSlot, int iAmmo);
+
+	//! Puts a tank back as addTank left it, keeping its team and controller.
+	/*!
+	* \param i Index of the tank.
+	* \param iAmmo Shells it starts with.
+	*/
+	void renewTank(int i, int iAmmo);
+
+	void clearTanks(); //!< Removes every tank.
+
+	int tankCount() const { return (int)viTankTeam.size(); } //!< Number of tanks.
+	Position getTankPos(int i) const { Position p; p.set(vfTankX[i], vfTankY[i], vfTankHeading[i]); return p; } //!< Position and heading of tank i.
+	void setTankPos(int i, const Position &pos); //!< Moves tank i, and its bounding box with it.
+	Position getTankOldPos(int i) const { Position p; p.set(vfTankOldX[i], vfTankOldY[i], vfTankOldHeading[i]); return p; } //!< Position and heading of tank i before its last move.
+	void markTankPos(int i) { vfTankOldX[i] = vfTankX[i]; vfTankOldY[i] = vfTankY[i]; vfTankOldHeading[i] = vfTankHeading[i]; } //!< Records tank i's position before it moves.
+	void recallTankPos(int i) { setTankPos(i, getTankOldPos(i)); } //!< Puts tank i back where it was before its last move.
+	float getTurret(int i) const { return vfTurret[i]; } //!< Heading of tank i's turret.
+	void setTurret(int i, float fHeading) { vfTurret[i] = fHeading; } //!< Turns tank i's turret to a heading.
+	BoundingBox getTankBox(int i) const { return tankBoxes.get(i); } //!< Bounding box of tank i.
+	const BoxStore &getTankBoxes() const { return tankBoxes; } //!< Bounding boxes of every tank, for collision masks.
+	float getTankXc(int i) const { return tankBoxes.getXc(i); } //!< Centre of tank i's bounding box in x.
+	float getTankYc(int i) const { return tankBoxes.getYc(i); } //!< Centre of tank i's bounding box in y.
+	int getTankTeam(int i) const { return viTankTeam[i]; } //!< Team of tank i.
+	int getHealth(int i) const { return viHealth[i]; } //!< Hits tank i can still take.
+	bool damageTank(int i) { return --viHealth[i] <= 0; } //!< Takes a hit off tank i's health, returns true if that destroyed it.
+	void repairTank(int i) { viHealth[i] = s_kiTankHealth; } //!< Gives tank i full health.
+	int getAmmo(int i) const { return viAmmo[i]; } //!< Shells tank i has left.
+	void setAmmo(int i, int iAmmo) { viAmmo[i] = iAmmo; } //!< Sets the shells tank i has left.
+	bool anyAmmo() const; //!< Does any tank have a shell left?
+	int getReload(int i) const { return viReload[i]; } //!< Game ticks until tank i can fire again.
+	void setReload(int i, int iTicks) { viReload[i] = iTicks; } //!< Sets the game ticks until tank i can fire again.
+	bool isTankVisible(int i) const { return vbTankVisible[i] != 0; } //!< Is tank i shown?
+	void setTankVisible(int i, bool bVisible) { vbTankVisible[i] = bVisible ? 1 : 0; } //!< Shows or hides tank i.
+	int getControl(int i) const { return vucControl[i]; } //!< What drives tank i, a TankControl.
+	int getControlSlot(int i) const { return viControlSlot[i]; } //!< Index of tank i's controller in the game's list of its kind.
+
+	void setShellCapacity(int iCapacity); //!< Allocates the shell slots, should be the most shells that can be in play at once.
+	int shellCapacity() const { return (int)viShellTeam.size(); } //!< Number of shell slots.
+	int shellCount() const { return iShells; } //!< Number of live shells.
+	void clearShells() { iShells = 0; } //!< Destroys every shell.
+
+	//! Starts a new shell in a free slot, returns false if there is no room.
+	/*!
+	* \param pos Firing position and heading of the shell.
+	* \param iTeam Team of the tank that fired it.
+	*/
+	bool fireShell(const Position &pos, int iTeam);
+
+	//! Destroys a live shell, the last live shell takes its index.
+	/*!
+	* \param i Index of the shell to destroy.
+	*/
+	void removeShell(int i);
+
+	//! Moves every live shell along its heading.
+	/*!
+	* \param fSteps Game ticks to travel.
+	*/
+	void moveShells(float fSteps);
+
+	Position getShellPos(int i) const { Position p; p.set(vfShellX[i], vfShellY[i], vfShellHeading[i]); return p; } //!< Position and heading of shell i.
+	BoundingBox getShellBox(int i) const { BoundingBox box; box.set(vfShellX[i] - s_kfShellHalfSize, vfShellY[i] - s_kfShellHalfSize, vfShellX[i] + s_kfShellHalfSize, vfShellY[i] + s_kfShellHalfSize); return box; } //!< Bounding box of shell i.
+	int getShellTeam(int i) const { return viShellTeam[i]; } //!< Team of the tank that fired shell i.
+	bool isShellVisible(int i) const { return vbShellVisible[i] != 0; } //!< Has the player seen shell i?
+	void setShellVisible(int i) { vbShellVisible[i] = 1; } //!< Marks shell i as seen by the player.
+	bool couldSeeWhenFired(int i, const BoundingBox &object) const; //!< Could the tank that fired shell i see the object as it fired?
+	BoundingBox sweptBounds(int i) const; //!< Box around everything shell i passed through during its last move.
+
+	//! Did shell i pass through an object during its last move?
+	/*!
+	* \param i Index of the shell.
+	* \param object The object's bounding box.
+	* \param fTime Set to when in the move the shell hit, as a fraction of the move.
+	*/
+	bool sweptCollision(int i, const BoundingBox &object, float &fTime) const;
+
+	void saveState(GameSnapshot &snapshot) const; //!< Writes every entity into a snapshot.
+	bool loadState(GameSnapshot &snapshot); //!< Reads the entities back from a snapshot, returns false if it runs out, the shells don't fit or the tanks differ.
+};
@@ -0,0 +1,43 @@
+/*! \file fixedTimestep.h
+* \brief Header file for the game loop's tick scheduler (The FixedTimestep class).
+*
+* Contains the accumulator that decides how many game ticks are due, and the pacing that waits for the next one.
+*/
+
+#pragma once
+
+#include <chrono>
+
+/*! \class FixedTimestep
+* \brief Fixed timestep scheduler.
+*
+* Real time is added to an accumulator and spent in whole ticks, so the game runs at the same rate however fast frames are drawn.
+* If the loop falls behind it catches up by running several ticks at once, up to a limit, after which the time is dropped so a long stall can't cause a burst of ticks.
+* In uncapped mode ticks are always due and nothing waits, for benchmarking.
+*/
+class FixedTimestep
+{
+private:
+	typedef std::chrono::steady_clock Clock; //!< Clock used for pacing.
+
+	Clock::duration tickLength; //!< Real time per tick.
+	Clock::duration accumulator; //!< Real time not yet spent on ticks.
+	Clock::time_point lastTime; //!< When the accumulator was last updated.
+	int iMaxCatchUp; //!< Most ticks run by one call to ticksDue.
+	bool bUncapped; //!< If true, run as fast as possible.
+public:
+	//! Constructor for FixedTimestep.
+	/*!
+	* \param fTicksPerSecond The tick rate.
+	* \param iNewMaxCatchUp Most ticks to run at once when catching up.
+	*/
+	FixedTimestep(float fTicksPerSecond = 40.f, int iNewMaxCatchUp = 5);
+
+	void setTickRate(float fTicksPerSecond); //!< Changes the tick rate.
+	void setUncapped(bool bNewUncapped); //!< Turns uncapped mode on or off.
+	bool isUncapped() const { return bUncapped; } //!< Is uncapped mode on?
+	void reset(); //!< Empties the accumulator and restarts timing from now, call after a pause.
+
+	int ticksDue(); //!< Returns how many ticks to run now, and takes their time out of the accumulator.
+	void waitForNextTick() const; //!< Sleeps until the next tick is due (Returns straight away in uncapped mode).
+};
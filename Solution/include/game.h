@@ -1,43 +1,133 @@
 #ifndef GAME_H
 #define GAME_H
 
-#include <SFML/Graphics.hpp>
-#include <list>
+#include <SFML/Window/Keyboard.hpp>
+#include <memory>
+#include <vector>
 
-#include "NewTank.h"
+#include "newTank.h"
+#include "lookaheadTank.h"
+#include "dumbTank.h"
 #include "playerTank.h"
-#include "obstacle.h"
-#include "shell.h"
+#include "entityStore.h"
+#include "random.h"
+#include "gameSnapshot.h"
+#include "spatialGrid.h"
+#include "knowledgeGrid.h"
+#include "aiScheduler.h"
+
+class ReplayLog;
 
 using namespace std;
 
-class Game : public sf::Drawable
+enum { RED_TEAM = 0, BLUE_TEAM = 1 }; // The two teams with buildings, any further teams only have tanks
+
+struct GameSetup // How many tanks play and how big the arena is, the defaults are the classic one on one game
+{
+	int teams; // Number of teams, at least two
+	int tanksPerTeam; // Tanks in each team, the first blue tank is the player's if there is one and the rest are AI tanks
+	float arenaWidth; // Width of the arena including its walls
+	float arenaHeight; // Height of the arena including its walls
+	int lookaheadTeam; // Team whose AI tanks are LookaheadTanks, -1 for none
+	bool hasPlayer; // Is the first blue tank the player's? Without a player an AI tank takes its place, so the teams are even for tuning
+	int dumbTeam; // Team whose AI tanks are DumbTanks, a floor for tuning, -1 for none. Not the lookahead team
+	GameSetup() : teams(2), tanksPerTeam(1), arenaWidth(800.f), arenaHeight(580.f), lookaheadTeam(-1), hasPlayer(true), dumbTeam(-1) {}
+	bool operator==(const GameSetup &other) const { return teams == other.teams && tanksPerTeam == other.tanksPerTeam && arenaWidth == other.arenaWidth && arenaHeight == other.arenaHeight && lookaheadTeam == other.lookaheadTeam && hasPlayer == other.hasPlayer && dumbTeam == other.dumbTeam; }
+};
+
+class Game
 {
 private:
+	GameSetup setup; // Teams, tanks and arena size
 	unsigned short lives; // number of lives left
 	bool debugMode; // toggle for debug mode
-	sf::RectangleShape background; // Background the playing area
-	sf::RectangleShape ammoArea; // Background where the ammo is drawn
-	list<Obstacle> obstacles; // Obstacles in the tanks way
-	list<Obstacle> blueBuildings; // Collection of blue buildings
-	list<Obstacle> redBuildings; // Collection of red buildings
-	list<Shell> shells; // Shells fired from tanks
-	void resetNpc(); // Move the NPC after it has been shot
-	void resetPlayer(); // Move the player after it has been shot
-	void fireShell(Position fp, bool npc); // Fire a shell
-	int redScore; // Score of red tank
-	int blueScore; // Score of blue tank
+	unsigned short tickScale; // Number of game ticks advanced by each call to play()
+	unsigned int tick; // Number of timesteps played
+	ReplayLog *recording; // Log the key presses are recorded into, null when not recording
+	EntityStore entities; // Walls, buildings, tanks and shells, the tanks team by team
+	bool sceneryCollision(const BoundingBox &bb) const; // Does the bounding box hit any wall or building?
+	vector<NewTank> aiTanks; // Controls of every tank but the player's, the lookahead tanks and the DumbTanks
+	vector<LookaheadTank> lookaheadTanks; // Controls of the AI tanks of the lookahead team
+	vector<DumbTank> dumbTanks; // Controls of the AI tanks of the dumb team
+	// Controls of tank i, found from its AI-state components in the store
+	Tank *tank(int i); // Whatever its kind
+	NewTank *tankAi(int i); // Null for the player's and the DumbTanks
+	LookaheadTank *tankLookahead(int i); // Null but for the lookahead tanks
+	DumbTank *tankDumb(int i); // Null but for the DumbTanks
+	AITank *anyAi(int i); // Null for the player's
+	void bindTanks(); // Point every tank's controls at its slot in this game's store
+	int playerIndex; // Index of the player's tank, -1 without a player
+	vector<int> teamScores; // Score of each team
+	SpatialGrid tankGrid; // Tanks by position, so collision and vision only check nearby tanks
+	SpatialGrid shellGrid; // Shells by position, rebuilt each timestep for the AI tanks' vision
+	vector<int> nearby; // Reused results of grid queries
+	vector<KnowledgeGrid> teamKnowledge; // What each team's AI tanks saw this timestep, shared between them
+	vector<int> buildingMarks; // Team that last marked each building this timestep, so a team marks it once
+	vector<int> tankMarks; // Team that last marked each tank this timestep, so a team marks it once
+	AiScheduler aiSchedule; // Which AI tanks think each timestep, the rest coast on their last controls
+	LookaheadSettings lookahead; // How the lookahead tanks plan
+	std::unique_ptr<Game> rollout; // Copy of this game the lookahead tanks' plans are tried in, built by the first plan
+	bool inRollout; // Is this game a rollout? Its lookahead tanks follow the plan they were given and never plan
+	unsigned long long lookaheadDecisions; // Plans made by this game's lookahead tanks
+	unsigned long long lookaheadRollouts; // Rollouts played for them
+	double lookaheadSeconds; // Time spent planning
+	void planLookahead(int i); // Try each action for lookahead tank i in rollouts, and give it the one that gained its team the most
+	int scoreMargin(int team) const; // A team's score less the best of the other teams'
+	void scheduleAi(); // Tell the scheduler how close each AI tank is to an enemy tank or shell, and let it pick the tanks that think
+	void buildArena(); // Add the walls, and the bases at random spots in their quarters of the arena
+	void createTanks(); // Build the tanks, grids and shell slots for the setup
+	void scheduleTanks(); // Start the AI scheduler again, with the tanks it schedules
+	void placeTank(int i); // Update a tank's place in the grid after it moves
+	bool tankCollision(int i); // Does tank i hit any other tank?
+	void resetTank(int i); // Move a tank to a free spot in its team's side of the arena after it has been shot
+	void fireShell(int i); // Fire a shell from tank i, if it can
+	void award(int team, int victimTeam, int points); // Score a hit by a team on another, hitting your own side scores for everyone else
+	void reportScores(); // Show the scores in the console
+	unsigned long long seed; // Seed the game was started with
+	Random rng; // Random numbers for this game only, shared with the AI tank
 public:
-	Game(); // Constructor
+	Game(); // Constructor, seeded from the clock
+	explicit Game(unsigned long long gameSeed, const GameSetup &gameSetup = GameSetup()); // Constructor, the same seed, setup and input always play the same game
+	Game(const Game &) = delete; // Not copyable, the AI tank points at this game's generator, use snapshots to copy a game
+	Game &operator=(const Game &) = delete;
 	~Game(); // Destructor
-	virtual void draw(sf::RenderTarget &target, sf::RenderStates states) const; // Draw the game
+	void cloneFrom(const Game &other); // Become a copy of another game, copying its state straight across rather than through a snapshot, and reusing this game's memory
+	void restart(unsigned long long gameSeed); // Start a new game with another seed and the same setup, tick scale, AI schedule and tank tuning, reusing this game's memory
 	void play(); // Play the game for one timestep
-	NewTank npc; // Red tank
-	PlayerTank player; // Blue tank
+	void setTickScale(unsigned short ticks); // Advance several game ticks per timestep, shells use swept collisions so they can't pass through walls
+	void setAiSchedule(const AiScheduleSettings &settings) { aiSchedule.setSettings(settings); } // How often AI tanks away from any enemy think, and the most thinks in a timestep
+	void setTeamParams(int team, const NewTankParams &params); // Tuning constants for every AI tank in a team
+	void setLookahead(const LookaheadSettings &settings); // How far ahead and how hard the lookahead tanks plan, a time budget means the game won't replay the same
+	const LookaheadSettings &getLookahead() const { return lookahead; }
+	unsigned long long getLookaheadDecisions() const { return lookaheadDecisions; }
+	unsigned long long getLookaheadRollouts() const { return lookaheadRollouts; }
+	double getLookaheadSeconds() const { return lookaheadSeconds; }
+	const AiScheduler &getAiScheduler() const { return aiSchedule; }
+	PlayerTank player; // Blue tank steered from the keyboard, not in the game without a player
 	void keyPressed(sf::Keyboard::Key key); // function for processing input
 	void keyReleased(sf::Keyboard::Key key); // function for processing input
 	bool gameOver() const; // Has the game finished?
+	void setRecording(ReplayLog *log); // Record every key press and release, and keyframes, from now on into a log started with ReplayLog::begin, null to stop
+	size_t simulationBytes() const; // Memory the simulation touches each timestep, not counting anything only used for drawing
+	void saveSnapshot(GameSnapshot &snapshot) const; // Write the full state of the game into a snapshot
+	bool loadSnapshot(GameSnapshot &snapshot); // Restore a snapshot saved by any game, false (and the game left unusable) if it is not a valid snapshot
 	int numBlueBuildings() const; // Count of blue buildings
 	int numRedBuildings() const; // Count of red buildings
+	// Read only state for drawing, the game itself draws nothing
+	bool isDebugMode() const { return debugMode; }
+	const EntityStore &getEntities() const { return entities; }
+	int getRedScore() const { return teamScores[RED_TEAM]; }
+	int getBlueScore() const { return teamScores[BLUE_TEAM]; }
+	int getScore(int team) const { return teamScores[team]; }
+	const GameSetup &getSetup() const { return setup; }
+	int numTanks() const { return entities.tankCount(); }
+	const Tank &getTank(int i) const { return *const_cast<Game *>(this)->tank(i); }
+	const NewTank *getAiTank(int i) const { return const_cast<Game *>(this)->tankAi(i); } // Null for the player's tank and DumbTanks
+	const DumbTank *getDumbTank(int i) const { return const_cast<Game *>(this)->tankDumb(i); } // Null unless a DumbTank
+	int getTankTeam(int i) const { return entities.getTankTeam(i); }
+	int getPlayerIndex() const { return playerIndex; }
+	unsigned long long getSeed() const { return seed; }
+	unsigned short getTickScale() const { return tickScale; }
+	unsigned int getTick() const { return tick; }
 };
 #endif
\ No newline at end of file
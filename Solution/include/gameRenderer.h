@@ -0,0 +1,67 @@
+/*! \file gameRenderer.h
+* \brief Header file for drawing the game (The GameRenderer class).
+*
+* Contains everything that turns the state of a game into SFML drawables, so the simulation itself never touches the graphics library.
+*/
+
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <memory>
+
+#include "game.h"
+
+/*! \class GameRenderer
+* \brief Draws a game.
+*
+* Holds the textures and font, and builds the shapes and sprites from the game's state each frame.
+* Only the windowed build uses it, the headless runner links the game without it.
+*/
+class GameRenderer : public sf::Drawable
+{
+private:
+	const Game &game; //!< Game being drawn.
+
+	std::shared_ptr<const sf::Texture> redBodyTex; //!< Texture for the AI tank's body.
+	std::shared_ptr<const sf::Texture> redTurretTex; //!< Texture for the AI tank's turret.
+	std::shared_ptr<const sf::Texture> blueBodyTex; //!< Texture for the player tank's body.
+	std::shared_ptr<const sf::Texture> blueTurretTex; //!< Texture for the player tank's turret.
+	std::shared_ptr<const sf::Font> font; //!< Font for the scores.
+
+	//! Draws the outline of a bounding box.
+	/*!
+	* \param target The target being rendered to.
+	* \param bb The box to outline.
+	*/
+	void drawBox(sf::RenderTarget &target, const BoundingBox &bb) const;
+
+	//! Draws a tank.
+	/*!
+	* \param target The target being rendered to.
+	* \param tank The tank to draw.
+	* \param bodyTex Texture for the tank's body.
+	* \param turretTex Texture for the tank's turret.
+	* \param tint Colour multiplied into the textures.
+	*/
+	void drawTank(sf::RenderTarget &target, const Tank &tank, const std::shared_ptr<const sf::Texture> &bodyTex, const std::shared_ptr<const sf::Texture> &turretTex, const sf::Color &tint = sf::Color::White) const;
+
+	//! Draws the AI tank's map nodes.
+	/*!
+	* \param target The target being rendered to.
+	* \param map The map to draw.
+	*/
+	void drawMap(sf::RenderTarget &target, const Map &map) const;
+public:
+	//! Constructor for GameRenderer.
+	/*!
+	* \param newGame The game to draw, must outlive the renderer.
+	*/
+	GameRenderer(const Game &newGame);
+
+	//! Draws the game.
+	/*!
+	* \param target The target being rendered to.
+	* \states Render states.
+	*/
+	void draw(sf::RenderTarget &target, sf::RenderStates states) const;
+};
@@ -0,0 +1,72 @@
+/*! \file gameSnapshot.h
+* \brief Header file for saved game states (The GameSnapshot class).
+*
+* Contains the flat byte buffer a game's state is written into and read back from.
+*/
+
+#pragma once
+
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+/*! \class GameSnapshot
+* \brief Flat buffer holding the full state of a game.
+*
+* Filled by Game::saveSnapshot and read back by Game::loadSnapshot. Everything is stored as plain bytes, so a snapshot can be copied, kept or written to disk as one block.
+* The buffer keeps its memory between saves, so saving over an old snapshot doesn't allocate.
+*/
+class GameSnapshot
+{
+private:
+	std::vector<unsigned char> vBytes; //!< The saved state.
+	size_t readPos; //!< Where the next read starts.
+public:
+	GameSnapshot() { readPos = 0; } //!< Default constructor for GameSnapshot, holds nothing.
+
+	void clear() { vBytes.clear(); readPos = 0; } //!< Empties the buffer, keeping its memory.
+	void rewind() { readPos = 0; } //!< Starts reading from the beginning again.
+	size_t size() const { return vBytes.size(); } //!< Size of the saved state in bytes.
+	const unsigned char *data() const { return vBytes.data(); } //!< The saved state.
+
+	//! Replaces the buffer with saved bytes, such as a snapshot read from disk.
+	/*!
+	* \param pData The bytes.
+	* \param uiSize Number of bytes.
+	*/
+	void assign(const void *pData, size_t uiSize);
+
+	//! Appends raw bytes.
+	/*!
+	* \param pData The bytes.
+	* \param uiSize Number of bytes.
+	*/
+	void writeBytes(const void *pData, size_t uiSize);
+
+	//! Reads raw bytes, returns false if the buffer runs out.
+	/*!
+	* \param pData Where to copy the bytes.
+	* \param uiSize Number of bytes.
+	*/
+	bool readBytes(void *pData, size_t uiSize);
+
+	//! Appends a value, which must be plain data.
+	/*!
+	* \param value The value.
+	*/
+	template <class T> void write(const T &value)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Only plain data can go in a snapshot");
+		writeBytes(&value, sizeof(T));
+	}
+
+	//! Reads a value written by write, returns false if the buffer runs out.
+	/*!
+	* \param value Set to the value.
+	*/
+	template <class T> bool read(T &value)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Only plain data can go in a snapshot");
+		return readBytes(&value, sizeof(T));
+	}
+};
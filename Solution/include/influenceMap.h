@@ -0,0 +1,103 @@
+/*! \file influenceMap.h
+* \brief Header file for the influence map used to choose goals (The InfluenceMap class).
+*
+* Contains layers of influence over the same nodes as the AI tank's map, spread and faded each timestep, and the best cells to hide in and attack from.
+*/
+
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+
+#include "gameSnapshot.h"
+#include "map.h"
+
+/*! \class InfluenceMap
+* \brief How dangerous, how worth attacking and how close to home each node is.
+*
+* Each timestep the tank stamps what it knows into the layers, then update fades the old influence, spreads it to the neighbouring nodes with a separable 1 2 1 blur and adds the new stamps.
+* Things that stay put, like bases, are sources instead, stamped again every timestep until set otherwise, so the tank only touches the nodes that changed.
+* Rows are padded to a multiple of four floats with a border node all round, so both passes of the blur run four nodes at a time with SSE2 and no edge cases.
+* Layers with no influence left are skipped, and the best safe and attack cells are scored at most once per update and only when asked for, so goals cost nothing on timesteps that don't choose one.
+*/
+class InfluenceMap
+{
+public:
+	//! The layers of influence.
+	enum Layer
+	{
+		THREAT, //!< Enemy tanks and shells.
+		TARGET, //!< Enemy bases.
+		HOME, //!< Own bases.
+		LAYERS //!< Number of layers.
+	};
+private:
+	static const int s_kiWidth = Map::s_kiWidth; //!< Number of columns of nodes.
+	static const int s_kiHeight = Map::s_kiHeight; //!< Number of rows of nodes.
+	static const int s_kiStride = (s_kiWidth + 2 + 3) / 4 * 4; //!< Floats per row, the nodes are columns 1 to s_kiWidth and the rest, at least one either side, is border.
+	static const int s_kiRows = s_kiHeight + 2; //!< Rows including the border row above and below.
+
+	float fInfluence[LAYERS][s_kiRows][s_kiStride]; //!< Influence of each layer at each node.
+	float fStamps[LAYERS][s_kiRows][s_kiStride]; //!< Influence added this timestep, set back to the sources by update.
+	float fSources[LAYERS][s_kiRows][s_kiStride]; //!< Influence added every timestep.
+	int iSources[LAYERS]; //!< Number of nodes with a source in each layer, a layer with any is never skipped.
+	float fBlurred[s_kiRows][s_kiStride]; //!< Scratch rows for the horizontal pass.
+
+	bool bActive[LAYERS]; //!< Does each layer have any influence or stamps? Faded out layers are skipped.
+
+	mutable bool bScored; //!< Have the best cells been scored since the last update?
+	mutable sf::Vector2i scoredFrom; //!< Node the best cells were scored from.
+	mutable sf::Vector2i bestSafe; //!< Traversable node with the best safety score.
+	mutable sf::Vector2i bestAttack; //!< Traversable node with the best attack score.
+	mutable bool bHasSafe; //!< Does the map hold any threat or home influence?
+	mutable bool bHasAttack; //!< Does the map hold any target influence?
+
+	static const float s_kfDecay[LAYERS]; //!< How much of each layer is left after a timestep, enemies move so threat fades fastest.
+
+	void blur(int iLayer); //!< Fades and spreads one layer, then adds its stamps.
+	void score(const Map &map, sf::Vector2i from) const; //!< Finds the best cells, unless already found from the same node since the last update.
+public:
+	InfluenceMap(); //!< Default constructor for InfluenceMap, with no influence anywhere.
+
+	void clear(); //!< Forgets all influence.
+
+	//! Adds influence to a node this timestep.
+	/*!
+	* \param layer Layer to add to.
+	* \param i Column of the node.
+	* \param j Row of the node.
+	* \param fAmount Influence to add.
+	*/
+	void stamp(Layer layer, int i, int j, float fAmount);
+
+	//! Sets the influence a node adds every timestep, from now until set again. Sources for a timestep must be set before it is stamped.
+	/*!
+	* \param layer Layer to add to.
+	* \param i Column of the node.
+	* \param j Row of the node.
+	* \param fAmount Influence to add each timestep, 0 for none.
+	*/
+	void setSource(Layer layer, int i, int j, float fAmount);
+
+	void update(); //!< Fades, spreads and stamps every layer.
+
+	float getInfluence(Layer layer, int i, int j) const { return fInfluence[layer][j + 1][i + 1]; } //!< Influence of a layer at a node.
+
+	//! Gives the node furthest from threat and closest to home, returns false if nothing dangerous or homely is known.
+	/*!
+	* \param map The tank's map, nodes it can't drive through are never chosen.
+	* \param from Node of the tank, further nodes score a little lower.
+	* \param cell Set to the node.
+	*/
+	bool bestSafeCell(const Map &map, sf::Vector2i from, sf::Vector2i &cell) const;
+
+	//! Gives the node next to the most targets and the least threat, returns false if no target is known.
+	/*!
+	* \param map The tank's map, nodes it can't drive through are never chosen.
+	* \param from Node of the tank, further nodes score a little lower.
+	* \param cell Set to the node.
+	*/
+	bool bestAttackCell(const Map &map, sf::Vector2i from, sf::Vector2i &cell) const;
+
+	void saveState(GameSnapshot &snapshot) const; //!< Writes the layers into a snapshot, but not the sources, which are set again after loading.
+	bool loadState(GameSnapshot &snapshot); //!< Reads the layers back from a snapshot with no sources, returns false if it runs out.
+};
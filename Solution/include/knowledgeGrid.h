@@ -0,0 +1,53 @@
+/*! \file knowledgeGrid.h
+* \brief Header file for the grid of what a team has seen (The KnowledgeGrid class).
+*
+* Contains what each of a team's AI tanks saw this timestep, marked once into one grid with the same nodes as their maps, for each of them to merge into their own map.
+*/
+
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+
+#include "map.h"
+
+/*! \class KnowledgeGrid
+* \brief Sightings shared by a team.
+*
+* The game clears it each timestep, every AI tank in the team marks what it sees into it, then each tank merges it into its own map with Map::merge.
+* A node takes the first object marked over it, exactly as Map::mark does, so a team of one tank ends up with the same map as marking its own.
+*/
+class KnowledgeGrid
+{
+private:
+	static const int s_kiWidth = Map::s_kiWidth; //!< Number of columns of nodes.
+	static const int s_kiHeight = Map::s_kiHeight; //!< Number of rows of nodes.
+
+	Object contains[s_kiWidth][s_kiHeight]; //!< What was seen in each node this timestep.
+
+	// Node borders are the same for every node in a column or row, so an object is tested against each column and each row instead of every node
+	float fColumnMin[s_kiWidth]; //!< Left edge of each column of node borders.
+	float fColumnMax[s_kiWidth]; //!< Right edge of each column of node borders.
+	float fRowMin[s_kiHeight]; //!< Top edge of each row of node borders.
+	float fRowMax[s_kiHeight]; //!< Bottom edge of each row of node borders.
+public:
+	KnowledgeGrid(); //!< Default constructor for KnowledgeGrid, setLayout must be called before marking.
+
+	//! Takes the node borders from a map, which must have the same area as every map the grid is merged into.
+	/*!
+	* \param map Map to copy the layout of.
+	*/
+	void setLayout(const Map &map);
+
+	void clear(); //!< Forgets everything marked.
+
+	//! Marks an object over every node its bounds overlap, nodes already marked keep their first object.
+	/*!
+	* \param objectBounds Bounds of the object seen.
+	* \param type What was seen.
+	*/
+	void mark(sf::FloatRect objectBounds, Object type);
+
+	Object getNodeObject(int i, int j) const { return contains[i][j]; } //!< What was seen in a node, UNKNOWN if nothing.
+	int getWidth() const { return s_kiWidth; } //!< Return the width of the grid.
+	int getHeight() const { return s_kiHeight; } //!< Return the height of the grid.
+};
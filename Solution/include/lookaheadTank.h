@@ -0,0 +1,74 @@
+/*! \file lookaheadTank.h
+* \brief Header file for the AI tank that plans by rolling the game forward (The LookaheadTank class).
+*
+* Contains the macro actions a plan is made of, the settings of the Monte Carlo planner, and the tank that follows the plan.
+*/
+
+#pragma once
+
+#include "newTank.h"
+
+/*! \struct LookaheadSettings
+* \brief How far ahead and how hard a game's lookahead tanks plan.
+*/
+struct LookaheadSettings
+{
+	int iHorizon; //!< Game ticks each rollout plays ahead.
+	int iActionTicks; //!< Game ticks each action in a plan is held, the tank plans again once its first action is done.
+	int iDepth; //!< Actions in a rollout's plan, the first is tried in turn and the rest drawn at random, after them the tank's own state machine drives.
+	int iRolloutScale; //!< Game ticks advanced by each timestep of a rollout, more is cheaper and coarser.
+	int iBudget; //!< Microseconds each decision may spend on rollouts, 0 for no limit so only iMaxRollouts bounds it. Actions are tried in turn, so a tight budget leaves the later ones out. Any limit makes games depend on the machine's speed, so they won't replay.
+	int iMaxRollouts; //!< Most rollouts in a decision.
+	LookaheadSettings() : iHorizon(240), iActionTicks(40), iDepth(3), iRolloutScale(4), iBudget(0), iMaxRollouts(28) {}
+};
+
+/*! \class LookaheadTank
+* \brief An AI tank that picks its next move by trying each one in copies of the game.
+*
+* It still sees, aims its turret and decides when to shoot with NewTank's state machine, then the plan's current action takes over the tracks, or holds fire.
+* The game plans for it: when its first action runs out the game clones itself, plays each candidate action a few hundred ticks ahead and keeps the one whose rollouts gained the team the most points.
+* In those rollouts the copies follow the plan given and then their own state machine, and never plan themselves.
+*/
+class LookaheadTank : public NewTank
+{
+public:
+	//! What a plan can do for the length of one action.
+	enum Action
+	{
+		POLICY, //!< Whatever the state machine decides.
+		FORWARD, //!< Drives straight ahead.
+		BACKWARD, //!< Reverses straight back.
+		TURN_LEFT, //!< Turns left on the spot.
+		TURN_RIGHT, //!< Turns right on the spot.
+		STOP, //!< Stays where it is.
+		HOLD_FIRE, //!< Moves as the state machine decides, but doesn't shoot.
+		ACTIONS //!< Number of actions.
+	};
+	static const int s_kiMaxDepth = 8; //!< Most actions in a plan.
+private:
+	unsigned char ucPlan[s_kiMaxDepth]; //!< Actions of the plan, each held for iActionTicks.
+	int iPlanLength; //!< Actions in the plan, after them the state machine drives. 0 when the tank needs a plan.
+	int iActionTicks; //!< Game ticks each action is held.
+	int iPlanTicks; //!< Game ticks since the plan was made.
+public:
+	LookaheadTank(); //!< Default constructor for LookaheadTank, with no plan.
+
+	//! Replaces the plan.
+	/*!
+	* \param pucActions The actions, in order.
+	* \param iLength Number of actions, no more than s_kiMaxDepth.
+	* \param iNewActionTicks Game ticks each action is held.
+	*/
+	void setPlan(const unsigned char *pucActions, int iLength, int iNewActionTicks);
+
+	bool needsPlan() const { return iPlanLength == 0 || iPlanTicks >= iActionTicks; } //!< Has the first action run out, or been lost when the tank was shot?
+	int currentAction() const; //!< Action the plan has the tank doing now.
+	void advance(int iTicks) { iPlanTicks += iTicks; } //!< Moves through the plan by the game ticks of a timestep.
+
+	void move(); //!< Runs the state machine, then lets the plan's action take over the tracks.
+	bool isFiring(); //!< Fires when the state machine would, unless the plan is holding fire.
+	void reset(); //!< Resets the tank and forgets the plan, it plans again from where it respawns.
+
+	void saveState(GameSnapshot &snapshot) const; //!< Writes the tank and its plan into a snapshot.
+	bool loadState(GameSnapshot &snapshot); //!< Reads the tank and its plan back from a snapshot, returns false if it runs out.
+};
@@ -7,31 +7,31 @@
 #pragma once
 
 #include <iostream>
-#include <SFML/Graphics.hpp>
-#include <vector>
+#include <SFML/Graphics/Rect.hpp>
+#include <bitset>
 #include <list>
 #include <stack>
 
 
 #include "mapNode.h"
 #include "position.h"
+#include "gameSnapshot.h"
+
+class KnowledgeGrid;
 
 /*! \class Map
 * \brief Map for the AI tank.
 *
 * Used for pathfinding for the AI tank.
 */
-class Map : public sf::Drawable
+class Map
 {
-private:
+public:
 	static const int s_kiWidth = 19; //!< Number of columns of nodes.
 	static const int s_kiHeight = 13; //!< Number of rows of nodes.
 	static const int s_kiNodes = s_kiWidth * s_kiHeight; //!< Number of nodes.
-
-	const float kiBackgroundWidth = 780.f; //!< Width of background.
-	const float kiBackgroundHeight = 560.f; //!< Height of background.
-
-	std::vector<std::vector<bool>> vbAdjacencyMatrix; //!< For if a node is next to another.
+private:
+	std::bitset<s_kiNodes> bsAdjacencyMatrix[s_kiNodes]; //!< For if a node is next to another, one row of bits per node so it copies as a flat block.
 	int iIndexes[s_kiWidth][s_kiHeight]; //!< The number for each node using x and y values.
 
 	//int iTankNotVisibleFrameCount = 0; 
@@ -39,20 +39,40 @@ private:
 
 	MapNode node[s_kiWidth][s_kiHeight]; //!< 2d array of nodes for the map.
 	std::list<int> currentPath; //!< Current path being followed.
+
+	std::bitset<s_kiNodes> bsChanged; //!< For if a node's object has changed since the changes were last cleared.
+	int iChanged[s_kiNodes]; //!< Numbers of the changed nodes, in the order they first changed.
+	int iNumChanged; //!< Number of changed nodes.
+
+	void setObject(int i, int j, Object type); //!< To change the object in a node, noting the node if it's different.
 public:
-	Map(); //!< Default constructor for Map.
+	Map(); //!< Default constructor for Map, covering the standard 780 by 560 arena.
+
+	//! Lays the nodes out over an arena of a different size, forgetting everything seen. The number of nodes stays the same, so they grow with the arena.
+	/*!
+	* \param fWidth Width of the arena inside its walls.
+	* \param fHeight Height of the arena inside its walls.
+	*/
+	void setArea(float fWidth, float fHeight);
 
 	void mark(sf::FloatRect objectBounds, Object type); //!< To mark a found object on the map.
+	void merge(const KnowledgeGrid &grid); //!< To mark everything the team saw on the map, giving the same nodes as marking each object in turn.
 	void update(int i, int j, bool canSee, Position pos, sf::Vector2i goal); //!< To clear nodes.
 	void makeNewPath(float x, float y, sf::Vector2i &goalNode); //!< Make a new path to follow.
-	sf::Vector2f followPath(Position pos); //!< Called when following the path.
-	sf::FloatRect getNodeBox(int i, int j); //!< To get the floatrect of the box.
-	Object getNodeObject(int i, int j); //!< To get the object in the node.
+	sf::Vector2f followPath(Position pos, float fReach = 1.75f); //!< Called when following the path, a node is reached within fReach of its centre.
+	sf::FloatRect getNodeBox(int i, int j) const; //!< To get the floatrect of the box.
+	Object getNodeObject(int i, int j) const; //!< To get the object in the node.
+	const MapNode &getNode(int i, int j) const { return node[i][j]; } //!< To get a node, for drawing in debug mode.
+
+	int numChanged() const { return iNumChanged; } //!< Number of nodes whose object has changed since clearChanged.
+	sf::Vector2i getChanged(int n) const { return sf::Vector2i(iChanged[n] % s_kiWidth, iChanged[n] / s_kiWidth); } //!< The nth changed node.
+	void clearChanged(); //!< Forgets which nodes have changed.
+	void markAllChanged(); //!< Counts every node as changed, for when whatever was built from the nodes has to start over.
 
-	int getWidth() { return s_kiWidth; } //!< Return the width of the map.
-	int getHeight() { return s_kiHeight; } //!< Return the height of the map.
+	int getWidth() const { return s_kiWidth; } //!< Return the width of the map.
+	int getHeight() const { return s_kiHeight; } //!< Return the height of the map.
 
-	bool traversable(Object type); //!< Check if the node is traversable, returns true if it is.
+	static bool traversable(Object type); //!< Check if the node is traversable, returns true if it is.
 	int index(int x, int y); //!< To return the number of the node.
 	void inverseIndex(int index, int& x, int& y); //!< Get the x and y values of the node based on the index.
 	void setMapTraversable(); //!< Call setAreaTraversable for whole map.
@@ -62,10 +82,7 @@ public:
 	std::list<int> bfsSearch(int currentX, int currentY, int goalX, int goalY); //!< Generate a path using the BFS method.
 	std::list<int> buildPath(std::list<MapNode>& searched); //!< Rebuilds the path from a list of nodes after searching.
 
-	//! Draws map.
-	/*!
-	* \param target The target being rendered to.
-	* \states Render states.
-	*/
-	void draw(sf::RenderTarget &target, sf::RenderStates states) const;
+	void saveState(GameSnapshot &snapshot) const; //!< Writes the nodes, adjacency and current path into a snapshot.
+	bool loadState(GameSnapshot &snapshot); //!< Reads the nodes, adjacency and current path back from a snapshot, returns false if it runs out.
+
 };
\ No newline at end of file
@@ -7,7 +7,8 @@
 #pragma once
 
 #include <iostream>
-#include <SFML/Graphics.hpp>
+#include <cmath>
+#include <SFML/Graphics/Rect.hpp>
 // What is contained in the section
 enum Object { UNKNOWN, OWNBASE, PLAYERBASE, PLAYERTANK, PLAYERSHELL };
 
@@ -16,11 +17,9 @@ enum Object { UNKNOWN, OWNBASE, PLAYERBASE, PLAYERTANK, PLAYERSHELL };
 *
 * Used for pathfinding for the AI tank.
 */
-class MapNode : public sf::Drawable
+class MapNode
 {
 private:
-	sf::RectangleShape debugRect; //!< To show in debug mode
-
 	Object contains; //!< What is in the section of the map
 	sf::FloatRect border; //!< The border for the node
 
@@ -30,7 +29,7 @@ private:
 
 	bool bPath; //!< If it is part of a path
 public:
-	MapNode() {} //!< Default constructor for MapNode.
+	MapNode() { contains = UNKNOWN; fTotalCost = fHeuristicScore = fGeogScore = 0.f; iIndex = iParentIndex = -1; bPath = false; bSeen = false; } //!< Default constructor for MapNode.
 	MapNode(sf::Vector2f newPosition, sf::Vector2f newSize, Object type); //!< Constructor for MapNode.
 
 	bool bSeen; //!< If it can currently be seen
@@ -46,13 +45,5 @@ public:
 	void score(float parentG, int x, int y, int goalX, int goalY); //!< Function to score a node when A* searching
 	bool operator<(const MapNode& other); //!< Operator for sorting the nodes in a list
 	void setIfPath(bool is); //!< Set if it is a path
-	bool isPath() { return bPath; } //!< Return if it is a path
-	void resetColour(); //!< Reset the colour of the node
-
-	//! Draws map nodes.
-	/*!
-	* \param target The target being rendered to.
-	* \states Render states.
-	*/
-	void draw(sf::RenderTarget &target, sf::RenderStates states) const;
+	bool isPath() const { return bPath; } //!< Return if it is a path
 };
\ No newline at end of file
@@ -0,0 +1,70 @@
+/*! \file matchRunner.h
+* \brief Header file for running batches of games in parallel (The MatchRunner class).
+*
+* Contains the result recorded for each game, and the runner that plays them across a work stealing thread pool.
+*/
+
+#pragma once
+
+#include <cstdio>
+#include <vector>
+
+// Which side won a match
+enum Winner { WINNER_RED, WINNER_BLUE, WINNER_DRAW };
+
+/*! \struct MatchResult
+* \brief One row of the results table.
+*/
+struct MatchResult
+{
+	int iMatch; //!< Index of the match in the batch.
+	unsigned long long ullSeed; //!< Seed the match was played with, playing it again gives the same result.
+	long lTicks; //!< Game ticks played.
+	int iRedScore; //!< Final score of the AI tank.
+	int iBlueScore; //!< Final score of the player tank.
+	Winner winner; //!< Side with the higher score.
+	bool bFinished; //!< False if the match hit the tick limit before the game was over.
+};
+
+/*! \class MatchRunner
+* \brief Plays a batch of independent games on a thread pool.
+*
+* Every match builds and owns its own Game and random number generator, so nothing is shared between threads, and writes its result into its own row of the table.
+* Match i is seeded with the base seed plus i, so the table comes out the same whatever the thread count.
+*/
+class MatchRunner
+{
+private:
+	long lMaxTicks; //!< Matches still running after this many ticks are stopped.
+	int iTickScale; //!< Game ticks advanced by each call to Game::play.
+	int iThreads; //!< Worker threads, 0 for one per hardware thread.
+	unsigned long long ullBaseSeed; //!< Seed of match 0, each later match adds its index.
+public:
+	//! Constructor for MatchRunner.
+	/*!
+	* \param lNewMaxTicks Matches still running after this many ticks are stopped.
+	* \param iNewTickScale Game ticks advanced by each call to Game::play.
+	* \param iNewThreads Worker threads, 0 for one per hardware thread.
+	* \param ullNewBaseSeed Seed of match 0, each later match adds its index.
+	*/
+	MatchRunner(long lNewMaxTicks = 100000, int iNewTickScale = 1, int iNewThreads = 0, unsigned long long ullNewBaseSeed = 0);
+
+	//! Plays a single match on the calling thread.
+	/*!
+	* \param iMatch Index of the match in the batch.
+	*/
+	MatchResult playMatch(int iMatch) const;
+
+	//! Plays a batch of matches in parallel and returns the results in match order.
+	/*!
+	* \param iMatches Number of matches to play.
+	*/
+	std::vector<MatchResult> run(int iMatches) const;
+
+	//! Writes the results as a table, one row per match.
+	/*!
+	* \param results The results to write.
+	* \param file Where to write them.
+	*/
+	static void printTable(const std::vector<MatchResult> &results, FILE *file);
+};
@@ -8,11 +8,16 @@
 
 #include <iostream>
 #include <list>
-#include <stdlib.h> // Used for rand() function.
+#include <stdlib.h> // Used for system() function.
 
 #include "aitank.h"
+#include "influenceMap.h"
+#include "knowledgeGrid.h"
 #include "map.h"
 #include "playerTank.h"
+#include "shellThreats.h"
+#include "newTankParams.h"
+#include "targetSelector.h"
 
 /*! \class NewTank
 * \brief Creates a tank with AI.
@@ -23,11 +28,19 @@ class NewTank : public AITank
 {
 private:
 	Map map; //!< Stored map of the world.
+	KnowledgeGrid *knowledge; //!< Grid the team's sightings are marked into, null to mark straight onto the map.
 
-	static const int s_kiNumRectShellPath = 4; //!< Number of points in the shell's path.
+	//! Marks a sighting into the team's grid, or onto the map if the tank has no team grid.
+	/*!
+	* \param bounds Bounds of the object seen.
+	* \param type What was seen.
+	*/
+	void markMap(sf::FloatRect bounds, Object type);
 
-	sf::RectangleShape shellPath[s_kiNumRectShellPath]; //!< Used to know the path of the player shell.
-	sf::Vector2f prevShellPos; //!< Stored position for the shell last frame.
+	InfluenceMap influence; //!< Danger, targets and home spread over the map's nodes, used to choose where to hide, escape and search.
+	ShellThreats shellThreats; //!< Enemy shells seen since the tank last moved.
+	TargetSelector targets; //!< Enemy tanks and bases sensed since the tank last moved.
+	ShellThreat threat; //!< The shell that will pass closest soonest, worked out at the start of each move.
 	sf::Vector2f closestEnemyPos; //!< Position of the closest enemy object (With enemy tank being a priority).
 	sf::Vector2f closestEnemyPosDiff; //!< Difference between position of tank and closest enemy object (With enemy tank being a priority).
 	sf::Vector2f noEnemySeenPos = sf::Vector2f(-100.f, -100.f); //!< Used to reset closestEnemyPos when an enemy is not seen, so the tank does not think a destroyed enemy object is still there.
@@ -55,24 +68,18 @@ private:
 	int iMovementState; //!< Current state the AI tank is in.
 	int iWeaponState; //!< Current state the AI tank's turret is in.
 	int iPrevMovementState; //!< State the AI tank was in last frame.
+	int iPrevWeaponState; //!< State the AI tank's turret was in last frame.
+	// Frame counts are counted in game ticks, so the limits in NewTankParams last as long at any tick scale
 	int iFollowingFrameCount = 0; //!< To prevent rapid change between FOLLOWING and STOPPING states.
 	int iStuckFrames = 0; //!< Amount of frames AI tank has been stuck.
 	int iLeftFrames = 0; //!< Amount of frames tank has been turning left.
 	int iRightFrames = 0; //!< Amount of frames tank has been turning right.
 	int iLostPlayerTankFrames = 0; //!< Amount of frames AI tank has not seen the player tank.
 
-	const int kiFollowingMinFrameCount = 20; //!< To prevent rapid change between FOLLOWING and STOPPING states (Limit).
-	const int kiStuckMinFrameCount = 100; //!< How many frames minimum the tank should be stuck before transitioning into the STUCK state.
-	const int kiTurningMinFrameCount = 20; //!< How many frames minimum the tank should be turning before turret searches in a different direction.
-	const int kiLostPlayerMinFrameCount = 20; //!< How many frames minimum the player tank should not be visible before transitioning to the FOLLOWING state.
-
-	const float kfShellPathExtent = 75.f; //!< The width/height of the square bounding box for each part of the shell path.
-	const float kfShellPathDist = 25.f; //!< How far each bounding box of the shell path should be from each other.
-	const float kfViewDistance = 250.f; //!< How far the tank should be from an enemy object before shooting, view distance of turret.
-	const float kfTurretAccuracyLimit = 1.25f; //!< How close the turret should be (in degrees) before shooting at the target.
-	const float kfBodyAccuracyLimit = 2.f; //!< How close the tank's body should be (in degrees) before no longer rotating.
-	const float kfBaseExtent = 20.f; //!< The width/height of a base.
-	const float kfTankExtent = 40.f; //!< The width/height of a tank.
+	NewTankParams params; //!< Tuning constants.
+	static const int s_kiShellThreatPoints = 3; //!< Points along each seen shell's path stamped as threat.
+	static const float kfBaseExtent; //!< The width/height of a base.
+	static const float kfTankExtent; //!< The width/height of a tank.
 	
 
 	int iResetFrames; //!< Amount of frames since reset.
@@ -86,7 +93,7 @@ private:
 
 	DODGING: Used to dodge out of the way of enemy shells.
 		Entry: An enemy shell has entered the AI tank's view AND is predicted to hit the AI tank.
-		Process: ?
+		Process: Moves forwards or backwards, whichever takes it further from where the shell will pass.
 		Exit: Higher priority state meets conditions, or entry conditions are no longer met.
 
 	ESCAPING: Used to run away from the player if out of ammo.
@@ -143,32 +150,102 @@ private:
 		2 - SEARCHINGAIM
 	*/
 
+	/*****************************************************************************************************************************************************************/
+
+	/* Both state machines are tables in newTank.cpp (NewTankStates). The movement transitions are a list of guards in priority order, the first guard that passes picks the state.
+	Each movement state then has a row of the turret state it uses and its entry and update actions, and each turret state has a row with its action. */
+
+	friend struct NewTankStates; //!< Holds the state machine tables, which point at the guards and actions below.
+
+	static const int s_kiNumMovementStates = STUCK + 1; //!< Number of AIMovementStates.
+	static const int s_kiNumWeaponStates = AIMING + 1; //!< Number of AIWeaponStates.
+
+	unsigned int uiStateEntries[s_kiNumMovementStates]; //!< Times each movement state has been entered.
+	unsigned int uiStateTimesteps[s_kiNumMovementStates]; //!< Timesteps spent in each movement state.
+	unsigned int uiWeaponStateEntries[s_kiNumWeaponStates]; //!< Times each turret state has been entered.
+	unsigned int uiWeaponStateTimesteps[s_kiNumWeaponStates]; //!< Timesteps spent in each turret state.
+
+	// Guards of the movement transitions, see setStateMachineConditions
+	bool shellThreatened() const { return threat.iShell >= 0; } //!< Will a seen shell pass close to the AI tank soon?
+	bool shouldEscape() const; //!< Can it see an enemy tank with no ammo, or is it still escaping?
+	bool shouldHide() const; //!< Is it out of ammo and not escaping, or has it finished escaping?
+	bool shouldStop() const; //!< Can it see an enemy, and has it been following long enough to stop again?
+	bool lostTarget() const; //!< Has the enemy it was stopped for or following left its view before it reached it?
+	bool lostTargetForLong() const; //!< Has the enemy been out of view long enough to follow it?
+	bool always() const { return true; } //!< Guard of the default state.
+
+	// Actions of the movement states, entry actions also run when reaching the goal in states that pick a new goal there
+	void dodgeUpdate(); //!< Moves away from where the shell will pass.
+	void escapeEntry(); //!< Heads for the safest node, or the next corner round from the one it is in if nothing is known.
+	void hideEntry(); //!< Heads for the safest node, or the corner it is in if nothing is known.
+	void hideUpdate(); //!< Stops once hidden.
+	void stopEntry(); //!< Heads for the target's node, for FOLLOWING to use.
+	void stopUpdate(); //!< Turns side on to an enemy tank and keeps the goal on the target.
+	void followUpdate(); //!< Counts frames spent following.
+	void searchEntry(); //!< Heads for the best node to attack from, or a random node if no target is known.
+
+	// Actions of the turret states
+	void aimUpdate(); //!< Aims at the target and fires once aimed.
+	void searchAimUpdate(); //!< Spins the turret the way the tank is turning.
+
+	int mapQuadrant() const; //!< The quarter of the map the AI tank is in, 0 to 3 clockwise from the top left, or -1 on the dividing lines.
+
+	//! Returns the node one in from a corner of the map.
+	/*!
+	* \param iCorner Corner, 0 to 3 clockwise from the top left.
+	*/
+	sf::Vector2i mapCorner(int iCorner) const;
+
 public:
 	NewTank(); //!< Default constructor for NewTank.
 	void setTargetInfo(); //!< Sets information about the target (Vector distance to target, scalar distance to target, angle difference between AI tank and target and AI tank's current node).
+	void selectTarget(); //!< Scores every target sensed and makes the best the closest enemy object.
 	void checkVision(); //!< Checks if the AI tank can see any enemy objects.
+	void updateInfluence(); //!< Stamps the enemies, shells and bases the AI tank knows of into its influence map and updates it.
 	void setStateMachineConditions(); //!< Sets states of AI tank depending on what conditions are met.
 	void moveStateMachineActions(); //!< AI tank performs actions depending on its state.
 	void turretStateMachineActions(); //!< Turret performs actions depending on its state.
 	void aimTurret(); //!< Rotates turret to point at target.
 	void move(); //!< Tank moves along calculated path.
+	void coast(); //!< Keeps the controls of the last move for a timestep the tank doesn't think in, forgetting what it sensed.
 	void checkStuck(); //!< Checks if the tank is stuck and not moving when it should be. If so, a new goal node is calculated next frame.
 	void reset(); //!< Resets tank, making sure it doesn't spawn inside a non-traversable object.
 	void collided(); //!< Tank has collided with a bounding box.
 	bool isFiring(); //!< Checks if tank should be firing.
 
+	static int numMovementStates() { return s_kiNumMovementStates; } //!< Number of movement states, for reading the counters.
+	static int numWeaponStates() { return s_kiNumWeaponStates; } //!< Number of turret states, for reading the counters.
+	static const char *movementStateName(int iState); //!< Name of a movement state.
+	static const char *weaponStateName(int iState); //!< Name of a turret state.
+	unsigned int getStateEntries(int iState) const { return uiStateEntries[iState]; } //!< Times a movement state has been entered.
+	unsigned int getStateTimesteps(int iState) const { return uiStateTimesteps[iState]; } //!< Timesteps spent in a movement state.
+	unsigned int getWeaponStateEntries(int iState) const { return uiWeaponStateEntries[iState]; } //!< Times a turret state has been entered.
+	unsigned int getWeaponStateTimesteps(int iState) const { return uiWeaponStateTimesteps[iState]; } //!< Timesteps spent in a turret state.
+
 	//! Marks enemy bases on the map that are in the AI tank's vision.
 	/*!
 	* \param p Position of the base.
 	*/
 	void markTarget(Position p); 
 
+	//! Takes note of an enemy base a teammate has already marked this timestep, in case it is the closest target.
+	/*!
+	* \param p Position of the base.
+	*/
+	void spotTarget(Position p);
+
 	//! Marks enemy tanks on the map that are in the AI tank's vision.
 	/*!
 	* \param p Position of the enemy tank.
 	*/
 	void markEnemy(Position p);
 
+	//! Takes note of an enemy tank a teammate has already marked this timestep, in case it is the closest target.
+	/*!
+	* \param p Position of the enemy tank.
+	*/
+	void spotEnemy(Position p);
+
 	//! Marks friendly bases on the map that are in the AI tank's vision.
 	/*!
 	* \param p Position of the base.
@@ -188,19 +265,48 @@ public:
 	*/
 	void score(int thisScore, int enemyScore);
 
+	const Map &getMap() const { return map; } //!< Returns the AI tank's map, for drawing in debug mode.
+
+	//! Shares sightings with a team, from now on marks go into the grid and reach the map through mergeKnowledge (Set by the game).
+	/*!
+	* \param grid The team's grid, null to mark straight onto the map again.
+	*/
+	void setKnowledge(KnowledgeGrid *grid) { knowledge = grid; }
+
+	void mergeKnowledge(); //!< Marks everything the team saw this timestep onto the map, once every tank in the team has marked what it sees.
+
+	//! Sets the tuning constants, the influence sources are set again from the whole map with them.
+	/*!
+	* \param newParams The constants.
+	*/
+	void setParams(const NewTankParams &newParams) { params = newParams; map.markAllChanged(); }
+	const NewTankParams &getParams() const { return params; } //!< Returns the tuning constants.
+
+	//! Sets the size of the arena the map covers.
+	/*!
+	* \param fWidth Width of the arena inside its walls.
+	* \param fHeight Height of the arena inside its walls.
+	*/
+	void setArena(float fWidth, float fHeight) { map.setArea(fWidth, fHeight); }
+
+	//! Writes the tank's state, state machine and map into a snapshot.
+	/*!
+	* \param snapshot The snapshot to write to.
+	*/
+	void saveState(GameSnapshot &snapshot) const;
+
+	//! Reads the tank's state, state machine and map back from a snapshot, returns false if it runs out.
+	/*!
+	* \param snapshot The snapshot to read from.
+	*/
+	bool loadState(GameSnapshot &snapshot);
+
 	//! Calculates an angle between the AI tank and the target using the difference in their positions.
 	/*!
 	* \param posDiff The vector distance between the AI tank and the target.
 	*/
 	float calcAngle(sf::Vector2f posDiff);
 
-	//! Compares the position of the current object being checked, with the current object that is closest to the AI tank to see which is closer (Makes enemy tank a priority even if a base is closer).
-	/*!
-	* \param tankPos The vector position of the tank.
-	* \param checkPos The vector position of the object being checked.
-	* \param type The object being checked's type.
-	*/
-	void comparePositions(sf::Vector2f tankPos, sf::Vector2f checkPos, Object type);
 
 	//! Returns the node position of a position in the world.
 	/*!
@@ -208,11 +314,4 @@ public:
 	* \param fWorldY The Y position in the world.
 	*/
 	sf::Vector2i calcNodePos(float fWorldX, float fWorldY);
-
-	//! Overrider for the tank draw function.
-	/*!
-	* \param target The target being rendered to.
-	* \states Render states.
-	*/
-	void draw(sf::RenderTarget &target, sf::RenderStates states) const; 
 };
\ No newline at end of file
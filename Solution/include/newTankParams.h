@@ -0,0 +1,51 @@
+/*! \file newTankParams.h
+* \brief Header file for the tuning constants of the AI tank (The NewTankParams struct).
+*
+* Contains every constant that changes how the AI tank plays, with the tuned defaults, and a table of them by name so they can be set from the command line and swept.
+*/
+
+#pragma once
+
+#include "targetSelector.h"
+
+/*! \struct NewTankParams
+* \brief How the AI tank plays.
+*
+* Each AI tank holds its own copy, so teams in the same game can play with different values.
+*/
+struct NewTankParams
+{
+	int iFollowingMinFrameCount; //!< To prevent rapid change between FOLLOWING and STOPPING states (Limit).
+	int iStuckMinFrameCount; //!< How many frames minimum the tank should be stuck before transitioning into the STUCK state.
+	int iTurningMinFrameCount; //!< How many frames minimum the tank should be turning before turret searches in a different direction.
+	int iLostPlayerMinFrameCount; //!< How many frames minimum the player tank should not be visible before transitioning to the FOLLOWING state.
+
+	float fThreatRadius; //!< Shells passing closer than this to the tank's centre are dodged (Half a tank and half a shell, with some room).
+	float fThreatHorizon; //!< How many game ticks ahead shells are dodged.
+	float fTankThreat; //!< Threat stamped each timestep at an enemy tank's last known node.
+	float fShellThreat; //!< Threat stamped each timestep at each point on a seen shell's path.
+	float fBaseTarget; //!< Target value stamped each timestep at an enemy base's node.
+	float fBaseHome; //!< Home value stamped each timestep at an own base's node, there are several so each counts for less.
+	float fEnemyTargetThreat; //!< Threat of an enemy tank as a target, bases pose none.
+	float fEnemyTargetValue; //!< Value of destroying an enemy tank.
+	float fBaseTargetValue; //!< Value of destroying an enemy base.
+	float fViewDistance; //!< How far the tank should be from an enemy object before shooting, view distance of turret.
+	float fTurretAccuracyLimit; //!< How close the turret should be (in degrees) before shooting at the target.
+	float fBodyAccuracyLimit; //!< How close the tank's body should be (in degrees) before no longer rotating.
+
+	float fUtilityDistance; //!< Target utility lost per pixel to the target.
+	float fUtilityAim; //!< Target utility of the turret already pointing at the target.
+	float fUtilityThreat; //!< Target utility per unit of threat, enemy tanks come first.
+	float fUtilityValue; //!< Target utility per unit of value.
+
+	NewTankParams(); //!< The tuned defaults.
+
+	TargetUtility targetUtility() const; //!< The target utility weights.
+
+	static int count(); //!< Number of parameters that can be set by name.
+	static const char *name(int i); //!< Name of parameter i, the member's name without its type prefix.
+	static bool isInteger(int i); //!< Is parameter i a whole number of frames? Values set are rounded.
+	static int find(const char *sName); //!< Index of the parameter with a name, -1 if there is none.
+	double get(int i) const; //!< Value of parameter i.
+	void set(int i, double dValue); //!< Sets parameter i, rounding whole number parameters.
+};
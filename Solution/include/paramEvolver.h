@@ -0,0 +1,129 @@
+/*! \file paramEvolver.h
+* \brief Header file for evolving the AI tank's parameters by self-play (The ParamEvolver class).
+*
+* Contains the genetic algorithm that breeds NewTankParams, scores each generation's population in parallel on a work stealing thread pool, and checkpoints its state to disk.
+*/
+
+#pragma once
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "game.h"
+#include "newTankParams.h"
+#include "paramSweep.h"
+#include "random.h"
+#include "workStealingPool.h"
+
+/*! \struct EvolverSettings
+* \brief How a ParamEvolver breeds and scores its population.
+*/
+struct EvolverSettings
+{
+	int iPopulation; //!< Parameter sets in each generation.
+	int iElites; //!< Best sets copied unchanged into the next generation.
+	int iTournament; //!< Sets drawn for each tournament, the fittest of them becomes a parent.
+	double dCrossover; //!< Chance a child blends two parents rather than copying one.
+	double dMutation; //!< Standard deviation of a mutation, as a fraction of the parameter's range.
+	int iHallOfFame; //!< Generations' best sets kept as opponents.
+	int iMatchesPerOpponent; //!< Matches each set plays against each opponent, half on each side, rounded up to even.
+	long lMaxTicks; //!< Matches still running after this many ticks are stopped.
+	bool bDumbOpponent; //!< Play DumbTanks as well, a floor every set should clear.
+	EvolverSettings() : iPopulation(16), iElites(2), iTournament(3), dCrossover(0.9), dMutation(0.1), iHallOfFame(4), iMatchesPerOpponent(4), lMaxTicks(20000), bDumbOpponent(true) {}
+};
+
+/*! \class ParamEvolver
+* \brief Evolves the red team's AI tank parameters by playing them against the defaults and earlier generations' best.
+*
+* Each set in a generation plays the same seeds against the same opponents: the hand tuned defaults, DumbTanks, then the hall of fame of earlier generations' best sets, so later generations have to beat what came before as well as the baseline.
+* The arena favours a side, so each seed is played twice, with the set on red and then on the other teams. With more than two teams, the teams the DumbTanks don't take play the defaults.
+* A win scores 1, a draw a half, and the fitness is the average. The next generation keeps the elites, and breeds the rest by tournament selection, blend crossover and Gaussian mutation within the ranges.
+* Every worker thread keeps one Game and restarts it for each match, so a generation doesn't rebuild the arena, tanks and maps for every match.
+*/
+class ParamEvolver
+{
+private:
+	GameSetup setup; //!< Teams, tanks and arena of every match.
+	EvolverSettings settings; //!< How the population is bred and scored.
+	unsigned long long ullBaseSeed; //!< Seed of the first generation's matches and of the breeding.
+	std::vector<SweepRange> vRanges; //!< Parameters evolved, the rest keep their defaults.
+
+	Random rng; //!< Random numbers for breeding, saved in checkpoints so a resumed run breeds the same.
+	int iGeneration; //!< Generations scored so far.
+	std::vector<NewTankParams> vPopulation; //!< Parameter sets of the generation being scored.
+	std::vector<double> vdFitness; //!< Fitness of each set, once scored.
+	std::vector<NewTankParams> vHallOfFame; //!< Best set of each recent generation, oldest first.
+	NewTankParams lastBest; //!< Fittest set of the generation scored last, fitness from different generations can't be compared as the opponents change.
+	double dLastBest; //!< Its fitness.
+	double dLastMean; //!< Mean fitness of the generation scored last.
+
+	WorkStealingPool pool; //!< Threads matches are played on, kept between generations.
+	std::vector<std::unique_ptr<Game>> vGames; //!< Games of each worker, one for each place the DumbTanks can take, each built by its first match and restarted for the rest.
+	double dCoreSeconds; //!< Time spent playing matches in the last generation, added up over every thread.
+
+	//! Plays one match, red with a candidate against every other team's AI tanks with an opponent, and returns 1 for a red win, a half for a draw and 0 for a loss.
+	/*!
+	* \param game The game to restart for the match.
+	* \param candidate Parameters the red team plays with.
+	* \param opponent Parameters the other teams' AI tanks play with.
+	* \param ullSeed Seed of the match.
+	*/
+	double playMatch(Game &game, const NewTankParams &candidate, const NewTankParams &opponent, unsigned long long ullSeed) const;
+
+	//! Returns the calling worker's game, with the DumbTanks on a team or none, built the first time it is asked for.
+	/*!
+	* \param iDumbTeam Team of DumbTanks, -1 for none.
+	*/
+	Game &workerGame(int iDumbTeam);
+
+	double uniform(); //!< A random number between 0 and 1.
+	double gaussian(); //!< A random number from the standard normal distribution.
+	int tournament(); //!< Index of the fittest of a few sets drawn at random.
+	void clamp(NewTankParams &params) const; //!< Keeps each evolved parameter within its range.
+	void breed(); //!< Replaces the scored population with the next generation.
+public:
+	//! Constructor for ParamEvolver.
+	/*!
+	* \param newSetup Teams, tanks and arena of every match.
+	* \param newSettings How the population is bred and scored.
+	* \param ullNewBaseSeed Seed of the first generation's matches and of the breeding.
+	* \param iThreads Worker threads, 0 for one per hardware thread.
+	*/
+	ParamEvolver(const GameSetup &newSetup, const EvolverSettings &newSettings, unsigned long long ullNewBaseSeed, int iThreads = 0);
+
+	void addRange(const SweepRange &range) { vRanges.push_back(range); } //!< Evolves another parameter, add every range before start or load.
+	const std::vector<SweepRange> &getRanges() const { return vRanges; } //!< Parameters evolved.
+
+	void start(); //!< Fills the first generation with random sets spread over the ranges, the defaults clamped into them being the first.
+
+	//! Scores the current generation, adds its best to the hall of fame and breeds the next generation.
+	void step();
+
+	int getGeneration() const { return iGeneration; } //!< Generations scored so far.
+	const std::vector<NewTankParams> &getPopulation() const { return vPopulation; } //!< Parameter sets of the next generation to score.
+	const NewTankParams &getBest() const { return lastBest; } //!< Fittest set of the generation scored last.
+	double getBestFitness() const { return dLastBest; } //!< Its fitness.
+	double getMeanFitness() const { return dLastMean; } //!< Mean fitness of the generation scored last.
+	double getCoreSeconds() const { return dCoreSeconds; } //!< Time spent playing matches in the last generation, added up over every thread.
+	int matchesPerSet() const; //!< Matches each set plays in the next generation.
+
+	//! Writes the state of the run to a file, through a temporary file so a crash while writing leaves the last checkpoint whole, returns false if it can't be written.
+	/*!
+	* \param sFile The checkpoint file.
+	*/
+	bool save(const std::string &sFile) const;
+
+	//! Carries on a run from a checkpoint, returns false if the file is missing, damaged, or was saved with other ranges.
+	/*!
+	* \param sFile The checkpoint file.
+	*/
+	bool load(const std::string &sFile);
+
+	//! Writes a line about the generation scored last: its number, the best and mean fitness, and the best set's evolved parameters.
+	/*!
+	* \param file Where to write it.
+	*/
+	void printGeneration(FILE *file) const;
+};
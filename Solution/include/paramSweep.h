@@ -0,0 +1,114 @@
+/*! \file paramSweep.h
+* \brief Header file for tuning the AI tank by playing matches (The ParamSweep class).
+*
+* Contains the ranges a sweep covers, the result of each parameter set, and the sweep that plays every set's matches across a work stealing thread pool.
+*/
+
+#pragma once
+
+#include <cstdio>
+#include <vector>
+
+#include "game.h"
+#include "newTankParams.h"
+
+/*! \struct SweepRange
+* \brief Range one parameter is swept over.
+*/
+struct SweepRange
+{
+	int iParam; //!< Index of the parameter, see NewTankParams::find.
+	double dLow; //!< Lowest value.
+	double dHigh; //!< Highest value.
+	int iSteps; //!< Values in a grid sweep, spread evenly from low to high. Not used by Latin hypercube samples.
+};
+
+/*! \struct SweepResult
+* \brief One row of the sweep table.
+*/
+struct SweepResult
+{
+	NewTankParams params; //!< Parameters the set's side played with.
+	int iWins; //!< Matches the set's side scored more than the other side.
+	int iDraws; //!< Matches the sides tied.
+	int iLosses; //!< Matches the other side scored more.
+	double dWinRate; //!< Wins over matches played.
+	double dLow; //!< Bottom of the 95% Wilson score interval of the win rate.
+	double dHigh; //!< Top of the 95% Wilson score interval of the win rate.
+};
+
+/*! \class ParamSweep
+* \brief Plays AI tanks with many parameter sets against the defaults.
+*
+* Every set plays the same seeds, so sets are compared on the same games and the table comes out the same whatever the thread count.
+* Each seed is played twice, with the set on red against the defaults on the other teams and then the other way round, as the arena favours a side. The defaults against themselves win exactly half the matches they don't draw.
+* Each match is one task on the pool, and the time spent inside the tasks is added up to give matches per core-second.
+*/
+class ParamSweep
+{
+private:
+	GameSetup setup; //!< Teams, tanks and arena of every match.
+	int iMatchesPerSet; //!< Matches played with each parameter set, even so every seed is played from both sides.
+	long lMaxTicks; //!< Matches still running after this many ticks are stopped.
+	int iTickScale; //!< Game ticks advanced by each call to Game::play.
+	int iThreads; //!< Worker threads, 0 for one per hardware thread.
+	unsigned long long ullBaseSeed; //!< Seed of matches 0 and 1, each later pair adds its index.
+	std::vector<SweepRange> vRanges; //!< Parameters swept, the rest keep their defaults.
+	double dCoreSeconds; //!< Time spent playing matches in the last run, added up over every thread.
+public:
+	//! Constructor for ParamSweep.
+	/*!
+	* \param newSetup Teams, tanks and arena of every match.
+	* \param iNewMatchesPerSet Matches played with each parameter set, rounded up to even.
+	* \param lNewMaxTicks Matches still running after this many ticks are stopped.
+	* \param iNewTickScale Game ticks advanced by each call to Game::play.
+	* \param iNewThreads Worker threads, 0 for one per hardware thread.
+	* \param ullNewBaseSeed Seed of matches 0 and 1, each later pair adds its index.
+	*/
+	ParamSweep(const GameSetup &newSetup, int iNewMatchesPerSet, long lNewMaxTicks = 100000, int iNewTickScale = 1, int iNewThreads = 0, unsigned long long ullNewBaseSeed = 0);
+
+	void addRange(const SweepRange &range) { vRanges.push_back(range); } //!< Sweeps another parameter.
+	const std::vector<SweepRange> &getRanges() const { return vRanges; } //!< Parameters swept.
+	int matchesPerSet() const { return iMatchesPerSet; } //!< Matches played with each parameter set.
+
+	std::vector<NewTankParams> grid() const; //!< Every combination of the ranges' steps, the first range changing slowest.
+
+	//! Latin hypercube samples of the ranges, each range split into as many equal strata as samples and every stratum used once.
+	/*!
+	* \param iSamples Number of parameter sets.
+	* \param ullSeed Seed for placing the samples.
+	*/
+	std::vector<NewTankParams> latinHypercube(int iSamples, unsigned long long ullSeed) const;
+
+	//! Plays one match with a side's AI tanks using a parameter set, and returns -1 for a loss for that side, 0 for a draw and 1 for a win.
+	/*!
+	* \param params Parameters the side plays with.
+	* \param iMatch Index of the match in the set, even puts the set on red and odd on the other teams.
+	*/
+	int playMatch(const NewTankParams &params, int iMatch) const;
+
+	//! Plays every set's matches in parallel and returns the results in set order.
+	/*!
+	* \param sets The parameter sets.
+	*/
+	std::vector<SweepResult> run(const std::vector<NewTankParams> &sets);
+
+	double getCoreSeconds() const { return dCoreSeconds; } //!< Time spent playing matches in the last run, added up over every thread.
+
+	//! Works out the Wilson score interval of a proportion.
+	/*!
+	* \param iSuccesses Successes.
+	* \param iTrials Trials.
+	* \param dZ Standard normal quantile, 1.96 for 95%.
+	* \param dLow Set to the bottom of the interval.
+	* \param dHigh Set to the top of the interval.
+	*/
+	static void wilson(int iSuccesses, int iTrials, double dZ, double &dLow, double &dHigh);
+
+	//! Writes the results as a table, one row per parameter set with the swept parameters' values.
+	/*!
+	* \param results The results to write.
+	* \param file Where to write them.
+	*/
+	void printTable(const std::vector<SweepResult> &results, FILE *file) const;
+};
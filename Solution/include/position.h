@@ -12,7 +12,6 @@ private:
 public:
 	Position() {}; // Construtor
 	Position(float newX, float newY) { x = newX; y = newY; } // Constructor with params
-	~Position() {}; // Destructor
 	void set(float newX, float newY, float newTh) { x = newX; y = newY; th = newTh; }
 	float getX() const { return x; }
 	float getY() const { return y; }
@@ -0,0 +1,49 @@
+/*! \file random.h
+* \brief Header file for the seedable random number generator (The Random class).
+*
+* Contains a PCG32 generator, small and fast enough for every game to own one.
+*/
+
+#pragma once
+
+/*! \class Random
+* \brief PCG32 random number generator.
+*
+* Each game owns one and hands it to its AI, so games on different threads never share state, and a game can be played again exactly from its seed.
+*/
+class Random
+{
+private:
+	unsigned long long ullState; //!< Generator state, advanced by each number.
+	unsigned long long ullIncrement; //!< Stream selector, always odd.
+public:
+	//! Constructor for Random.
+	/*!
+	* \param ullSeed The seed.
+	*/
+	explicit Random(unsigned long long ullSeed = 0);
+
+	//! Restarts the sequence from a seed.
+	/*!
+	* \param ullSeed The seed.
+	*/
+	void seed(unsigned long long ullSeed);
+
+	//! Returns the next 32 random bits.
+	unsigned int next()
+	{
+		unsigned long long ullOld = ullState;
+		ullState = ullOld * 6364136223846793005ULL + ullIncrement;
+		unsigned int uiXorShifted = (unsigned int)(((ullOld >> 18u) ^ ullOld) >> 27u);
+		unsigned int uiRot = (unsigned int)(ullOld >> 59u);
+		return (uiXorShifted >> uiRot) | (uiXorShifted << ((0u - uiRot) & 31u));
+	}
+
+	//! Returns a number from 0 up to but not including n, in place of rand() % n.
+	/*!
+	* \param n The number of possible values, must be more than 0.
+	*/
+	int range(int n) { return (int)(((unsigned long long)next() * (unsigned int)n) >> 32); }
+
+	static unsigned long long timeSeed(); //!< A seed taken from the clock, for games nobody needs to repeat.
+};
@@ -0,0 +1,140 @@
+/*! \file replayLog.h
+* \brief Header file for recorded games (The ReplayLog class).
+*
+* Contains the replay file layout, and the log of key presses that plays a game back exactly from its seed.
+*
+* A file is a ReplayHeader, the ReplayEvent records, the keyframe snapshots (each starting on an 8 byte boundary) and finally the ReplayKeyframe index.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "gameSnapshot.h"
+
+class Game;
+
+// What a replay record holds
+enum ReplayEventType { REPLAY_KEY_PRESSED = 0, REPLAY_KEY_RELEASED = 1, REPLAY_END = 2 };
+
+/*! \struct ReplayHeader
+* \brief Start of a replay file.
+*
+* Files are little endian, laid out exactly as these structs.
+*/
+struct ReplayHeader
+{
+	char cMagic[4]; //!< Always "TWRP".
+	unsigned int uiVersion; //!< Format version, files from other versions are rejected.
+	unsigned long long ullSeed; //!< Seed the game was started with.
+	unsigned short usTickScale; //!< Game ticks per timestep.
+	unsigned short usPad; //!< Unused, zero.
+	unsigned int uiEventCount; //!< Number of records following the header.
+	unsigned int uiKeyframeCount; //!< Number of keyframes in the index.
+	unsigned int uiKeyframeInterval; //!< Timesteps between keyframes.
+	unsigned long long ullIndexOffset; //!< Where the keyframe index starts, from the start of the file.
+};
+
+/*! \struct ReplayEvent
+* \brief One record, a key press or release before a timestep, or the end of the game.
+*/
+struct ReplayEvent
+{
+	unsigned int uiTick; //!< Timesteps played before the event.
+	unsigned short usKey; //!< sf::Keyboard::Key code.
+	unsigned char ucType; //!< A ReplayEventType.
+	unsigned char ucPad; //!< Unused, zero.
+};
+
+/*! \struct ReplayKeyframe
+* \brief Index entry for a full game snapshot, taken after a timestep and before the events of the next.
+*/
+struct ReplayKeyframe
+{
+	unsigned int uiTick; //!< Timesteps played when the snapshot was taken.
+	unsigned int uiSize; //!< Size of the snapshot in bytes.
+	unsigned long long ullOffset; //!< Where the snapshot starts, from the start of the file.
+};
+
+/*! \class ReplayLog
+* \brief Seed plus every key press and release of a game.
+*
+* The simulation only depends on its seed and its input, so applying the same input at the same timesteps plays the same game again without drawing anything.
+* Every few hundred timesteps a snapshot of the whole game is kept as well, so a ReplayReader can start from anywhere in the game.
+*/
+class ReplayLog
+{
+private:
+	ReplayHeader header; //!< Seed, tick scale and keyframe interval.
+	std::vector<ReplayEvent> vEvents; //!< Records in timestep order, ending with REPLAY_END once finished.
+	std::vector<ReplayKeyframe> vKeyframes; //!< Keyframe index, offsets are into vKeyframeData until saved.
+	std::vector<unsigned char> vKeyframeData; //!< Keyframe snapshots back to back, each padded to 8 bytes.
+	GameSnapshot snapshot; //!< Reused to take keyframes without allocating.
+
+	void addKeyframe(const Game &game); //!< Appends a snapshot of a game to the keyframes.
+public:
+	static const unsigned int s_kuiVersion = 2; //!< Current format version.
+	static const unsigned int s_kuiDefaultKeyframeInterval = 500; //!< Timesteps between keyframes unless told otherwise.
+
+	ReplayLog(); //!< Default constructor for ReplayLog, an empty log.
+
+	//! Starts a new log for a game.
+	/*!
+	* \param game The game about to be recorded, before its first timestep.
+	* \param uiKeyframeInterval Timesteps between keyframes, so seeking never plays more than this many.
+	*/
+	void begin(const Game &game, unsigned int uiKeyframeInterval = s_kuiDefaultKeyframeInterval);
+
+	//! Called by a recording game after each timestep, takes a keyframe when one is due.
+	/*!
+	* \param game The game being recorded.
+	*/
+	void timestepPlayed(const Game &game);
+
+	//! Adds a key press or release.
+	/*!
+	* \param uiTick Timesteps played before the event.
+	* \param iKey The sf::Keyboard::Key code.
+	* \param bPressed True for a press, false for a release.
+	*/
+	void addKey(unsigned int uiTick, int iKey, bool bPressed);
+
+	//! Closes the log.
+	/*!
+	* \param uiTick Timesteps played in the whole game.
+	*/
+	void end(unsigned int uiTick);
+
+	bool isFinished() const { return !vEvents.empty() && vEvents.back().ucType == REPLAY_END; } //!< Has end been called?
+	unsigned long long getSeed() const { return header.ullSeed; } //!< Seed the game was started with.
+	unsigned short getTickScale() const { return header.usTickScale; } //!< Game ticks per timestep.
+	unsigned int getLength() const; //!< Timesteps in the recorded game (0 until finished).
+	const std::vector<ReplayEvent> &getEvents() const { return vEvents; } //!< Every record.
+	const std::vector<ReplayKeyframe> &getKeyframes() const { return vKeyframes; } //!< Every keyframe.
+
+	bool save(const std::string &sFile) const; //!< Writes the log to a file, false on failure.
+	bool load(const std::string &sFile); //!< Reads a log from a file, false if it can't be read or isn't a replay.
+
+	//! Passes a game every event recorded for its current timestep, call before each Game::play.
+	/*!
+	* \param game The game being played back, built with getSeed and getTickScale.
+	* \param uiNext Index of the next record to apply, start at 0.
+	*/
+	void applyEvents(Game &game, size_t &uiNext) const { applyEvents(game, vEvents.data(), vEvents.size(), uiNext); }
+
+	//! Passes a game every event in a list recorded for its current timestep.
+	/*!
+	* \param game The game being played back.
+	* \param pEvents The records, in timestep order.
+	* \param uiCount Number of records.
+	* \param uiNext Index of the next record to apply.
+	*/
+	static void applyEvents(Game &game, const ReplayEvent *pEvents, size_t uiCount, size_t &uiNext);
+
+	//! Plays the whole log back on a game, returns false if the log isn't finished or its first keyframe is damaged.
+	/*!
+	* \param game A new game built with getSeed, the tick scale is set here. The first keyframe replaces it if there is one, so games with any setup play back.
+	*/
+	bool playback(Game &game) const;
+};
@@ -0,0 +1,67 @@
+/*! \file replayReader.h
+* \brief Header file for seeking through replay files (The ReplayReader class).
+*
+* Contains the memory mapped view of a replay file, used to jump to any timestep of a recorded game.
+*/
+
+#pragma once
+
+#include <string>
+
+#include "gameSnapshot.h"
+#include "replayLog.h"
+
+class Game;
+
+/*! \class ReplayReader
+* \brief Read only, memory mapped replay file.
+*
+* Nothing is read up front, so opening a long game is instant. Seeking restores the nearest keyframe at or before the timestep and plays forward from there,
+* at most one keyframe interval.
+*/
+class ReplayReader
+{
+private:
+	const unsigned char *pData; //!< Start of the mapped file.
+	size_t uiSize; //!< Size of the mapped file in bytes.
+#ifdef _WIN32
+	void *pFile; //!< File handle.
+	void *pMapping; //!< File mapping handle.
+#endif
+	const ReplayHeader *pHeader; //!< Header, at the start of the mapping.
+	const ReplayEvent *pEvents; //!< Records, straight after the header.
+	const ReplayKeyframe *pKeyframes; //!< Keyframe index, at the end of the file.
+	size_t uiNextEvent; //!< Index of the next record to apply to the game being played back.
+	GameSnapshot snapshot; //!< Reused to restore keyframes without allocating.
+
+	bool validate(); //!< Checks the header and index fit the file, sets up the pointers into it.
+public:
+	ReplayReader(); //!< Default constructor for ReplayReader, nothing open.
+	~ReplayReader(); //!< Destructor, unmaps the file.
+	ReplayReader(const ReplayReader &) = delete;
+	ReplayReader &operator=(const ReplayReader &) = delete;
+
+	bool open(const std::string &sFile); //!< Maps a replay file, false if it can't be mapped or isn't a finished replay.
+	void close(); //!< Unmaps the file.
+	bool isOpen() const { return pData != nullptr; } //!< Is a file mapped?
+
+	unsigned long long getSeed() const { return pHeader->ullSeed; } //!< Seed the game was started with.
+	unsigned short getTickScale() const { return pHeader->usTickScale; } //!< Game ticks per timestep.
+	unsigned int getLength() const; //!< Timesteps in the recorded game.
+	unsigned int getEventCount() const { return pHeader->uiEventCount; } //!< Number of records, including the end.
+	unsigned int getKeyframeCount() const { return pHeader->uiKeyframeCount; } //!< Number of keyframes.
+	unsigned int getKeyframeInterval() const { return pHeader->uiKeyframeInterval; } //!< Timesteps between keyframes.
+
+	//! Puts a game in the state it was in after a number of timesteps, returns false if the keyframe is damaged.
+	/*!
+	* \param game The game to set, any game will do, everything is restored from the keyframe.
+	* \param uiTick Timesteps played, past the end of the game is the end.
+	*/
+	bool seek(Game &game, unsigned int uiTick);
+
+	//! Plays a game on by one timestep after seek, returns false at the end of the recording.
+	/*!
+	* \param game The game passed to seek.
+	*/
+	bool step(Game &game);
+};
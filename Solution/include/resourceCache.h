@@ -0,0 +1,44 @@
+/*! \file resourceCache.h
+* \brief Header file for the shared asset cache (The ResourceCache class).
+*
+* Contains the textures and fonts loaded from disk, so each file is only loaded once however many objects use it.
+*/
+
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/*! \class ResourceCache
+* \brief Reference counted cache of textures and fonts.
+*
+* Every user of a file shares one copy. Assets stay cached while anything holds them, and after that until purge() is called, so a new game reuses the last one's assets.
+* In headless mode nothing is loaded and null handles are returned.
+*/
+class ResourceCache
+{
+private:
+	static std::map<std::string, std::shared_ptr<const sf::Texture>> s_textures; //!< Loaded textures by file name.
+	static std::map<std::string, std::shared_ptr<const sf::Font>> s_fonts; //!< Loaded fonts by file name.
+	static std::mutex s_mutex; //!< Guards the maps, games may be built on several threads.
+	static bool s_bHeadless; //!< If true, nothing is loaded.
+public:
+	//! Returns the texture for a file, loading it the first time.
+	/*!
+	* \param sFile Path of the image file.
+	*/
+	static std::shared_ptr<const sf::Texture> getTexture(const std::string &sFile);
+
+	//! Returns the font for a file, loading it the first time.
+	/*!
+	* \param sFile Path of the font file.
+	*/
+	static std::shared_ptr<const sf::Font> getFont(const std::string &sFile);
+
+	static void setHeadless(bool bHeadless) { s_bHeadless = bHeadless; } //!< Turn loading off when nothing will be drawn (Set before creating any games).
+	static bool isHeadless() { return s_bHeadless; } //!< Is loading turned off?
+	static void purge(); //!< Releases every asset that nothing else is holding.
+};
@@ -0,0 +1,40 @@
+/*! \file sharedMemory.h
+* \brief Header file for memory other processes can map (The SharedMemory class).
+*
+* Contains a block of memory that is either private to the process or named, so a learner in another process can map the same bytes.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/*! \class SharedMemory
+* \brief A block of zeroed memory, shared by name with other processes.
+*
+* Named blocks are POSIX shared memory objects (/dev/shm/name on Linux) or Windows file mappings, and are removed again when the block is destroyed.
+* An empty name gives memory private to the process, through the same calls, so the code using it doesn't change.
+*/
+class SharedMemory
+{
+private:
+	void *pData; //!< The mapped block, null if mapping failed.
+	size_t uiSize; //!< Size of the block in bytes.
+	std::string sName; //!< Name other processes map it by, empty for private memory.
+	void *pHandle; //!< File mapping handle on Windows, not used elsewhere.
+public:
+	//! Constructor for SharedMemory, maps the block.
+	/*!
+	* \param uiNewSize Size of the block in bytes.
+	* \param sNewName Name other processes map it by, empty for memory private to this process.
+	*/
+	SharedMemory(size_t uiNewSize, const std::string &sNewName = std::string());
+	~SharedMemory(); //!< Unmaps the block, and removes its name.
+	SharedMemory(const SharedMemory &) = delete; //!< Not copyable, it owns the mapping.
+	SharedMemory &operator=(const SharedMemory &) = delete;
+
+	bool isMapped() const { return pData != nullptr; } //!< Did mapping the block work?
+	void *data() const { return pData; } //!< The block, aligned to a page.
+	size_t size() const { return uiSize; } //!< Size of the block in bytes.
+	const std::string &getName() const { return sName; } //!< Name other processes map it by, empty for private memory.
+};
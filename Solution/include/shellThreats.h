@@ -0,0 +1,88 @@
+/*! \file shellThreats.h
+* \brief Header file for the threat evaluator of seen shells (The ShellThreats class).
+*
+* Contains the shells an AI tank has seen, as positions and velocities in separate arrays, and the SIMD kernel that works out when and how close each will pass the tank.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include "position.h"
+#include "gameSnapshot.h"
+
+/*! \struct ShellThreat
+* \brief Closest approach of a shell to the tank.
+*/
+struct ShellThreat
+{
+	int iShell; //!< Index of the shell, -1 if there is no threat.
+	float fTime; //!< Game ticks until the closest approach.
+	float fDistance; //!< Distance between the shell and the tank's centre at the closest approach.
+	float fMissX; //!< X of the vector from the shell at its closest approach to the tank.
+	float fMissY; //!< Y of the vector from the shell at its closest approach to the tank.
+};
+
+/*! \class ShellThreats
+* \brief Shells seen since the tank last moved.
+*
+* Shells fly in a straight line at a constant speed, so the time of closest approach to a still tank is the projection of the tank onto the shell's path, clamped to the time the shell has yet to fly.
+* Every shell is worked out at once with no stamping into the map, and each keeps its own position and heading so any number of shells is handled.
+* The arrays grow a kernel width at a time when more shells are seen than they hold, and keep their memory when cleared, so a busy arena only allocates the first time.
+*/
+class ShellThreats
+{
+private:
+	static const int s_kiWidth = 4; //!< Shells worked out at once by the kernel, the arrays are always a multiple of it.
+	static const int s_kiStartCapacity = 16; //!< Shells held before the arrays first grow.
+
+	std::vector<float> vfX; //!< X positions.
+	std::vector<float> vfY; //!< Y positions.
+	std::vector<float> vfVx; //!< X velocities per game tick.
+	std::vector<float> vfVy; //!< Y velocities per game tick.
+	int iCount; //!< Number of shells remembered.
+
+	mutable std::vector<float> vfTime; //!< Scratch for mostUrgent, the time of closest approach of each shell.
+	mutable std::vector<float> vfMissX; //!< Scratch for mostUrgent, X of the vector from each shell at its closest approach to the tank.
+	mutable std::vector<float> vfMissY; //!< Scratch for mostUrgent, Y of the vector from each shell at its closest approach to the tank.
+
+	void setPadding(int i); //!< Makes slot i a shell far away that can never come close.
+	void grow(); //!< Adds a kernel width of padding slots to every array.
+
+	//! Remembers a shell by position and velocity, growing the arrays if they are full.
+	/*!
+	* \param fNewX X position.
+	* \param fNewY Y position.
+	* \param fNewVx X velocity per game tick.
+	* \param fNewVy Y velocity per game tick.
+	*/
+	void push(float fNewX, float fNewY, float fNewVx, float fNewVy);
+public:
+	ShellThreats(); //!< Default constructor for ShellThreats, holds no shells.
+
+	void clear(); //!< Forgets every shell.
+
+	//! Remembers a shell.
+	/*!
+	* \param p Position and heading of the shell.
+	*/
+	void add(Position p);
+
+	int size() const { return iCount; } //!< Number of shells remembered.
+	float getX(int i) const { return vfX[i]; } //!< X position of a shell.
+	float getY(int i) const { return vfY[i]; } //!< Y position of a shell.
+	float getVx(int i) const { return vfVx[i]; } //!< X velocity of a shell per game tick.
+	float getVy(int i) const { return vfVy[i]; } //!< Y velocity of a shell per game tick.
+
+	//! Finds the shell that will pass within a radius of the tank soonest.
+	/*!
+	* \param fTankX X position of the tank.
+	* \param fTankY Y position of the tank.
+	* \param fRadius Shells passing further than this from the tank's centre are no threat.
+	* \param fHorizon Game ticks ahead to look.
+	*/
+	ShellThreat mostUrgent(float fTankX, float fTankY, float fRadius, float fHorizon) const;
+
+	void saveState(GameSnapshot &snapshot) const; //!< Writes the shells into a snapshot.
+	bool loadState(GameSnapshot &snapshot); //!< Reads the shells back from a snapshot, returns false if it runs out.
+};
@@ -0,0 +1,68 @@
+/*! \file spatialGrid.h
+* \brief Header file for the uniform grid used for area queries (The SpatialGrid class).
+*
+* Contains a grid of cells over the arena, each holding a list of the items whose centre lies inside it.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include "boundingBox.h"
+
+/*! \class SpatialGrid
+* \brief Uniform grid of items, by index.
+*
+* Used for tanks and shells so collision and vision checks only look at things nearby, rather than every pair.
+* Items are stored by centre, queries are widened by the largest half size of an item so nothing overlapping the area is missed.
+*/
+class SpatialGrid
+{
+private:
+	float fCellSize; //!< Width and height of a cell.
+	float fMaxHalfExtent; //!< Largest half width or height of an item.
+	int iColumns; //!< Number of columns of cells.
+	int iRows; //!< Number of rows of cells.
+
+	std::vector<int> viHead; //!< First item in each cell, -1 for none.
+	std::vector<int> viNext; //!< Next item in the same cell, -1 at the end.
+	std::vector<int> viPrev; //!< Previous item in the same cell, -1 at the start.
+	std::vector<int> viCell; //!< Cell each item is in, -1 if not in the grid.
+
+	int cellX(float fX) const; //!< Column containing an x position, clamped to the grid.
+	int cellY(float fY) const; //!< Row containing a y position, clamped to the grid.
+	void unlink(int i); //!< Takes item i out of its cell's list.
+	void link(int i, int iCell); //!< Puts item i at the front of a cell's list.
+public:
+	SpatialGrid(); //!< Default constructor for SpatialGrid, holds nothing until setup is called.
+
+	//! Sizes the grid, removing every item.
+	/*!
+	* \param fWidth Width of the area covered, positions outside it go in the edge cells.
+	* \param fHeight Height of the area covered.
+	* \param fNewCellSize Width and height of a cell.
+	* \param fNewMaxHalfExtent Largest half width or height of an item.
+	* \param iItems Number of item indexes, items are numbered from 0.
+	*/
+	void setup(float fWidth, float fHeight, float fNewCellSize, float fNewMaxHalfExtent, int iItems);
+
+	void resize(int iItems); //!< Changes the number of item indexes, removing every item.
+	void clear(); //!< Removes every item.
+
+	//! Adds an item, or moves it if it is already in the grid.
+	/*!
+	* \param i Index of the item.
+	* \param fX Centre of the item in x.
+	* \param fY Centre of the item in y.
+	*/
+	void place(int i, float fX, float fY);
+
+	void remove(int i); //!< Takes an item out of the grid.
+
+	//! Finds every item that may overlap a box, in ascending index order so results don't depend on the order items were placed.
+	/*!
+	* \param box The area to search.
+	* \param viOut Cleared, then filled with the item indexes.
+	*/
+	void query(const BoundingBox &box, std::vector<int> &viOut) const;
+};
@@ -1,24 +1,26 @@
 #ifndef TANK_H
 #define TANK_H
 
-
-#include <SFML/Graphics.hpp>
+#include <cmath>
 
 #include "position.h"
 #include "boundingBox.h"
+#include "gameSnapshot.h"
+#include "entityStore.h"
 
-class Tank : public sf::Drawable
+class Tank
 {
 private:
-	short fireCounter; //!< Game tick counter for firing
+	EntityStore *store; //!< Store holding the tank's position, turret, ammo and reload, set by the game
+	int entity; //!< Index of the tank in the store
+	short stepTicks; //!< Number of game ticks covered by each call to implementMove
+	float turretTurnLimit; //!< Most degrees the turret may turn in the next move, so an AI aiming at a coarse tick scale can stop on its target
 	static const float moveConst; //!< Total amount of movement allowed each timestep
 	static const float rotMoveConst; //!< Total amount of rotational movement allowed each timestep for the tank
 	static const float turRotMoveConst; //!< Total amount of rotational movement allowed each timestep for the turrent
 protected:
-	Position pos; //!< Current position of the tank
-	Position oldPos; //!< Previous position of the tank, used in very basic position correction for collisions
-	float turretTh; //!< Current heading of the gun turret
-	int numberOfShells; //!< Amount of ammo left
+	Position getPos() const { return store->getTankPos(entity); } //!< Current position of the tank
+	Position getOldPos() const { return store->getTankOldPos(entity); } //!< Previous position of the tank, used in very basic position correction for collisions
 
 	bool forward; //!< Tank moving forwards
 	bool backward; //!< Tank moving backwards
@@ -27,17 +29,21 @@ protected:
 	bool turretLeft; //!< Turret turning left
 	bool turretRight; //!< Turret turing right
 
+	// How far each move goes, so the AI's tolerances can grow with the tick scale rather than be stepped over
+	float stepMove() const { return moveConst * stepTicks; } //!< Distance driven by one move
+	float stepTurn() const { return rotMoveConst * stepTicks; } //!< Degrees the body turns in one move
+	float stepTurretTurn() const { return turRotMoveConst * stepTicks; } //!< Degrees the turret turns in one move
+	float turretTurn() const { return stepTurretTurn() < turretTurnLimit ? stepTurretTurn() : turretTurnLimit; } //!< Degrees the turret turns in the next move, within its limit
+	void limitTurretTurn(float fDegrees) { turretTurnLimit = fDegrees; } //!< Turn the turret no more than this in the next move
+	void clearTurretTurnLimit() { turretTurnLimit = s_kfNoTurnLimit; } //!< Turn the turret a whole move's worth again
+	static const float s_kfNoTurnLimit; //!< Turret turn limit that never limits
+
 	void clearMovement(); //!< Stop current movement
-	void updateBb(); //!< Update the bounding box position to be the same as the tank
-	sf::Sprite body; //!< Sprite used to draw the tank
-	sf::Texture bodyTex; //!< Texture used by the tank sprite
-	sf::Sprite turret; //!< Sprite used to draw the tanks turret 
-	sf::Texture turretTex; //!< Texture used by the tank turret sprite 
-	bool debugMode; //!< Debug mode - show more stuff
 public:
 	Tank();
-	BoundingBox bb; //!< BB for collision detection
-	virtual void draw(sf::RenderTarget &target, sf::RenderStates states) const; //!< Draw Tank
+	static const int startingShells = 15; //!< Ammo each tank starts with
+	void bind(EntityStore *newStore, int newEntity) { store = newStore; entity = newEntity; } //!< Set the store slot the tank works on (Set by the game)
+	BoundingBox getBb() const { return store->getTankBox(entity); } //!< BB for collision detection
 	void resetTank(float newX, float newY, float newTh, float newTurretTh); //!< Reset Tank's position
 		// Movement methods
 	void goForward(); //!< Set the tank to go forwards
@@ -48,20 +54,26 @@ public:
 	void turretGoRight(); //!< Set the turret to go right
 	void stop() { clearMovement(); } //!< Stop the tank body movement
 	void stopTurret(); //!< Stop the turret movement
-	void markPos() { oldPos = pos; } //!< Record the prevoius position
-	void recallPos() { pos = oldPos; updateBb(); } //!< Go back to the prevoius position - simple form of position correction
+	void markPos() { store->markTankPos(entity); } //!< Record the prevoius position
+	void recallPos() { store->recallTankPos(entity); } //!< Go back to the prevoius position - simple form of position correction
 
 	void fireShell(); //!< Fire a shell
 	virtual void move() = 0; //?!< Implemented in child classes
 	void implementMove(); //!< Move tank, relise what is in the move funtion
+	void setStepTicks(short ticks) { stepTicks = ticks; } //!< Set how many game ticks each move covers
+	short getStepTicks() const { return stepTicks; } //!< Game ticks each move covers
 
 	Position firingPosition() const; //!< Position of the tank as shell is fired
-	float getX() const { return pos.getX(); } //!< Position of the tank in x
-	float getY() const { return pos.getY(); } //!< Position of the tank in y
-	int getNumberOfShells()const { return numberOfShells; } //!< Amount of ammo left
+	float getX() const { return getPos().getX(); } //!< Position of the tank in x
+	float getY() const { return getPos().getY(); } //!< Position of the tank in y
+	float getTh() const { return getPos().getTh(); } //!< Heading of the tank
+	float getTurretTh() const { return store->getTurret(entity); } //!< Heading of the gun turret
+	int getNumberOfShells()const { return store->getAmmo(entity); } //!< Amount of ammo left
 	bool canSee(BoundingBox other) const; //!< Can this tank see the bounding box?
-	bool canFire() const { return numberOfShells > 0 && fireCounter == 0; } //!< Can this tnak fire
-	bool hasAmmo() const { return numberOfShells > 0; } //!< Does this tank have nay ammo left
-	void toggleDebugMode() { debugMode = !debugMode; } //!< Toggle the debug mode
+	bool canFire() const { return store->getAmmo(entity) > 0 && store->getReload(entity) == 0; } //!< Can this tnak fire
+	bool hasAmmo() const { return store->getAmmo(entity) > 0; } //!< Does this tank have nay ammo left
+
+	virtual void saveState(GameSnapshot &snapshot) const; //!< Write the tank's controls into a snapshot, the rest is in the store
+	virtual bool loadState(GameSnapshot &snapshot); //!< Read the tank's controls back from a snapshot, false if it runs out
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,73 @@
+/*! \file targetSelector.h
+* \brief Header file for choosing what to shoot at (The TargetSelector class).
+*
+* Contains the utility weights used to score targets, and the targets an AI tank has sensed as positions and scores in separate arrays, scored together by a SIMD kernel.
+*/
+
+#pragma once
+
+#include "position.h"
+#include "gameSnapshot.h"
+
+/*! \struct TargetUtility
+* \brief Weights of the terms of a target's utility.
+*
+* Utility = fValue * value + fThreat * threat + fAim * cos(turret to target angle) - fDistance * distance. The highest utility target is shot at.
+*/
+struct TargetUtility
+{
+	float fDistance; //!< Utility lost per pixel to the target.
+	float fAim; //!< Utility of the turret already pointing at the target, scaled by the cosine of the angle it has to turn.
+	float fThreat; //!< Utility per unit of threat the target poses.
+	float fValue; //!< Utility per unit of value of destroying the target.
+};
+
+/*! \class TargetSelector
+* \brief Targets sensed since the tank last moved.
+*
+* Every candidate is scored in one sweep at the start of the next move, four at a time with SSE2, and the best is picked.
+*/
+class TargetSelector
+{
+private:
+	static const int s_kiCapacity = 32; //!< Most targets remembered, a multiple of the kernel width. Later targets are ignored.
+
+	float fX[s_kiCapacity]; //!< X positions.
+	float fY[s_kiCapacity]; //!< Y positions.
+	float fThreat[s_kiCapacity]; //!< How dangerous each target is.
+	float fValue[s_kiCapacity]; //!< How worth destroying each target is.
+	int iType[s_kiCapacity]; //!< Object type of each target, for the tank, not used in scoring.
+	int iCount; //!< Number of targets remembered.
+
+	void setPadding(int i); //!< Makes slot i a target worth nothing.
+public:
+	TargetSelector(); //!< Default constructor for TargetSelector, holds no targets.
+
+	void clear(); //!< Forgets every target.
+
+	//! Remembers a target, returns false if full.
+	/*!
+	* \param p Position of the target.
+	* \param iNewType Object type of the target.
+	* \param fNewThreat How dangerous the target is.
+	* \param fNewValue How worth destroying the target is.
+	*/
+	bool add(Position p, int iNewType, float fNewThreat, float fNewValue);
+
+	int size() const { return iCount; } //!< Number of targets remembered.
+	float getX(int i) const { return fX[i]; } //!< X position of a target.
+	float getY(int i) const { return fY[i]; } //!< Y position of a target.
+	int getType(int i) const { return iType[i]; } //!< Object type of a target.
+
+	//! Scores every target and returns the index of the best, -1 if there are none. The first target wins a tie.
+	/*!
+	* \param fTankX X position of the tank.
+	* \param fTankY Y position of the tank.
+	* \param fTurretTh Heading of the tank's turret in degrees.
+	* \param utility Weights of the utility terms.
+	*/
+	int best(float fTankX, float fTankY, float fTurretTh, const TargetUtility &utility) const;
+
+	void saveState(GameSnapshot &snapshot) const; //!< Writes the targets into a snapshot.
+	bool loadState(GameSnapshot &snapshot); //!< Reads the targets back from a snapshot, returns false if it runs out or they don't fit.
+};
@@ -0,0 +1,153 @@
+/*! \file vecEnv.h
+* \brief Header file for stepping many games for a learner in another process (The VecEnv class).
+*
+* Contains the layout of the shared block a learner maps, the settings of the environments, and the class that steps them in parallel straight into the block.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "game.h"
+#include "knowledgeGrid.h"
+#include "sharedMemory.h"
+#include "workStealingPool.h"
+
+/*! \struct VecEnvHeader
+* \brief Start of the shared block, telling a learner where everything is and carrying its requests.
+*
+* Every field is 4 bytes, so a learner in any language can read it with a fixed layout. Offsets are in bytes from the start of the block, and every buffer is 32 bit floats.
+*/
+struct VecEnvHeader
+{
+	char cMagic[4]; //!< "TWVE".
+	unsigned int uiVersion; //!< Layout version, VecEnv::s_kuiVersion.
+	unsigned int uiEnvs; //!< Number of environments.
+	unsigned int uiActionSize; //!< Floats in each environment's action.
+	unsigned int uiObservationSize; //!< Floats in each environment's observation, the grid channels then the state.
+	unsigned int uiGridChannels; //!< Channels of the grid, one per kind of Object but UNKNOWN.
+	unsigned int uiGridWidth; //!< Columns of the grid.
+	unsigned int uiGridHeight; //!< Rows of the grid.
+	unsigned int uiStateSize; //!< Floats of tank and shell state after the grid.
+	unsigned int uiActionsOffset; //!< Where the actions start, uiEnvs by uiActionSize.
+	unsigned int uiObservationsOffset; //!< Where the observations start, uiEnvs by uiObservationSize.
+	unsigned int uiRewardsOffset; //!< Where the rewards start, one per environment.
+	unsigned int uiDonesOffset; //!< Where the done flags start, one per environment, 1 when the step ended an episode.
+	std::atomic<unsigned int> uiCommand; //!< What the learner wants done, a VecEnv::Command.
+	std::atomic<unsigned int> uiRequest; //!< Bumped by the learner, last, once the command and actions are written.
+	std::atomic<unsigned int> uiCompleted; //!< Set to uiRequest by the server once the buffers hold the result.
+};
+
+/*! \struct VecEnvSettings
+* \brief How many environments a VecEnv steps, and how.
+*/
+struct VecEnvSettings
+{
+	int iEnvs; //!< Environments stepped together.
+	long lMaxTicks; //!< Timesteps before an episode is cut short.
+	int iTickScale; //!< Game ticks advanced by each step, so each action is held for this many ticks.
+	int iThreads; //!< Worker threads, 0 for one per hardware thread.
+	VecEnvSettings() : iEnvs(8), lMaxTicks(20000), iTickScale(1), iThreads(0) {}
+};
+
+/*! \class VecEnv
+* \brief A batch of games stepped together for a reinforcement learner, through buffers in shared memory.
+*
+* The learner drives the player's blue tank in each game, through the same key presses a person would make, so a recording of an environment replays.
+* Actions, observations, rewards and done flags live in one block a learner in another process maps by name, and each game reads its action and writes its results in place, so nothing is copied per step.
+* Each environment's step is one task on a work stealing pool. An episode ends when the game is over or runs out of time, and the environment restarts on its next seed in the same step, so its observation is then the new episode's first.
+*
+* An action is three floats: the body (0 none, 1 forward, 2 back, 3 left, 4 right), the turret (0 still, 1 left, 2 right) and fire (above a half).
+* An observation is what the player knows, laid out over the AI tanks' map nodes as one channel per Object in channel, row, column order: its own buildings, enemy buildings it has ever seen, and enemy tanks and shells it can see now.
+* The grid is followed by the player's position, heading, turret, shells, whether it can fire and how far through the episode it is, then the nearest enemy tanks and shells it can see.
+* The reward is the change in blue's lead over the best other team, in points.
+*
+* To step from another process, write the actions, then uiCommand, then bump uiRequest, and wait until uiCompleted equals it.
+*/
+class VecEnv
+{
+public:
+	//! What a learner can ask a served VecEnv to do.
+	enum Command
+	{
+		NONE, //!< Nothing asked yet.
+		STEP, //!< Step every environment with the actions in the block.
+		RESET, //!< Start every environment on a new episode.
+		QUIT //!< Stop serving.
+	};
+	static const unsigned int s_kuiVersion = 1; //!< Version of the block's layout.
+	static const int s_kiActionSize = 3; //!< Floats in an action: body, turret, fire.
+	static const int s_kiGridChannels = 4; //!< OWNBASE, PLAYERBASE, PLAYERTANK and PLAYERSHELL.
+	static const int s_kiGridWidth = Map::s_kiWidth; //!< Columns of the grid.
+	static const int s_kiGridHeight = Map::s_kiHeight; //!< Rows of the grid.
+	static const int s_kiNearest = 4; //!< Enemy tanks, and enemy shells, listed by the state.
+	static const int s_kiStateSize = 9 + s_kiNearest * 3 + s_kiNearest * 5; //!< Player, then each tank's offset and presence, then each shell's offset, heading and presence.
+private:
+	//! One game and what the learner's last action left pressed in it.
+	struct Env
+	{
+		std::unique_ptr<Game> game; //!< The game.
+		KnowledgeGrid grid; //!< What the player knows this step, laid out over the map nodes.
+		std::vector<std::pair<float, int>> vNearest; //!< Reused distances to the tanks or shells seen.
+		unsigned long long ullSeed; //!< Seed of the episode being played.
+		long lTicks; //!< Timesteps played in the episode.
+		int iMargin; //!< Blue's lead after the last step.
+		int iBody; //!< Body key held down, as an action.
+		int iTurret; //!< Turret key held down, as an action.
+	};
+
+	VecEnvSettings settings; //!< Environments and how they step.
+	GameSetup setup; //!< Teams, tanks and arena of every game.
+	int iObservationSize; //!< Floats in each observation.
+	SharedMemory memory; //!< The block the buffers live in.
+	VecEnvHeader *pHeader; //!< Start of the block.
+	float *pfActions; //!< Actions, written by the learner.
+	float *pfObservations; //!< Observations, written by the games.
+	float *pfRewards; //!< Rewards of the last step.
+	float *pfDones; //!< Done flags of the last step.
+	std::vector<Env> vEnvs; //!< The environments.
+	WorkStealingPool pool; //!< Threads the environments step on.
+
+	//! Size of the block, and where each buffer goes in it.
+	/*!
+	* \param iEnvs Number of environments.
+	* \param iObservations Floats in each observation.
+	* \param puiOffsets Where the actions, observations, rewards and done flags start, null if only the size is needed.
+	*/
+	static size_t blockBytes(int iEnvs, int iObservations, size_t *puiOffsets);
+	static int lead(const Game &game); //!< Blue's score less the best of the other teams'.
+	void begin(int e); //!< Restarts environment e on its seed.
+	void act(int e); //!< Presses and releases the player's keys for environment e's action.
+	void observe(int e); //!< Writes environment e's observation.
+	void stepEnv(int e); //!< Steps environment e, restarting it if the episode ended.
+public:
+	//! Constructor for VecEnv, builds the games, and maps the block and writes every first observation.
+	/*!
+	* \param newSettings Environments and how they step.
+	* \param newSetup Teams, tanks and arena of every game, blue's first tank being the learner's.
+	* \param ullSeed Seed of the first environment's first episode, the others count up from it and each episode after adds the number of environments.
+	* \param sName Name a learner maps the block by, empty for a block only this process uses.
+	*/
+	VecEnv(const VecEnvSettings &newSettings, const GameSetup &newSetup, unsigned long long ullSeed, const std::string &sName = std::string());
+
+	bool isReady() const { return pHeader != nullptr; } //!< Was the block mapped? Nothing else works if not.
+
+	void reset(); //!< Starts every environment on a new episode, and writes their observations.
+	void step(); //!< Steps every environment with its action, and writes observations, rewards and done flags.
+
+	//! Answers a learner's requests until it asks to quit, returns false if the block isn't mapped.
+	bool serve();
+
+	int numEnvs() const { return settings.iEnvs; } //!< Number of environments.
+	int observationSize() const { return iObservationSize; } //!< Floats in each observation.
+	float *actions() { return pfActions; } //!< Actions, s_kiActionSize per environment.
+	const float *observations() const { return pfObservations; } //!< Observations, observationSize() per environment.
+	const float *rewards() const { return pfRewards; } //!< Rewards of the last step.
+	const float *dones() const { return pfDones; } //!< Done flags of the last step.
+	const Game &getGame(int e) const { return *vEnvs[e].game; } //!< Environment e's game.
+	const std::string &getName() const { return memory.getName(); } //!< Name a learner maps the block by.
+};
@@ -0,0 +1,75 @@
+/*! \file workStealingPool.h
+* \brief Header file for the thread pool used to run many games at once (The WorkStealingPool class).
+*
+* Contains the worker threads, each with its own queue of tasks, and the stealing that keeps them all busy.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*! \class WorkStealingPool
+* \brief Thread pool with a task queue per worker.
+*
+* Tasks are shared out between the workers' queues as they are submitted. A worker takes the newest task from its own queue, and when that is empty it steals the oldest task from another worker's queue.
+* Workers only touch each other's queues when they run out, so there is no single queue for every thread to fight over, and tasks of very different lengths still balance out.
+*/
+class WorkStealingPool
+{
+private:
+	/*! \struct Worker
+	* \brief A worker thread's queue.
+	*/
+	struct Worker
+	{
+		std::deque<std::function<void()>> dqTasks; //!< Tasks waiting to run, the owner works from the back and thieves from the front.
+		std::mutex mutex; //!< Guards the queue.
+	};
+
+	std::vector<std::unique_ptr<Worker>> vWorkers; //!< One queue per thread.
+	std::vector<std::thread> vThreads; //!< The worker threads.
+
+	std::mutex mutex; //!< Guards the counts below, and is what idle workers wait on.
+	std::condition_variable cvWork; //!< Signalled when a task is submitted or the pool is stopping.
+	std::condition_variable cvDone; //!< Signalled when the last task finishes.
+	std::atomic<int> iQueued; //!< Tasks waiting in any queue.
+	int iUnfinished; //!< Tasks submitted but not yet finished.
+	bool bStopping; //!< If true, the workers exit once the queues are empty.
+	std::atomic<unsigned int> uiNextWorker; //!< Queue the next task from outside the pool goes to.
+
+	static thread_local int s_iWorkerIndex; //!< Index of the worker running on this thread, -1 on other threads.
+
+	//! Takes a task from a worker's own queue, or steals one from another worker, returns false if every queue is empty.
+	/*!
+	* \param iWorker Index of the worker looking for a task.
+	* \param task Set to the task taken.
+	*/
+	bool takeTask(int iWorker, std::function<void()> &task);
+
+	void workerLoop(int iWorker); //!< Runs on each worker thread until the pool is destroyed.
+public:
+	//! Constructor for WorkStealingPool.
+	/*!
+	* \param iThreads Number of worker threads, 0 for one per hardware thread.
+	*/
+	explicit WorkStealingPool(int iThreads = 0);
+	~WorkStealingPool(); //!< Finishes every task, then stops the workers.
+
+	int threadCount() const { return (int)vThreads.size(); } //!< Number of worker threads.
+	static int currentWorker() { return s_iWorkerIndex; } //!< Index of the worker running on the calling thread, -1 if it isn't a worker, so tasks can keep per-worker state.
+
+	//! Queues a task to run on a worker thread.
+	/*!
+	* \param task The task, submitted from a worker it goes on that worker's own queue.
+	*/
+	void submit(std::function<void()> task);
+
+	void wait(); //!< Blocks until every task submitted so far has finished.
+};
@@ -0,0 +1,97 @@
+/*! \file aiScheduler.cpp
+* \brief Source file for the AiScheduler class.
+*
+* Contains the definitions for the AiScheduler class' constructor and methods.
+*/
+
+#include "aiScheduler.h"
+
+#include <algorithm>
+#include <cfloat>
+
+AiScheduler::AiScheduler()
+{
+	ullThinks = 0;
+	ullCoasts = 0;
+}
+
+void AiScheduler::resize(const std::vector<char> &vbNewScheduled)
+{
+	vbScheduled = vbNewScheduled;
+	int iTanks = (int)vbScheduled.size();
+	vfDistance.assign(iTanks, FLT_MAX);
+	viPeriod.assign(iTanks, 1);
+	viSinceThink.assign(iTanks, 0);
+	vbThinks.assign(iTanks, 0);
+	viWaiting.clear();
+	viWaiting.reserve(iTanks);
+}
+
+void AiScheduler::begin()
+{
+	std::fill(vfDistance.begin(), vfDistance.end(), FLT_MAX);
+}
+
+void AiScheduler::decide(unsigned int uiTick)
+{
+	int iTanks = (int)viPeriod.size();
+	int iMaxPeriod = std::max(settings.iMaxPeriod, 1);
+
+	// Tanks in contact are due every timestep, the rest on the timesteps their index staggers them to
+	viWaiting.clear();
+	for (int i = 0; i < iTanks; i++)
+	{
+		vbThinks[i] = 0;
+		if (!vbScheduled[i]) continue;
+
+		if (vfDistance[i] <= settings.fContactRange) viPeriod[i] = 1;
+		else if (vfDistance[i] <= settings.fNearRange) viPeriod[i] = std::min(2, iMaxPeriod);
+		else viPeriod[i] = iMaxPeriod;
+
+		if ((viPeriod[i] == 1) || (viSinceThink[i] >= viPeriod[i]) || ((uiTick + i) % viPeriod[i] == 0)) viWaiting.push_back(i); // Overdue, or on its staggered timestep
+	}
+
+	// Within the budget, tanks in contact go first, then the longest waiting, and the lowest index wins a tie
+	int iRoom = (int)viWaiting.size();
+	if (settings.iBudget > 0) iRoom = std::min(iRoom, settings.iBudget);
+	if (iRoom < (int)viWaiting.size())
+	{
+		std::stable_sort(viWaiting.begin(), viWaiting.end(), [this](int a, int b)
+		{
+			bool bContactA = vfDistance[a] <= settings.fContactRange;
+			bool bContactB = vfDistance[b] <= settings.fContactRange;
+			if (bContactA != bContactB) return bContactA;
+			return viSinceThink[a] > viSinceThink[b];
+		});
+	}
+	for (int n = 0; n < iRoom; n++) vbThinks[viWaiting[n]] = 1;
+
+	for (int i = 0; i < iTanks; i++)
+	{
+		if (!vbScheduled[i]) continue;
+		if (vbThinks[i])
+		{
+			viSinceThink[i] = 0;
+			ullThinks++;
+		}
+		else
+		{
+			viSinceThink[i]++;
+			ullCoasts++;
+		}
+	}
+}
+
+void AiScheduler::saveState(GameSnapshot &snapshot) const
+{
+	snapshot.write(settings);
+	snapshot.write((int)viSinceThink.size());
+	snapshot.writeBytes(viSinceThink.data(), viSinceThink.size() * sizeof(int));
+}
+
+bool AiScheduler::loadState(GameSnapshot &snapshot)
+{
+	int iTanks;
+	if (!snapshot.read(settings) || !snapshot.read(iTanks) || iTanks != (int)viSinceThink.size()) return false;
+	return snapshot.readBytes(viSinceThink.data(), viSinceThink.size() * sizeof(int));
+}
\ No newline at end of file
@@ -4,23 +4,6 @@ BoundingBox::BoundingBox() // Construtor
 {
 }
 
-BoundingBox::~BoundingBox() {} // Destructor
-
-void BoundingBox::draw(sf::RenderTarget &target, sf::RenderStates states) const // Draw BB
-{
-	sf::VertexArray box(sf::LinesStrip, 5);
-	box[0] = sf::Vertex(sf::Vector2f(x1, y1), sf::Color::White);
-	box[1] = sf::Vertex(sf::Vector2f(x1, y2), sf::Color::White);
-	box[2] = sf::Vertex(sf::Vector2f(x2, y2), sf::Color::White);
-	box[3] = sf::Vertex(sf::Vector2f(x2, y1), sf::Color::White);
-	box[4] = sf::Vertex(sf::Vector2f(x1, y1), sf::Color::White);
-	target.draw(box);
-	/*drawing.drawLine(x1,y1,x2,y1,3,sf::Color(255,0,0));
-	drawing.drawLine(x1,y1,x1,y2,3,sf::Color(255,0,0));
-	drawing.drawLine(x1,y2,x2,y2,3,sf::Color(255,0,0));
-	drawing.drawLine(x2,y1,x2,y2,3,sf::Color(255,0,0));*/
-}
-
 void BoundingBox::set(float xa, float ya, float xb, float yb)
 {
 	x1 = xa;
@@ -29,7 +12,7 @@ void BoundingBox::set(float xa, float ya, float xb, float yb)
 	y2 = yb;
 }
 
-bool BoundingBox::collision(BoundingBox otherBb) const
+bool BoundingBox::collision(const BoundingBox &otherBb) const
 {
 	bool c1 = x2 < otherBb.getX1();
 	bool c2 = otherBb.getX2() < x1;
@@ -63,4 +46,50 @@ bool BoundingBox::lineCollision(float x1l, float y1l, float x2l, float y2l) cons
 	brabove = y > y2;
 
 	return !(tlabove == trabove && tlabove == blabove && tlabove == brabove);
+}
+
+bool BoundingBox::sweptCollision(const BoundingBox &otherBb, float dx, float dy, float &time) const
+{
+	// Grow this box by half the size of the moving box, so the sweep becomes a line from the moving box's centre
+	float hw = (otherBb.getX2() - otherBb.getX1()) / 2.0f;
+	float hh = (otherBb.getY2() - otherBb.getY1()) / 2.0f;
+	float ex1 = x1 - hw;
+	float ey1 = y1 - hh;
+	float ex2 = x2 + hw;
+	float ey2 = y2 + hh;
+	float cx = otherBb.getXc();
+	float cy = otherBb.getYc();
+
+	// Clip the line against each pair of sides in turn
+	float tEnter = 0.0f;
+	float tExit = 1.0f;
+
+	if (dx == 0.0f)
+	{
+		if (cx < ex1 || cx > ex2) return false;
+	}
+	else
+	{
+		float ta = (ex1 - cx) / dx;
+		float tb = (ex2 - cx) / dx;
+		tEnter = std::max(tEnter, std::min(ta, tb));
+		tExit = std::min(tExit, std::max(ta, tb));
+		if (tEnter > tExit) return false;
+	}
+
+	if (dy == 0.0f)
+	{
+		if (cy < ey1 || cy > ey2) return false;
+	}
+	else
+	{
+		float ta = (ey1 - cy) / dy;
+		float tb = (ey2 - cy) / dy;
+		tEnter = std::max(tEnter, std::min(ta, tb));
+		tExit = std::min(tExit, std::max(ta, tb));
+		if (tEnter > tExit) return false;
+	}
+
+	time = tEnter;
+	return true;
 }
\ No newline at end of file
@@ -0,0 +1,146 @@
+/*! \file boxStore.cpp
+* \brief Source file for the BoxStore class.
+*
+* Contains the definitions for the BoxStore class' constructor and methods.
+*/
+
+#include "boxStore.h"
+
+#include <cfloat>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BOXSTORE_SSE
+#endif
+
+BoxStore::BoxStore()
+{
+	iCount = 0;
+}
+
+void BoxStore::setPadding(int i)
+{
+	// An inside out box, every comparison against it fails
+	vfX1[i] = FLT_MAX;
+	vfY1[i] = FLT_MAX;
+	vfX2[i] = -FLT_MAX;
+	vfY2[i] = -FLT_MAX;
+}
+
+void BoxStore::add(const BoundingBox &box)
+{
+	// Grow by a whole block of padding when full
+	if (iCount == (int)vfX1.size())
+	{
+		vfX1.resize(iCount + s_kiLanes);
+		vfY1.resize(iCount + s_kiLanes);
+		vfX2.resize(iCount + s_kiLanes);
+		vfY2.resize(iCount + s_kiLanes);
+		for (int i = iCount; i < iCount + s_kiLanes; i++) setPadding(i);
+	}
+
+	vfX1[iCount] = box.getX1();
+	vfY1[iCount] = box.getY1();
+	vfX2[iCount] = box.getX2();
+	vfY2[iCount] = box.getY2();
+	iCount++;
+}
+
+void BoxStore::set(int i, const BoundingBox &box)
+{
+	vfX1[i] = box.getX1();
+	vfY1[i] = box.getY1();
+	vfX2[i] = box.getX2();
+	vfY2[i] = box.getY2();
+}
+
+void BoxStore::remove(int i)
+{
+	// Shuffle the later boxes down so indexes stay in step with the obstacle lists
+	for (int j = i; j < iCount - 1; j++)
+	{
+		vfX1[j] = vfX1[j + 1];
+		vfY1[j] = vfY1[j + 1];
+		vfX2[j] = vfX2[j + 1];
+		vfY2[j] = vfY2[j + 1];
+	}
+	iCount--;
+	setPadding(iCount);
+}
+
+void BoxStore::clear()
+{
+	for (int i = 0; i < iCount; i++) setPadding(i);
+	iCount = 0;
+}
+
+BoundingBox BoxStore::get(int i) const
+{
+	BoundingBox box;
+	box.set(vfX1[i], vfY1[i], vfX2[i], vfY2[i]);
+	return box;
+}
+
+unsigned int BoxStore::collisionMask(const BoundingBox &box, int iFirst) const
+{
+	unsigned int mask = 0;
+	int iEnd = iFirst + 32;
+	if (iEnd > iCount) iEnd = iCount;
+
+	// Same test as BoundingBox::collision, boxes overlap unless one is entirely to one side of the other
+#if defined(__AVX__)
+	__m256 x1 = _mm256_set1_ps(box.getX1());
+	__m256 y1 = _mm256_set1_ps(box.getY1());
+	__m256 x2 = _mm256_set1_ps(box.getX2());
+	__m256 y2 = _mm256_set1_ps(box.getY2());
+	for (int i = iFirst; i < iEnd; i += 8)
+	{
+		__m256 hit = _mm256_and_ps(
+			_mm256_and_ps(_mm256_cmp_ps(x2, _mm256_loadu_ps(&vfX1[i]), _CMP_GE_OQ), _mm256_cmp_ps(_mm256_loadu_ps(&vfX2[i]), x1, _CMP_GE_OQ)),
+			_mm256_and_ps(_mm256_cmp_ps(y2, _mm256_loadu_ps(&vfY1[i]), _CMP_GE_OQ), _mm256_cmp_ps(_mm256_loadu_ps(&vfY2[i]), y1, _CMP_GE_OQ)));
+		mask |= (unsigned int)_mm256_movemask_ps(hit) << (i - iFirst);
+	}
+#elif defined(BOXSTORE_SSE)
+	__m128 x1 = _mm_set1_ps(box.getX1());
+	__m128 y1 = _mm_set1_ps(box.getY1());
+	__m128 x2 = _mm_set1_ps(box.getX2());
+	__m128 y2 = _mm_set1_ps(box.getY2());
+	for (int i = iFirst; i < iEnd; i += 4)
+	{
+		__m128 hit = _mm_and_ps(
+			_mm_and_ps(_mm_cmpge_ps(x2, _mm_loadu_ps(&vfX1[i])), _mm_cmpge_ps(_mm_loadu_ps(&vfX2[i]), x1)),
+			_mm_and_ps(_mm_cmpge_ps(y2, _mm_loadu_ps(&vfY1[i])), _mm_cmpge_ps(_mm_loadu_ps(&vfY2[i]), y1)));
+		mask |= (unsigned int)_mm_movemask_ps(hit) << (i - iFirst);
+	}
+#else
+	for (int i = iFirst; i < iEnd; i++)
+	{
+		bool hit = box.getX2() >= vfX1[i] && vfX2[i] >= box.getX1() && box.getY2() >= vfY1[i] && vfY2[i] >= box.getY1();
+		if (hit) mask |= 1u << (i - iFirst);
+	}
+#endif
+
+	return mask;
+}
+
+int BoxStore::firstCollision(const BoundingBox &box) const
+{
+	for (int iFirst = 0; iFirst < iCount; iFirst += 32)
+	{
+		unsigned int mask = collisionMask(box, iFirst);
+		if (mask)
+		{
+			// Lowest set bit is the first box hit
+			int i = iFirst;
+			while (!(mask & 1u))
+			{
+				mask >>= 1;
+				i++;
+			}
+			return i;
+		}
+	}
+	return -1;
+}
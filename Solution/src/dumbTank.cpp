@@ -1,4 +1,4 @@
-#include "DumbTank.h"
+#include "dumbTank.h"
 
 DumbTank::DumbTank() // Construtor
 {
@@ -15,7 +15,7 @@ void DumbTank::reset()
 
 void DumbTank::move()
 {
-	if (forward)
+	if (forwards)
 	{
 		goForward();
 		turretGoRight();
@@ -34,22 +34,22 @@ void DumbTank::collided()
 
 void DumbTank::markTarget(Position p)
 {
-	std::cout << "Target spotted at (" << p.getX() << ", " << p.getY() << ")\n";
+	if (!quiet) std::cout << "Target spotted at (" << p.getX() << ", " << p.getY() << ")\n";
 }
 
 void DumbTank::markEnemy(Position p)
 {
-	std::cout << "Enemy spotted at (" << p.getX() << ", " << p.getY() << ")\n";
+	if (!quiet) std::cout << "Enemy spotted at (" << p.getX() << ", " << p.getY() << ")\n";
 }
 
 void DumbTank::markBase(Position p)
 {
-	std::cout << "Base spotted at (" << p.getX() << ", " << p.getY() << ")\n";
+	if (!quiet) std::cout << "Base spotted at (" << p.getX() << ", " << p.getY() << ")\n";
 }
 
 void DumbTank::markShell(Position p)
 {
-	std::cout << "Shell spotted at (" << p.getX() << ", " << p.getY() << ")\n";
+	if (!quiet) std::cout << "Shell spotted at (" << p.getX() << ", " << p.getY() << ")\n";
 }
 
 bool DumbTank::isFiring()
@@ -59,5 +59,16 @@ bool DumbTank::isFiring()
 
 void DumbTank::score(int thisScore, int enemyScore)
 {
-	std::cout << "MyScore: " << thisScore << "\tEnemy score: " << enemyScore << std::endl;
+	if (!quiet) std::cout << "MyScore: " << thisScore << "\tEnemy score: " << enemyScore << std::endl;
+}
+
+void DumbTank::saveState(GameSnapshot &snapshot) const
+{
+	Tank::saveState(snapshot);
+	snapshot.write(forwards);
+}
+
+bool DumbTank::loadState(GameSnapshot &snapshot)
+{
+	return Tank::loadState(snapshot) && snapshot.read(forwards);
 }
\ No newline at end of file
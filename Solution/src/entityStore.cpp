@@ -0,0 +1,355 @@
+/*! \file entityStore.cpp
+* \brief Source file for the EntityStore class.
+*
+* Contains the definitions for the EntityStore class' constructor and methods.
+*/
+
+#include "entityStore.h"
+
+#include <algorithm>
+#include <cmath>
+
+const float EntityStore::s_kfTankHalfSize = 20.0f;
+const float EntityStore::s_kfShellHalfSize = 7.0f;
+const float EntityStore::s_kfShellSpeed = 3.0f;
+
+EntityStore::EntityStore()
+{
+	iShells = 0;
+}
+
+void EntityStore::add(const BoundingBox &box, int iTeam, unsigned int uiColour)
+{
+	boxes.add(box);
+	viTeam.push_back(iTeam);
+	vuiColour.push_back(uiColour);
+	vbVisible.push_back(0);
+
+	if (iTeam != s_kiNoTeam)
+	{
+		if (iTeam >= (int)viTeamCount.size()) viTeamCount.resize(iTeam + 1, 0);
+		viTeamCount[iTeam]++;
+	}
+}
+
+void EntityStore::add(float fX1, float fY1, float fX2, float fY2, int iTeam, unsigned int uiColour)
+{
+	BoundingBox box;
+	box.set(fX1, fY1, fX2, fY2);
+	add(box, iTeam, uiColour);
+}
+
+void EntityStore::remove(int i)
+{
+	if (viTeam[i] != s_kiNoTeam) viTeamCount[viTeam[i]]--;
+
+	boxes.remove(i);
+	viTeam.erase(viTeam.begin() + i);
+	vuiColour.erase(vuiColour.begin() + i);
+	vbVisible.erase(vbVisible.begin() + i);
+}
+
+void EntityStore::clear()
+{
+	boxes.clear();
+	viTeam.clear();
+	vuiColour.clear();
+	vbVisible.clear();
+	viTeamCount.clear();
+}
+
+int EntityStore::addTank(int iTeam, int iControl, int iSlot, int iAmmo)
+{
+	int i = tankCount();
+	vfTankX.push_back(0.f);
+	vfTankY.push_back(0.f);
+	vfTankHeading.push_back(0.f);
+	vfTankOldX.push_back(0.f);
+	vfTankOldY.push_back(0.f);
+	vfTankOldHeading.push_back(0.f);
+	vfTurret.push_back(0.f);
+	tankBoxes.add(BoundingBox());
+	viTankTeam.push_back(iTeam);
+	viHealth.push_back(0);
+	viAmmo.push_back(iAmmo);
+	viReload.push_back(0);
+	vbTankVisible.push_back(0);
+	vucControl.push_back((unsigned char)iControl);
+	viControlSlot.push_back(iSlot);
+
+	renewTank(i, iAmmo);
+	return i;
+}
+
+void EntityStore::renewTank(int i, int iAmmo)
+{
+	Position origin;
+	origin.set(0.f, 0.f, 0.f);
+	setTankPos(i, origin);
+	markTankPos(i);
+	vfTurret[i] = 0.f;
+	viHealth[i] = s_kiTankHealth;
+	viAmmo[i] = iAmmo;
+	viReload[i] = 0;
+	vbTankVisible[i] = 0;
+}
+
+void EntityStore::clearTanks()
+{
+	vfTankX.clear();
+	vfTankY.clear();
+	vfTankHeading.clear();
+	vfTankOldX.clear();
+	vfTankOldY.clear();
+	vfTankOldHeading.clear();
+	vfTurret.clear();
+	tankBoxes.clear();
+	viTankTeam.clear();
+	viHealth.clear();
+	viAmmo.clear();
+	viReload.clear();
+	vbTankVisible.clear();
+	vucControl.clear();
+	viControlSlot.clear();
+}
+
+void EntityStore::setTankBox(int i)
+{
+	BoundingBox box;
+	box.set(vfTankX[i] - s_kfTankHalfSize, vfTankY[i] - s_kfTankHalfSize, vfTankX[i] + s_kfTankHalfSize, vfTankY[i] + s_kfTankHalfSize);
+	tankBoxes.set(i, box);
+}
+
+void EntityStore::setTankPos(int i, const Position &pos)
+{
+	vfTankX[i] = pos.getX();
+	vfTankY[i] = pos.getY();
+	vfTankHeading[i] = pos.getTh();
+	setTankBox(i);
+}
+
+bool EntityStore::anyAmmo() const
+{
+	for (size_t i = 0; i < viAmmo.size(); i++)
+	{
+		if (viAmmo[i] > 0) return true;
+	}
+	return false;
+}
+
+void EntityStore::setShellCapacity(int iCapacity)
+{
+	// Every slot up front, firing only fills them in
+	vfShellX.assign(iCapacity, 0.f);
+	vfShellY.assign(iCapacity, 0.f);
+	vfShellHeading.assign(iCapacity, 0.f);
+	vfShellPrevX.assign(iCapacity, 0.f);
+	vfShellPrevY.assign(iCapacity, 0.f);
+	vfFiredX.assign(iCapacity, 0.f);
+	vfFiredY.assign(iCapacity, 0.f);
+	vfFiredHeading.assign(iCapacity, 0.f);
+	viShellTeam.assign(iCapacity, 0);
+	vbShellVisible.assign(iCapacity, 0);
+	iShells = 0;
+}
+
+bool EntityStore::fireShell(const Position &pos, int iTeam)
+{
+	// No free slots
+	if (iShells == shellCapacity()) return false;
+
+	int i = iShells++;
+	vfShellX[i] = vfShellPrevX[i] = vfFiredX[i] = pos.getX();
+	vfShellY[i] = vfShellPrevY[i] = vfFiredY[i] = pos.getY();
+	vfShellHeading[i] = vfFiredHeading[i] = pos.getTh();
+	viShellTeam[i] = iTeam;
+	vbShellVisible[i] = 0;
+	return true;
+}
+
+void EntityStore::removeShell(int i)
+{
+	iShells--;
+	if (i == iShells) return;
+
+	// Fill the gap with the last live shell
+	vfShellX[i] = vfShellX[iShells];
+	vfShellY[i] = vfShellY[iShells];
+	vfShellHeading[i] = vfShellHeading[iShells];
+	vfShellPrevX[i] = vfShellPrevX[iShells];
+	vfShellPrevY[i] = vfShellPrevY[iShells];
+	vfFiredX[i] = vfFiredX[iShells];
+	vfFiredY[i] = vfFiredY[iShells];
+	vfFiredHeading[i] = vfFiredHeading[iShells];
+	viShellTeam[i] = viShellTeam[iShells];
+	vbShellVisible[i] = vbShellVisible[iShells];
+}
+
+void EntityStore::moveShells(float fSteps)
+{
+	for (int i = 0; i < iShells; i++)
+	{
+		vfShellPrevX[i] = vfShellX[i];
+		vfShellPrevY[i] = vfShellY[i];
+
+		float thRad = DEG2RAD(vfShellHeading[i]); // Heading in radians
+		float dx = cos(thRad) * s_kfShellSpeed * fSteps;
+		float dy = sin(thRad) * s_kfShellSpeed * fSteps;
+		vfShellX[i] += dx;
+		vfShellY[i] += dy;
+	}
+}
+
+bool EntityStore::couldSeeWhenFired(int i, const BoundingBox &object) const
+{
+	float dx = object.getXc() - vfFiredX[i];
+	float dy = object.getYc() - vfFiredY[i];
+	float dist = sqrt(dx * dx + dy * dy);
+
+	if (dist > 250.0f) return false;
+	if (dist < 120.0f) return true;
+
+	float angle = atan2(dy, dx);
+	if (angle > PI) { angle = angle - 2.0f * PI; }
+	if (angle < -PI) { angle = angle + 2.0f * PI; }
+	float thRad = DEG2RAD(vfFiredHeading[i]);
+	if (thRad > PI) { thRad = thRad - 2.0f * PI; }
+	if (thRad < -PI) { thRad = thRad + 2.0f * PI; }
+	float diff = angle - thRad;
+	if (diff > PI) { diff = diff - 2.0f * PI; }
+	if (diff < -PI) { diff = diff + 2.0f * PI; }
+
+	return fabs(diff) < 0.4f;
+}
+
+BoundingBox EntityStore::sweptBounds(int i) const
+{
+	BoundingBox sweep;
+	sweep.set(std::min(vfShellPrevX[i], vfShellX[i]) - s_kfShellHalfSize, std::min(vfShellPrevY[i], vfShellY[i]) - s_kfShellHalfSize,
+		std::max(vfShellPrevX[i], vfShellX[i]) + s_kfShellHalfSize, std::max(vfShellPrevY[i], vfShellY[i]) + s_kfShellHalfSize);
+	return sweep;
+}
+
+bool EntityStore::sweptCollision(int i, const BoundingBox &object, float &fTime) const
+{
+	// Sweep the box the shell had before moving along the whole of the move
+	BoundingBox startBb;
+	startBb.set(vfShellPrevX[i] - s_kfShellHalfSize, vfShellPrevY[i] - s_kfShellHalfSize, vfShellPrevX[i] + s_kfShellHalfSize, vfShellPrevY[i] + s_kfShellHalfSize);
+
+	return object.sweptCollision(startBb, vfShellX[i] - vfShellPrevX[i], vfShellY[i] - vfShellPrevY[i], fTime);
+}
+
+// Writes the first iCount floats of each array as one block
+static void writeFloats(GameSnapshot &snapshot, const std::vector<float> &vf, int iCount)
+{
+	if (iCount > 0) snapshot.writeBytes(vf.data(), iCount * sizeof(float));
+}
+
+static bool readFloats(GameSnapshot &snapshot, std::vector<float> &vf, int iCount)
+{
+	return iCount == 0 || snapshot.readBytes(vf.data(), iCount * sizeof(float));
+}
+
+void EntityStore::saveState(GameSnapshot &snapshot) const
+{
+	int iCount = size();
+	snapshot.write(iCount);
+	for (int i = 0; i < iCount; i++)
+	{
+		BoundingBox box = boxes.get(i);
+		snapshot.write(box);
+	}
+
+	// The other components are flat arrays, so each goes in as one block
+	if (iCount > 0)
+	{
+		snapshot.writeBytes(viTeam.data(), iCount * sizeof(int));
+		snapshot.writeBytes(vuiColour.data(), iCount * sizeof(unsigned int));
+		snapshot.writeBytes(vbVisible.data(), iCount * sizeof(unsigned char));
+	}
+
+	// Tanks, whose boxes follow from their positions
+	int iTanks = tankCount();
+	snapshot.write(iTanks);
+	writeFloats(snapshot, vfTankX, iTanks);
+	writeFloats(snapshot, vfTankY, iTanks);
+	writeFloats(snapshot, vfTankHeading, iTanks);
+	writeFloats(snapshot, vfTankOldX, iTanks);
+	writeFloats(snapshot, vfTankOldY, iTanks);
+	writeFloats(snapshot, vfTankOldHeading, iTanks);
+	writeFloats(snapshot, vfTurret, iTanks);
+	if (iTanks > 0)
+	{
+		snapshot.writeBytes(viTankTeam.data(), iTanks * sizeof(int));
+		snapshot.writeBytes(viHealth.data(), iTanks * sizeof(int));
+		snapshot.writeBytes(viAmmo.data(), iTanks * sizeof(int));
+		snapshot.writeBytes(viReload.data(), iTanks * sizeof(int));
+		snapshot.writeBytes(vbTankVisible.data(), iTanks * sizeof(unsigned char));
+		snapshot.writeBytes(vucControl.data(), iTanks * sizeof(unsigned char));
+		snapshot.writeBytes(viControlSlot.data(), iTanks * sizeof(int));
+	}
+
+	// Live shells only
+	snapshot.write(iShells);
+	writeFloats(snapshot, vfShellX, iShells);
+	writeFloats(snapshot, vfShellY, iShells);
+	writeFloats(snapshot, vfShellHeading, iShells);
+	writeFloats(snapshot, vfShellPrevX, iShells);
+	writeFloats(snapshot, vfShellPrevY, iShells);
+	writeFloats(snapshot, vfFiredX, iShells);
+	writeFloats(snapshot, vfFiredY, iShells);
+	writeFloats(snapshot, vfFiredHeading, iShells);
+	if (iShells > 0)
+	{
+		snapshot.writeBytes(viShellTeam.data(), iShells * sizeof(int));
+		snapshot.writeBytes(vbShellVisible.data(), iShells * sizeof(unsigned char));
+	}
+}
+
+bool EntityStore::loadState(GameSnapshot &snapshot)
+{
+	int iCount;
+	if (!snapshot.read(iCount) || iCount < 0) return false;
+
+	clear();
+	std::vector<BoundingBox> vBoxes(iCount);
+	for (int i = 0; i < iCount; i++)
+	{
+		if (!snapshot.read(vBoxes[i])) return false;
+	}
+
+	std::vector<int> viTeams(iCount);
+	std::vector<unsigned int> vuiColours(iCount);
+	std::vector<unsigned char> vbSeen(iCount);
+	if (iCount > 0 && !(snapshot.readBytes(viTeams.data(), iCount * sizeof(int)) && snapshot.readBytes(vuiColours.data(), iCount * sizeof(unsigned int)) &&
+		snapshot.readBytes(vbSeen.data(), iCount * sizeof(unsigned char)))) return false;
+
+	// Adding them again rebuilds the packed boxes and the team counts
+	for (int i = 0; i < iCount; i++)
+	{
+		if (viTeams[i] < s_kiNoTeam) return false;
+		add(vBoxes[i], viTeams[i], vuiColours[i]);
+		vbVisible[i] = vbSeen[i];
+	}
+
+	// The tanks were built for the setup, so a snapshot with other tanks doesn't fit
+	int iTanks;
+	if (!snapshot.read(iTanks) || iTanks != tankCount()) return false;
+	if (!(readFloats(snapshot, vfTankX, iTanks) && readFloats(snapshot, vfTankY, iTanks) && readFloats(snapshot, vfTankHeading, iTanks) &&
+		readFloats(snapshot, vfTankOldX, iTanks) && readFloats(snapshot, vfTankOldY, iTanks) && readFloats(snapshot, vfTankOldHeading, iTanks) &&
+		readFloats(snapshot, vfTurret, iTanks))) return false;
+	if (iTanks > 0 && !(snapshot.readBytes(viTankTeam.data(), iTanks * sizeof(int)) && snapshot.readBytes(viHealth.data(), iTanks * sizeof(int)) &&
+		snapshot.readBytes(viAmmo.data(), iTanks * sizeof(int)) && snapshot.readBytes(viReload.data(), iTanks * sizeof(int)) &&
+		snapshot.readBytes(vbTankVisible.data(), iTanks * sizeof(unsigned char)) && snapshot.readBytes(vucControl.data(), iTanks * sizeof(unsigned char)) &&
+		snapshot.readBytes(viControlSlot.data(), iTanks * sizeof(int)))) return false;
+	for (int i = 0; i < iTanks; i++) setTankBox(i);
+
+	int iNewShells;
+	if (!snapshot.read(iNewShells) || iNewShells < 0 || iNewShells > shellCapacity()) return false;
+	if (!(readFloats(snapshot, vfShellX, iNewShells) && readFloats(snapshot, vfShellY, iNewShells) && readFloats(snapshot, vfShellHeading, iNewShells) &&
+		readFloats(snapshot, vfShellPrevX, iNewShells) && readFloats(snapshot, vfShellPrevY, iNewShells) &&
+		readFloats(snapshot, vfFiredX, iNewShells) && readFloats(snapshot, vfFiredY, iNewShells) && readFloats(snapshot, vfFiredHeading, iNewShells))) return false;
+	if (iNewShells > 0 && !(snapshot.readBytes(viShellTeam.data(), iNewShells * sizeof(int)) && snapshot.readBytes(vbShellVisible.data(), iNewShells * sizeof(unsigned char)))) return false;
+	iShells = iNewShells;
+	return true;
+}
\ No newline at end of file
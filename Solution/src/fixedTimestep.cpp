@@ -0,0 +1,67 @@
+/*! \file fixedTimestep.cpp
+* \brief Source file for the FixedTimestep class.
+*
+* Contains the definitions for the FixedTimestep class' constructor and methods.
+*/
+
+#include "fixedTimestep.h"
+
+#include <thread>
+
+FixedTimestep::FixedTimestep(float fTicksPerSecond, int iNewMaxCatchUp)
+{
+	iMaxCatchUp = iNewMaxCatchUp < 1 ? 1 : iNewMaxCatchUp;
+	bUncapped = false;
+	setTickRate(fTicksPerSecond);
+	reset();
+}
+
+void FixedTimestep::setTickRate(float fTicksPerSecond)
+{
+	if (fTicksPerSecond <= 0.f) fTicksPerSecond = 1.f;
+	tickLength = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(1.f / fTicksPerSecond));
+	if (tickLength <= Clock::duration::zero()) tickLength = Clock::duration(1);
+}
+
+void FixedTimestep::setUncapped(bool bNewUncapped)
+{
+	bUncapped = bNewUncapped;
+	reset(); // Don't carry time across the switch
+}
+
+void FixedTimestep::reset()
+{
+	accumulator = Clock::duration::zero();
+	lastTime = Clock::now();
+}
+
+int FixedTimestep::ticksDue()
+{
+	// Run a whole batch each time round the loop
+	if (bUncapped) return iMaxCatchUp;
+
+	Clock::time_point now = Clock::now();
+	accumulator += now - lastTime;
+	lastTime = now;
+
+	int iTicks = (int)(accumulator / tickLength);
+	if (iTicks > iMaxCatchUp)
+	{
+		// Too far behind to catch up, drop the rest
+		iTicks = iMaxCatchUp;
+		accumulator = Clock::duration::zero();
+	}
+	else
+	{
+		accumulator -= tickLength * iTicks;
+	}
+
+	return iTicks;
+}
+
+void FixedTimestep::waitForNextTick() const
+{
+	if (bUncapped) return;
+
+	if (accumulator < tickLength) std::this_thread::sleep_until(lastTime + (tickLength - accumulator));
+}
\ No newline at end of file
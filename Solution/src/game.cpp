@@ -1,518 +1,764 @@
 #include "game.h"
+#include "replayLog.h"
 
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
 
-Game::Game() // Constructor
-{
-	// Set Backgound
-	background.setSize(sf::Vector2f(780.0f, 570.0f));
-	background.setFillColor(sf::Color(40, 70, 20));
-	background.setPosition(10.0f, 10.0f);
 
-	ammoArea.setSize(sf::Vector2f(800.0f, 20.0f));
-	ammoArea.setFillColor(sf::Color(140, 90, 60));
-	ammoArea.setPosition(0.0f, 580.0f);
+Game::Game() : Game(Random::timeSeed()) {} // Constructor
+
+Game::Game(unsigned long long gameSeed, const GameSetup &gameSetup) // Constructor
+{
+	// Seed pseudorandom num gen, the AI tanks draw from the same one
+	seed = gameSeed;
+	rng.seed(seed);
 
-	// Seed pseudorandom num gen
-	srand((int)time(NULL));
+	setup = gameSetup;
+	if (setup.teams < 2) setup.teams = 2;
+	if (setup.tanksPerTeam < 1) setup.tanksPerTeam = 1;
+	if (setup.lookaheadTeam < 0 || setup.lookaheadTeam >= setup.teams) setup.lookaheadTeam = -1;
+	if (setup.dumbTeam < 0 || setup.dumbTeam >= setup.teams || setup.dumbTeam == setup.lookaheadTeam) setup.dumbTeam = -1;
 
 	// Set debug mode to off
 	debugMode = false;
 
+	// One game tick per timestep
+	tickScale = 1;
+
+	// Nothing played or recorded yet
+	tick = 0;
+	recording = nullptr;
+
+	// Planning is only done by lookahead tanks in a game that isn't itself a rollout
+	inRollout = false;
+	lookaheadDecisions = 0;
+	lookaheadRollouts = 0;
+	lookaheadSeconds = 0.0;
+
+	// Walls and bases
+	buildArena();
+
+	// Tanks, and room for every shell they can fire
+	createTanks();
+
+	for (int i = 0; i < numTanks(); i++) resetTank(i);
+}
+
+Game::~Game() {}  // Destructor
+
+void Game::cloneFrom(const Game &other)
+{
+	// Same setup, same tanks, so the copies below are element by element into memory this game already has
+	if (!(setup == other.setup))
+	{
+		setup = other.setup;
+		createTanks();
+	}
+
+	seed = other.seed;
+	rng = other.rng;
+	debugMode = other.debugMode;
+	tick = other.tick;
+	recording = nullptr;
+
+	entities = other.entities;
+	aiTanks = other.aiTanks;
+	lookaheadTanks = other.lookaheadTanks;
+	dumbTanks = other.dumbTanks;
+	player = other.player;
+	teamScores = other.teamScores;
+	aiSchedule = other.aiSchedule;
+	lookahead = other.lookahead;
+	setTickScale(other.tickScale);
+
+	// The copied tanks point at the other game's store, generator and team grids. The grids are rebuilt each timestep, and the tank grid from the positions
+	bindTanks();
+	for (int i = 0; i < numTanks(); i++)
+	{
+		if (tankAi(i))
+		{
+			tankAi(i)->setRandom(&rng);
+			tankAi(i)->setKnowledge(&teamKnowledge[entities.getTankTeam(i)]);
+		}
+		else if (tankDumb(i)) tankDumb(i)->setRandom(&rng);
+		placeTank(i);
+	}
+}
+
+void Game::restart(unsigned long long gameSeed)
+{
+	// Plays out exactly like a new Game with this seed and setup, but keeps every buffer the last game allocated
+	seed = gameSeed;
+	rng.seed(seed);
+
+	tick = 0;
+	recording = nullptr;
+	lookaheadDecisions = 0;
+	lookaheadRollouts = 0;
+	lookaheadSeconds = 0.0;
+
+	entities.clear();
+	buildArena();
+	entities.clearShells();
+
+	// A blank AI tank to copy over each one, its maps' memory is reused rather than freed, the tuning is kept
+	static const NewTank blank;
+	static const LookaheadTank blankLookahead;
+	static const DumbTank blankDumb;
+	for (int i = 0; i < numTanks(); i++)
+	{
+		NewTank *ai = tankAi(i);
+		if (ai)
+		{
+			NewTankParams params = ai->getParams();
+			if (tankLookahead(i)) *tankLookahead(i) = blankLookahead;
+			else *ai = blank;
+			ai->setRandom(&rng);
+			ai->setArena(setup.arenaWidth - 20.f, setup.arenaHeight - 20.f);
+			ai->setKnowledge(&teamKnowledge[entities.getTankTeam(i)]);
+			ai->setParams(params);
+		}
+		else if (tankDumb(i))
+		{
+			*tankDumb(i) = blankDumb;
+			tankDumb(i)->setRandom(&rng);
+		}
+		else player = PlayerTank();
+		tank(i)->setStepTicks(tickScale);
+		entities.renewTank(i, Tank::startingShells);
+	}
+	bindTanks();
+	for (size_t t = 0; t < teamKnowledge.size(); t++) teamKnowledge[t].clear();
+	tankMarks.assign(tankMarks.size(), -1);
+	teamScores.assign(teamScores.size(), 0);
+
+	for (int i = 0; i < numTanks(); i++) placeTank(i);
+	scheduleTanks();
+
+	for (int i = 0; i < numTanks(); i++) resetTank(i);
+}
+
+void Game::buildArena()
+{
+	float width = setup.arenaWidth;
+	float height = setup.arenaHeight;
+
 	// Borders
-	obstacles.push_back(Obstacle(0.f, 0.f, 10.f, 580.f, sf::Color(100, 100, 100)));
-	obstacles.push_back(Obstacle(0.f, 0.f, 800.f, 10.f, sf::Color(100, 100, 100)));
-	obstacles.push_back(Obstacle(0.f, 570.f, 800.f, 580.f, sf::Color(100, 100, 100)));
-	obstacles.push_back(Obstacle(790.f, 0.f, 800.f, 580.f, sf::Color(100, 100, 100)));
+	entities.add(0.f, 0.f, 10.f, height, EntityStore::s_kiNoTeam, COLOUR(100, 100, 100));
+	entities.add(0.f, 0.f, width, 10.f, EntityStore::s_kiNoTeam, COLOUR(100, 100, 100));
+	entities.add(0.f, height - 10.f, width, height, EntityStore::s_kiNoTeam, COLOUR(100, 100, 100));
+	entities.add(width - 10.f, 0.f, width, height, EntityStore::s_kiNoTeam, COLOUR(100, 100, 100));
+
+	// Bases go somewhere in each quarter of the arena
+	int halfWidth = (int)width / 2;
+	int halfHeight = (int)height / 2;
 
 	float dx, dy;
 	// Top right
-	dx = (float)(rand() % 340 + 400);
-	dy = (float)(rand() % 200 + 10);
+	dx = (float)(rng.range(halfWidth - 60) + halfWidth);
+	dy = (float)(rng.range(halfHeight - 90) + 10);
 
-	redBuildings.push_back(Obstacle(dx, dy, dx + 20.f, dy + 20.f, sf::Color(170, 60, 60)));
-	redBuildings.push_back(Obstacle(dx + 20.f, dy, dx + 40.f, dy + 20.f, sf::Color(170, 40, 40)));
-	redBuildings.push_back(Obstacle(dx, dy + 20.f, dx + 20.f, dy + 40.f, sf::Color(170, 40, 40)));
-	redBuildings.push_back(Obstacle(dx + 20.f, dy + 20.f, dx + 40.f, dy + 40.f, sf::Color(170, 60, 60)));
-	redBuildings.push_back(Obstacle(dx, dy + 40.f, dx + 20.f, dy + 60.f, sf::Color(170, 60, 60)));
-	redBuildings.push_back(Obstacle(dx + 20.f, dy + 40.f, dx + 40.f, dy + 60.f, sf::Color(170, 40, 40)));
+	entities.add(dx, dy, dx + 20.f, dy + 20.f, RED_TEAM, COLOUR(170, 60, 60));
+	entities.add(dx + 20.f, dy, dx + 40.f, dy + 20.f, RED_TEAM, COLOUR(170, 40, 40));
+	entities.add(dx, dy + 20.f, dx + 20.f, dy + 40.f, RED_TEAM, COLOUR(170, 40, 40));
+	entities.add(dx + 20.f, dy + 20.f, dx + 40.f, dy + 40.f, RED_TEAM, COLOUR(170, 60, 60));
+	entities.add(dx, dy + 40.f, dx + 20.f, dy + 60.f, RED_TEAM, COLOUR(170, 60, 60));
+	entities.add(dx + 20.f, dy + 40.f, dx + 40.f, dy + 60.f, RED_TEAM, COLOUR(170, 40, 40));
 
 	// Bottom right
-	dx = (float)(rand() % 340 + 400);
-	dy = (float)(rand() % 200 + 280);
+	dx = (float)(rng.range(halfWidth - 60) + halfWidth);
+	dy = (float)(rng.range(halfHeight - 90) + halfHeight - 10);
 
-	redBuildings.push_back(Obstacle(dx, dy, dx + 20.f, dy + 20.f, sf::Color(170, 60, 60)));
-	redBuildings.push_back(Obstacle(dx + 20.f, dy, dx + 40.f, dy + 20.f, sf::Color(170, 40, 40)));
-	redBuildings.push_back(Obstacle(dx, dy + 20.f, dx + 20.f, dy + 40.f, sf::Color(170, 40, 40)));
-	redBuildings.push_back(Obstacle(dx + 20.f, dy + 20.f, dx + 40.f, dy + 40.f, sf::Color(170, 60, 60)));
+	entities.add(dx, dy, dx + 20.f, dy + 20.f, RED_TEAM, COLOUR(170, 60, 60));
+	entities.add(dx + 20.f, dy, dx + 40.f, dy + 20.f, RED_TEAM, COLOUR(170, 40, 40));
+	entities.add(dx, dy + 20.f, dx + 20.f, dy + 40.f, RED_TEAM, COLOUR(170, 40, 40));
+	entities.add(dx + 20.f, dy + 20.f, dx + 40.f, dy + 40.f, RED_TEAM, COLOUR(170, 60, 60));
 
 	// Top left
-	dx = (float)(rand() % 340 + 10);
-	dy = (float)(rand() % 200 + 10);
+	dx = (float)(rng.range(halfWidth - 60) + 10);
+	dy = (float)(rng.range(halfHeight - 90) + 10);
 
-	blueBuildings.push_back(Obstacle(dx, dy, dx + 20, dy + 20, sf::Color(60, 60, 170)));
-	blueBuildings.push_back(Obstacle(dx + 20, dy, dx + 40, dy + 20, sf::Color(40, 40, 170)));
-	blueBuildings.push_back(Obstacle(dx, dy + 20, dx + 20, dy + 40, sf::Color(40, 40, 170)));
-	blueBuildings.push_back(Obstacle(dx + 20, dy + 20, dx + 40, dy + 40, sf::Color(60, 60, 170)));
+	entities.add(dx, dy, dx + 20, dy + 20, BLUE_TEAM, COLOUR(60, 60, 170));
+	entities.add(dx + 20, dy, dx + 40, dy + 20, BLUE_TEAM, COLOUR(40, 40, 170));
+	entities.add(dx, dy + 20, dx + 20, dy + 40, BLUE_TEAM, COLOUR(40, 40, 170));
+	entities.add(dx + 20, dy + 20, dx + 40, dy + 40, BLUE_TEAM, COLOUR(60, 60, 170));
 
 	// Bottom left
-	dx = (float)(rand() % 340 + 10);
-	dy = (float)(rand() % 200 + 280);
-
-	blueBuildings.push_back(Obstacle(dx, dy, dx + 20, dy + 20, sf::Color(60, 60, 170)));
-	blueBuildings.push_back(Obstacle(dx + 20, dy, dx + 40, dy + 20, sf::Color(40, 40, 170)));
-	blueBuildings.push_back(Obstacle(dx, dy + 20, dx + 20, dy + 40, sf::Color(40, 40, 170)));
-	blueBuildings.push_back(Obstacle(dx + 20, dy + 20, dx + 40, dy + 40, sf::Color(60, 60, 170)));
-	blueBuildings.push_back(Obstacle(dx, dy + 40, dx + 20, dy + 60, sf::Color(60, 60, 170)));
-	blueBuildings.push_back(Obstacle(dx + 20, dy + 40, dx + 40, dy + 60, sf::Color(40, 40, 170)));
+	dx = (float)(rng.range(halfWidth - 60) + 10);
+	dy = (float)(rng.range(halfHeight - 90) + halfHeight - 10);
+
+	entities.add(dx, dy, dx + 20, dy + 20, BLUE_TEAM, COLOUR(60, 60, 170));
+	entities.add(dx + 20, dy, dx + 40, dy + 20, BLUE_TEAM, COLOUR(40, 40, 170));
+	entities.add(dx, dy + 20, dx + 20, dy + 40, BLUE_TEAM, COLOUR(40, 40, 170));
+	entities.add(dx + 20, dy + 20, dx + 40, dy + 40, BLUE_TEAM, COLOUR(60, 60, 170));
+	entities.add(dx, dy + 40, dx + 20, dy + 60, BLUE_TEAM, COLOUR(60, 60, 170));
+	entities.add(dx + 20, dy + 40, dx + 40, dy + 60, BLUE_TEAM, COLOUR(40, 40, 170));
+}
 
-	resetNpc();
-	resetPlayer();
+void Game::createTanks()
+{
+	int count = setup.teams * setup.tanksPerTeam;
+	playerIndex = setup.hasPlayer ? BLUE_TEAM * setup.tanksPerTeam : -1;
+	int playerCount = setup.hasPlayer ? 1 : 0;
+
+	// Sized once, the tank pointers below point into them. The lookahead team's AI tanks, if any, are LookaheadTanks, and the dumb team's DumbTanks
+	int lookaheadCount = setup.lookaheadTeam < 0 ? 0 : setup.tanksPerTeam - (setup.lookaheadTeam == BLUE_TEAM ? playerCount : 0);
+	int dumbCount = setup.dumbTeam < 0 ? 0 : setup.tanksPerTeam - (setup.dumbTeam == BLUE_TEAM ? playerCount : 0);
+	aiTanks.clear();
+	aiTanks.resize(count - playerCount - lookaheadCount - dumbCount);
+	lookaheadTanks.clear();
+	lookaheadTanks.resize(lookaheadCount);
+	dumbTanks.clear();
+	dumbTanks.resize(dumbCount);
+
+	// One grid of sightings per team, laid out like the AI tanks' maps
+	teamKnowledge.assign(setup.teams, KnowledgeGrid());
+	NewTank *first = !aiTanks.empty() ? &aiTanks[0] : !lookaheadTanks.empty() ? &lookaheadTanks[0] : nullptr;
+	if (first)
+	{
+		first->setArena(setup.arenaWidth - 20.f, setup.arenaHeight - 20.f);
+		for (int t = 0; t < setup.teams; t++) teamKnowledge[t].setLayout(first->getMap());
+	}
+	tankMarks.assign(count, -1);
+
+	// Each tank's AI-state component says which list its controls are in, and where
+	entities.clearTanks();
+	int shellCount = 0;
+	int nextAi = 0;
+	int nextLookahead = 0;
+	int nextDumb = 0;
+	for (int i = 0; i < count; i++)
+	{
+		int team = i / setup.tanksPerTeam;
+		if (i == playerIndex) entities.addTank(team, CONTROL_PLAYER, 0, Tank::startingShells);
+		else if (team == setup.dumbTeam)
+		{
+			dumbTanks[nextDumb].setRandom(&rng);
+			entities.addTank(team, CONTROL_DUMB, nextDumb++, Tank::startingShells);
+		}
+		else
+		{
+			bool planner = team == setup.lookaheadTeam;
+			NewTank *ai = planner ? &lookaheadTanks[nextLookahead] : &aiTanks[nextAi];
+			ai->setRandom(&rng);
+			ai->setArena(setup.arenaWidth - 20.f, setup.arenaHeight - 20.f);
+			ai->setKnowledge(&teamKnowledge[team]);
+			if (planner) entities.addTank(team, CONTROL_LOOKAHEAD, nextLookahead++, Tank::startingShells);
+			else entities.addTank(team, CONTROL_STATE_MACHINE, nextAi++, Tank::startingShells);
+		}
+		tank(i)->setStepTicks(tickScale);
+		shellCount += Tank::startingShells;
+	}
+	bindTanks();
+	entities.setShellCapacity(shellCount);
+	teamScores.assign(setup.teams, 0);
+
+	// Cells a few tanks across, a vision query covers about five by five of them
+	tankGrid.setup(setup.arenaWidth, setup.arenaHeight, 128.f, 30.f, count);
+	shellGrid.setup(setup.arenaWidth, setup.arenaHeight, 128.f, EntityStore::s_kfShellHalfSize, shellCount);
+	for (int i = 0; i < count; i++) placeTank(i);
+	scheduleTanks();
+}
 
-	redScore = 0;
-	blueScore = 0;
+void Game::scheduleTanks()
+{
+	// Only the NewTanks think, the player and DumbTanks move every timestep
+	vector<char> scheduled(numTanks());
+	for (int i = 0; i < numTanks(); i++) scheduled[i] = tankAi(i) != nullptr;
+	aiSchedule.resize(scheduled);
 }
 
-Game::~Game() {}  // Destructor
+Tank *Game::tank(int i)
+{
+	switch (entities.getControl(i))
+	{
+	case CONTROL_PLAYER:
+		return &player;
+	case CONTROL_LOOKAHEAD:
+		return &lookaheadTanks[entities.getControlSlot(i)];
+	case CONTROL_DUMB:
+		return &dumbTanks[entities.getControlSlot(i)];
+	default:
+		return &aiTanks[entities.getControlSlot(i)];
+	}
+}
 
-// Set a random Position which does not collide with anything
-void Game::resetNpc()
+NewTank *Game::tankAi(int i)
 {
-	bool collision = true;
-	while (collision)
+	switch (entities.getControl(i))
 	{
-		float x = (float)(rand() % 360 + 400);
-		float y = (float)(rand() % 580 + 10);
-		float th = (float)(rand() % 359);
-		float tth = th;
-		npc.resetTank(x, y, th, tth);
-		npc.reset();
+	case CONTROL_STATE_MACHINE:
+		return &aiTanks[entities.getControlSlot(i)];
+	case CONTROL_LOOKAHEAD:
+		return &lookaheadTanks[entities.getControlSlot(i)];
+	default:
+		return nullptr;
+	}
+}
 
-		collision = false;
-		for (list<Obstacle>::iterator it = obstacles.begin(); it != obstacles.end(); ++it)
-		{
-			if (npc.bb.collision(it->bb))
-			{
-				collision = true;
-				break;
-			}
-		}
-		for (list<Obstacle>::iterator it = blueBuildings.begin(); it != blueBuildings.end(); ++it)
-		{
-			if (npc.bb.collision(it->bb))
-			{
-				collision = true;
-				break;
-			}
-		}
-		for (list<Obstacle>::iterator it = redBuildings.begin(); it != redBuildings.end(); ++it)
-		{
-			if (npc.bb.collision(it->bb))
-			{
-				collision = true;
-				break;
-			}
-		}
-		if (npc.bb.collision(player.bb)) collision = true;
+LookaheadTank *Game::tankLookahead(int i)
+{
+	return entities.getControl(i) == CONTROL_LOOKAHEAD ? &lookaheadTanks[entities.getControlSlot(i)] : nullptr;
+}
+
+DumbTank *Game::tankDumb(int i)
+{
+	return entities.getControl(i) == CONTROL_DUMB ? &dumbTanks[entities.getControlSlot(i)] : nullptr;
+}
+
+AITank *Game::anyAi(int i)
+{
+	return entities.getControl(i) == CONTROL_PLAYER ? nullptr : static_cast<AITank *>(tank(i));
+}
+
+void Game::bindTanks()
+{
+	for (int i = 0; i < numTanks(); i++) tank(i)->bind(&entities, i);
+}
+
+void Game::placeTank(int i)
+{
+	BoundingBox bb = entities.getTankBox(i);
+	tankGrid.place(i, bb.getXc(), bb.getYc());
+}
+
+bool Game::tankCollision(int i)
+{
+	BoundingBox bb = entities.getTankBox(i);
+	tankGrid.query(bb, nearby);
+	for (size_t n = 0; n < nearby.size(); n++)
+	{
+		if (nearby[n] != i && bb.collision(entities.getTankBox(nearby[n]))) return true;
 	}
+	return false;
 }
 
 // Set a random Position which does not collide with anything
-void Game::resetPlayer()
+void Game::resetTank(int i)
 {
+	// Each team spawns in its own strip of the arena, blue on the left and red on the right
+	int team = entities.getTankTeam(i);
+	int strip = team == BLUE_TEAM ? 0 : team == RED_TEAM ? setup.teams - 1 : team - 1;
+	int stripWidth = ((int)setup.arenaWidth - 20) / setup.teams;
+	int left = 10 + strip * stripWidth;
+	int range = min(stripWidth - 10, (int)setup.arenaWidth - 40 - left);
+
 	bool collision = true;
 	while (collision)
 	{
-		float x = (float)(rand() % 380 + 10);
-		float y = (float)(rand() % 580 + 10);
-		float th = (float)(rand() % 359);
+		float x = (float)(rng.range(range) + left);
+		float y = (float)(rng.range((int)setup.arenaHeight) + 10);
+		float th = (float)(rng.range(359));
 		float tth = th;
-		player.resetTank(x, y, th, tth);
-		player.reset();
+		tank(i)->resetTank(x, y, th, tth);
+		if (anyAi(i)) anyAi(i)->reset();
+		else player.reset();
 
-		collision = false;
-		for (list<Obstacle>::iterator it = obstacles.begin(); it != obstacles.end(); ++it)
-		{
-			if (player.bb.collision(it->bb))
-			{
-				collision = true;
-				break;
-			}
-		}
-		for (list<Obstacle>::iterator it = blueBuildings.begin(); it != blueBuildings.end(); ++it)
-		{
-			if (player.bb.collision(it->bb))
-			{
-				collision = true;
-				break;
-			}
-		}
-		for (list<Obstacle>::iterator it = redBuildings.begin(); it != redBuildings.end(); ++it)
-		{
-			if (player.bb.collision(it->bb))
-			{
-				collision = true;
-				break;
-			}
-		}
-		if (player.bb.collision(npc.bb)) collision = true;
+		collision = sceneryCollision(entities.getTankBox(i)) || tankCollision(i);
 	}
+	entities.repairTank(i);
+	placeTank(i);
 }
 
-void Game::play()// Play the game for one timestep
+void Game::award(int team, int victimTeam, int points)
 {
-	// Move tank
-	player.markPos();
-	player.move();
-
-	// Check for collisions
-	bool collision = false;
-	for (list<Obstacle>::iterator it = obstacles.begin(); it != obstacles.end(); ++it)
+	if (team != victimTeam)
 	{
-		if (player.bb.collision(it->bb))
-		{
-			collision = true;
-			break;
-		}
+		teamScores[team] += points;
+		return;
 	}
-	for (list<Obstacle>::iterator it = blueBuildings.begin(); it != blueBuildings.end(); ++it)
+	for (int t = 0; t < setup.teams; t++)
 	{
-		if (player.bb.collision(it->bb))
-		{
-			collision = true;
-			break;
-		}
+		if (t != victimTeam) teamScores[t] += points;
 	}
-	for (list<Obstacle>::iterator it = redBuildings.begin(); it != redBuildings.end(); ++it)
+}
+
+void Game::reportScores()
+{
+	// The first red tank prints the scores, rollouts are played out of sight so never do
+	if (inRollout) return;
+	if (anyAi(0)) anyAi(0)->score(teamScores[RED_TEAM], teamScores[BLUE_TEAM]);
+}
+
+void Game::play()// Play the game for one timestep
+{
+	// Lookahead tanks whose first action has run out plan before anything moves, so each rollout starts from a whole timestep. A rollout's tanks only follow what they were given
+	if (!inRollout && !lookaheadTanks.empty())
 	{
-		if (player.bb.collision(it->bb))
+		for (int i = 0; i < numTanks(); i++)
 		{
-			collision = true;
-			break;
+			if (tankLookahead(i) && tankLookahead(i)->needsPlan()) planLookahead(i);
 		}
 	}
-	if (player.bb.collision(npc.bb)) collision = true;
-
-	if (collision)player.recallPos();
 
-
-	// Move AI tank
-	npc.markPos();
-	npc.move();
-	npc.implementMove();
-	if (npc.isFiring()) { fireShell(npc.firingPosition(), true); }
-
-	// Check for collisions
-	collision = false;
-	for (list<Obstacle>::iterator it = obstacles.begin(); it != obstacles.end(); ++it)
+	// Move tank
+	if (playerIndex >= 0)
 	{
-		if (npc.bb.collision(it->bb))
-		{
-			collision = true;
-			break;
-		}
+		player.markPos();
+		player.move();
+
+		// Check for collisions
+		if (sceneryCollision(player.getBb()) || tankCollision(playerIndex)) player.recallPos();
+		placeTank(playerIndex);
 	}
-	for (list<Obstacle>::iterator it = blueBuildings.begin(); it != blueBuildings.end(); ++it)
+
+	// AI tanks decide how to move, their moves only depend on what they saw last timestep so all of them can decide before any move
+	// Tanks away from any enemy only think some timesteps, and coast on their last decision in between
+	scheduleAi();
+	for (int i = 0; i < numTanks(); i++)
 	{
-		if (npc.bb.collision(it->bb))
+		DumbTank *dumb = tankDumb(i);
+		if (dumb)
 		{
-			collision = true;
-			break;
+			dumb->markPos();
+			dumb->move();
+			continue;
 		}
+
+		NewTank *ai = tankAi(i);
+		if (!ai) continue;
+
+		LookaheadTank *planner = tankLookahead(i);
+		ai->markPos();
+		if (aiSchedule.thinks(i)) ai->move();
+		else ai->coast();
+		if (planner) planner->advance(tickScale);
 	}
-	for (list<Obstacle>::iterator it = redBuildings.begin(); it != redBuildings.end(); ++it)
+
+	// Move AI tanks, in index order so each collides with the tanks before it in their new places and the tanks after it in their old ones
+	for (int i = 0; i < numTanks(); i++)
 	{
-		if (npc.bb.collision(it->bb))
+		AITank *ai = anyAi(i);
+		if (!ai) continue;
+
+		ai->implementMove();
+		if (ai->isFiring()) fireShell(i);
+
+		// Check for collisions
+		if (sceneryCollision(entities.getTankBox(i)) || tankCollision(i))
 		{
-			collision = true;
-			break;
+			ai->recallPos();
+			ai->collided();
 		}
+		placeTank(i);
 	}
-	if (npc.bb.collision(player.bb)) collision = true;
 
-	if (collision)
+	// Shells by position, for vision
+	shellGrid.clear();
+	for (int i = 0; i < entities.shellCount(); i++)
 	{
-		npc.recallPos();
-		npc.collided();
+		BoundingBox bb = entities.getShellBox(i);
+		shellGrid.place(i, bb.getXc(), bb.getYc());
 	}
 
-	// Check if AI Tank can see anything
-	for (list<Obstacle>::iterator it = redBuildings.begin(); it != redBuildings.end(); ++it)
-	{
-		if (npc.canSee(it->bb)) npc.markBase(Position((it->bb.getX1() + it->bb.getX2()) / 2.0f, (it->bb.getY1() + it->bb.getY2()) / 2.0f));
-	}
-	for (list<Obstacle>::iterator it = blueBuildings.begin(); it != blueBuildings.end(); ++it)
-	{
-		if (npc.canSee(it->bb)) npc.markTarget(Position((it->bb.getX1() + it->bb.getX2()) / 2.0f, (it->bb.getY1() + it->bb.getY2()) / 2.0f));
-	}
-	for (list<Shell>::iterator it = shells.begin(); it != shells.end(); ++it)
+	// Check if AI Tanks can see anything, each team marks what its tanks see into one grid and each building or tank only once. DumbTanks drive blind
+	for (int t = 0; t < setup.teams; t++) teamKnowledge[t].clear();
+	buildingMarks.assign(entities.size(), -1);
+	std::fill(tankMarks.begin(), tankMarks.end(), -1);
+	for (int i = 0; i < numTanks(); i++)
 	{
-		if (npc.canSee(it->bb) && !it->isNpc()) npc.markShell(Position((it->bb.getX1() + it->bb.getX2()) / 2.0f, (it->bb.getY1() + it->bb.getY2()) / 2.0f));
-	}
-	if (npc.canSee(player.bb)) npc.markEnemy(Position((player.bb.getX1() + player.bb.getX2()) / 2.0f, (player.bb.getY1() + player.bb.getY2()) / 2.0f));
-
-	// Move shells
-	for (list<Shell>::iterator it = shells.begin(); it != shells.end(); ++it) { it->move(); }
-
-	// Check if shells have hit anything
+		NewTank *ai = tankAi(i);
+		if (!ai) continue;
+		int team = entities.getTankTeam(i);
 
-	// Have shells hit edges
-	for (list<Obstacle>::iterator it = obstacles.begin(); it != obstacles.end(); ++it)
-	{
-		for (list<Shell>::iterator it2 = shells.begin(); it2 != shells.end(); it2++)
+		for (int e = 0; e < entities.size(); e++)
 		{
-			if (it->bb.collision(it2->bb))
+			if (!entities.isBuilding(e)) continue;
+			BoundingBox bb = entities.getBox(e);
+			if (!ai->canSee(bb)) continue;
+			Position p(bb.getXc(), bb.getYc());
+			bool marked = buildingMarks[e] == team;
+			buildingMarks[e] = team;
+			if (entities.getTeam(e) == team)
 			{
-				shells.erase(it2);
-				break;
+				if (!marked) ai->markBase(p);
 			}
+			else if (!marked) ai->markTarget(p);
+			else ai->spotTarget(p);
 		}
-	}
-	// Second check
-	for (list<Shell>::iterator it2 = shells.begin(); it2 != shells.end(); it2++)
-	{
-		if (fabs(it2->getY()) > 1000)
+
+		// Only things within view range can be seen
+		BoundingBox me = entities.getTankBox(i);
+		BoundingBox view;
+		view.set(me.getXc() - 250.f, me.getYc() - 250.f, me.getXc() + 250.f, me.getYc() + 250.f);
+
+		shellGrid.query(view, nearby);
+		for (size_t n = 0; n < nearby.size(); n++)
 		{
-			shells.erase(it2);
-			break;
+			int s = nearby[n];
+			if (entities.getShellTeam(s) == team) continue;
+			BoundingBox bb = entities.getShellBox(s);
+			if (ai->canSee(bb))
+			{
+				// Centre and heading, so the tank can work out where the shell is going
+				Position p;
+				p.set((bb.getX1() + bb.getX2()) / 2.0f, (bb.getY1() + bb.getY2()) / 2.0f, entities.getShellPos(s).getTh());
+				ai->markShell(p);
+			}
 		}
-		if (fabs(it2->getX()) > 1200)
+
+		tankGrid.query(view, nearby);
+		for (size_t n = 0; n < nearby.size(); n++)
 		{
-			shells.erase(it2);
-			break;
+			BoundingBox other = entities.getTankBox(nearby[n]);
+			if (entities.getTankTeam(nearby[n]) == team || !ai->canSee(other)) continue;
+			Position p((other.getX1() + other.getX2()) / 2.0f, (other.getY1() + other.getY2()) / 2.0f);
+			if (tankMarks[nearby[n]] == team) ai->spotEnemy(p);
+			else ai->markEnemy(p);
+			tankMarks[nearby[n]] = team;
 		}
 	}
 
-	// Have shells hit red buildings
-	bool stop = false;
-	list<Obstacle>::iterator it = redBuildings.begin();
-	while (!(stop || it == redBuildings.end()))
+	// Every tank in a team takes in everything the team saw
+	for (int i = 0; i < numTanks(); i++)
 	{
+		if (tankAi(i)) tankAi(i)->mergeKnowledge();
+	}
 
-		list<Shell>::iterator it2 = shells.begin();
-		while (!(stop || it2 == shells.end()))
-		{
-			if (it->bb.collision(it2->bb) && (it2->couldSeeWhenFired(it->bb) || it->isVisible()))
-			{
-				shells.erase(it2);
-				redBuildings.erase(it);
-				blueScore += 10;
-				npc.score(redScore, blueScore);
-				stop = true;
-			}
-			else it2++;
-		}
+	// Move shells
+	entities.moveShells((float)tickScale);
 
-		if (!stop)++it;
-	}
+	// Shells past this have escaped the arena
+	float limitX = setup.arenaWidth + 400.f;
+	float limitY = setup.arenaHeight + 420.f;
 
-	// Have shells hit blue buildings
-	stop = false;
-	it = blueBuildings.begin();
-	while (!(stop || it == blueBuildings.end()))
+	// Check if shells have hit anything, each shell stops at the first thing it meets along its path
+	int sh = 0;
+	while (sh < entities.shellCount())
 	{
+		enum { NOTHING, EDGE, BUILDING, TANK } hit = NOTHING;
+		int hitBuilding = -1; // Index of the building hit
+		int hitTank = -1; // Index of the tank hit
+		float firstTime = 2.0f; // Time of impact of the closest hit so far
+		float hitTime;
+
+		// Only boxes overlapping the area the shell moved through need the full swept test
+		BoundingBox sweep = entities.sweptBounds(sh);
 
-		list<Shell>::iterator it2 = shells.begin();
-		while (!(stop || it2 == shells.end()))
+		// Have shells hit walls or buildings, buildings only once someone has seen them
+		const BoxStore &boxes = entities.getBoxes();
+		for (int first = 0; first < boxes.size(); first += 32)
 		{
-			if (it->bb.collision(it2->bb) && (it2->couldSeeWhenFired(it->bb) || it->isVisible()))
+			unsigned int mask = boxes.collisionMask(sweep, first);
+			for (int i = first; mask; i++, mask >>= 1)
 			{
-				shells.erase(it2);
-				blueBuildings.erase(it);
-				redScore += 10;
-				npc.score(redScore, blueScore);
-				stop = true;
+				if (!(mask & 1u)) continue;
+				BoundingBox bb = boxes.get(i);
+				if (!entities.sweptCollision(sh, bb, hitTime) || hitTime >= firstTime) continue;
+				if (!entities.isBuilding(i))
+				{
+					hit = EDGE;
+					firstTime = hitTime;
+				}
+				else if (entities.couldSeeWhenFired(sh, bb) || entities.isVisible(i))
+				{
+					hit = BUILDING;
+					hitBuilding = i;
+					firstTime = hitTime;
+				}
 			}
-			else it2++;
 		}
 
-		if (!stop)++it;
-	}
-
-	// Have shells hit red tank
-	stop = false;
-	list<Shell>::iterator it2 = shells.begin();
-	while (!(stop || it2 == shells.end()))
-	{
-		if (it2->couldSeeWhenFired(npc.bb) && npc.bb.collision(it2->bb))
+		// Have shells hit tanks, the grid gives them in index order so ties go to the lowest index
+		tankGrid.query(sweep, nearby);
+		for (size_t n = 0; n < nearby.size(); n++)
 		{
-			shells.erase(it2);
-			resetNpc();
-			blueScore += 25;
-			npc.score(redScore, blueScore);
-			stop = true;
+			BoundingBox bb = entities.getTankBox(nearby[n]);
+			if (entities.couldSeeWhenFired(sh, bb) && entities.sweptCollision(sh, bb, hitTime) && hitTime < firstTime)
+			{
+				hit = TANK;
+				hitTank = nearby[n];
+				firstTime = hitTime;
+			}
 		}
-		else it2++;
-	}
-
 
-	// Have shells hit BLUE tank
-	stop = false;
-
-	it2 = shells.begin();
-	while (!(stop || it2 == shells.end()))
-	{
-		if (it2->couldSeeWhenFired(player.bb) && player.bb.collision(it2->bb))
+		switch (hit)
 		{
-			shells.erase(it2);
-			resetPlayer();
-			redScore += 25;
-			npc.score(redScore, blueScore);
-			stop = true;
+		case BUILDING:
+			award(entities.getShellTeam(sh), entities.getTeam(hitBuilding), 10);
+			entities.remove(hitBuilding);
+			reportScores();
+			break;
+		case TANK:
+			// Destroyed tanks come back in their own side of the arena
+			if (!entities.damageTank(hitTank)) break;
+			resetTank(hitTank);
+			award(entities.getShellTeam(sh), entities.getTankTeam(hitTank), 25);
+			reportScores();
+			break;
+		default: // Walls and misses score nothing
+			break;
 		}
-		else it2++;
-	}
 
-	for (list<Obstacle>::iterator it = redBuildings.begin(); it != redBuildings.end(); ++it)
-	{
-		if (player.canSee(it->bb)) it->setVisible();
-	}
+		// Second check, shells that have left the arena
+		if (hit == NOTHING)
+		{
+			Position p = entities.getShellPos(sh);
+			if (fabs(p.getY()) > limitY || fabs(p.getX()) > limitX) hit = EDGE;
+		}
 
-	for (list<Obstacle>::iterator it = blueBuildings.begin(); it != blueBuildings.end(); ++it)
-	{
-		if (player.canSee(it->bb)) it->setVisible();
+		if (hit == NOTHING) sh++;
+		else entities.removeShell(sh); // The last shell moves into this slot, so check this index again
 	}
-	if (player.canSee(npc.bb)) { npc.setVisible(); }
-	else { npc.setInvisible(); }
 
-	for (list<Shell>::iterator it = shells.begin(); it != shells.end(); ++it)
+	// Buildings the player has seen can be hit, and AI tanks and shells are shown while the player can see them
+	if (playerIndex >= 0)
 	{
-		if (player.canSee(it->bb)) it->setVisible();
-	}
-
-}
+		for (int e = 0; e < entities.size(); e++)
+		{
+			if (entities.isBuilding(e) && player.canSee(entities.getBox(e))) entities.setVisible(e);
+		}
 
-void Game::fireShell(Position fp, bool isNpc)
-{
-	Position shellPos = fp;
-	Shell newShell(fp, isNpc);
-	bool ai = false;
-	bool tank = false;
-	bool canFire = false;
-	// Sort out visibility
-	if (isNpc)
-	{
-		if (npc.canFire())
+		for (int i = 0; i < numTanks(); i++) entities.setTankVisible(i, false);
+		BoundingBox me = player.getBb();
+		BoundingBox view;
+		view.set(me.getXc() - 250.f, me.getYc() - 250.f, me.getXc() + 250.f, me.getYc() + 250.f);
+		tankGrid.query(view, nearby);
+		for (size_t n = 0; n < nearby.size(); n++)
 		{
-			npc.fireShell();
-			canFire = true;
+			if (nearby[n] != playerIndex && player.canSee(entities.getTankBox(nearby[n]))) entities.setTankVisible(nearby[n], true);
 		}
-	}
-	else
-	{
-		if (player.canFire())
+
+		for (int i = 0; i < entities.shellCount(); i++)
 		{
-			player.fireShell();
-			canFire = true;
+			if (player.canSee(entities.getShellBox(i))) entities.setShellVisible(i);
 		}
 	}
 
-	if (canFire)shells.push_back(newShell);
+	tick++;
+	if (recording) recording->timestepPlayed(*this);
 }
 
-void Game::draw(sf::RenderTarget &target, sf::RenderStates states) const// Draw the game
+void Game::planLookahead(int i)
 {
-	target.draw(background);
-
-	target.draw(ammoArea);
-
-	// Draw shells
-	for (list<Shell>::const_iterator it = shells.begin(); it != shells.end(); ++it)
-	{
-		if (it->isVisible() || debugMode)  target.draw(*it);
-	}
-
-	// Draw obstacles
-	for (list<Obstacle>::const_iterator it = obstacles.begin(); it != obstacles.end(); ++it)
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	if (!rollout)
 	{
-		target.draw(*it);
+		rollout.reset(new Game(seed, setup));
+		rollout->inRollout = true;
 	}
 
-	// Draw Red Buildings
-	for (list<Obstacle>::const_iterator it = redBuildings.begin(); it != redBuildings.end(); ++it)
-	{
-		if (it->isVisible() || debugMode) target.draw(*it);
-	}
+	// The first action of each rollout takes each action in turn, the rest are drawn from a generator of their own, so planning never touches the game's
+	Random sampler(seed + (unsigned long long)tick * 1000003ULL + (unsigned long long)i);
+	double totals[LookaheadTank::ACTIONS] = { 0.0 };
+	int counts[LookaheadTank::ACTIONS] = { 0 };
+	int steps = std::max(1, lookahead.iHorizon / lookahead.iRolloutScale);
+	int team = entities.getTankTeam(i);
 
-	// Draw blue buildings
-	for (list<Obstacle>::const_iterator it = blueBuildings.begin(); it != blueBuildings.end(); ++it)
+	int rollouts = 0;
+	while (rollouts < lookahead.iMaxRollouts)
 	{
-		if (it->isVisible() || debugMode) target.draw(*it);
-	}
+		// At least one rollout, of the state machine's own choice, so running out of time falls back on it
+		if (lookahead.iBudget > 0 && rollouts > 0 &&
+			std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count() >= lookahead.iBudget) break;
 
-	// Draw AITank
-	if (npc.isVisible() || debugMode) target.draw(npc);
+		unsigned char plan[LookaheadTank::s_kiMaxDepth];
+		plan[0] = (unsigned char)(rollouts % LookaheadTank::ACTIONS);
+		for (int k = 1; k < lookahead.iDepth; k++) plan[k] = (unsigned char)sampler.range(LookaheadTank::ACTIONS);
 
-	// Draw Player
-	target.draw(player);
+		rollout->cloneFrom(*this);
+		rollout->setTickScale((unsigned short)lookahead.iRolloutScale);
+		rollout->tankLookahead(i)->setPlan(plan, lookahead.iDepth, lookahead.iActionTicks);
+		int before = rollout->scoreMargin(team);
+		for (int n = 0; n < steps && !rollout->gameOver(); n++) rollout->play();
 
-	// Draw ammo
-	sf::RectangleShape ammo(sf::Vector2f(5, 10));
-	ammo.setFillColor(sf::Color(0, 0, 255));
-	for (int i = 0; i < player.getNumberOfShells(); i++)
-	{
-		ammo.setPosition((float)i * 15 + 10, 585.f);
-		target.draw(ammo);
+		totals[plan[0]] += rollout->scoreMargin(team) - before;
+		counts[plan[0]]++;
+		rollouts++;
 	}
 
-	ammo.setFillColor(sf::Color(255, 0, 0));
-	for (int i = 0; i < npc.getNumberOfShells(); i++)
+	// Best average, ties go to the lowest action so the state machine wins when nothing does better
+	int best = LookaheadTank::POLICY;
+	for (int a = 1; a < LookaheadTank::ACTIONS; a++)
 	{
-		ammo.setPosition((float)790 - i * 15, 585.f);
-		target.draw(ammo);
+		if (counts[a] > 0 && (counts[best] == 0 || totals[a] / counts[a] > totals[best] / counts[best])) best = a;
 	}
+	unsigned char chosen = (unsigned char)best;
+	tankLookahead(i)->setPlan(&chosen, 1, lookahead.iActionTicks);
 
-	// Draw scores
-	sf::Font font;
-	font.loadFromFile("C:\\Windows\\Fonts\\arial.ttf");
-	char msg[255];
-	sprintf_s(msg, "%d", blueScore);
-	sf::Text drawingText(sf::String(msg), font, 18);
-	drawingText.setColor(sf::Color::White);
+	lookaheadDecisions++;
+	lookaheadRollouts += rollouts;
+	lookaheadSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
 
-	drawingText.setPosition(250, 577);
-	target.draw(drawingText);
+int Game::scoreMargin(int team) const
+{
+	int best = INT_MIN;
+	for (int t = 0; t < setup.teams; t++)
+	{
+		if (t != team) best = std::max(best, teamScores[t]);
+	}
+	return teamScores[team] - best;
+}
 
-	sprintf_s(msg, "%d", redScore);
-	drawingText.setString(sf::String(msg));
-	drawingText.setPosition(550, 577);
-	target.draw(drawingText);
+void Game::scheduleAi()
+{
+	aiSchedule.begin();
 
-	// Draw game over
-	if (gameOver())
+	// With every tank thinking every timestep and no budget, distances don't matter
+	const AiScheduleSettings &settings = aiSchedule.getSettings();
+	if (settings.iMaxPeriod > 1 || settings.iBudget > 0)
 	{
-		sprintf_s(msg, "GAME OVER", blueScore);
-		sf::Text drawingText(sf::String(msg), font, 42);
-		drawingText.setPosition(300, 140);
-		target.draw(drawingText);
-		drawingText.setPosition(300, 240);
-		if (redScore > blueScore)
+		// Nearest enemy tank, looking no further than the range that changes the think rate
+		float range = std::max(settings.fContactRange, settings.fNearRange);
+		for (int i = 0; i < numTanks(); i++)
 		{
-			sprintf_s(msg, "RED WINS!", blueScore);
-			drawingText.setString(sf::String(msg));
-		}
-		if (redScore < blueScore)
-		{
-			sprintf_s(msg, "BLUE WINS!", blueScore);
-			drawingText.setString(sf::String(msg));
+			if (!tankAi(i)) continue;
+			BoundingBox bb = entities.getTankBox(i);
+			BoundingBox area;
+			area.set(bb.getXc() - range, bb.getYc() - range, bb.getXc() + range, bb.getYc() + range);
+			tankGrid.query(area, nearby);
+			for (size_t n = 0; n < nearby.size(); n++)
+			{
+				if (entities.getTankTeam(nearby[n]) == entities.getTankTeam(i)) continue;
+				BoundingBox other = entities.getTankBox(nearby[n]);
+				float dx = other.getXc() - bb.getXc();
+				float dy = other.getYc() - bb.getYc();
+				aiSchedule.nearEnemy(i, std::sqrt(dx * dx + dy * dy));
+			}
 		}
-		if (redScore == blueScore)
+
+		// Enemy shells within contact range, found from the shells as there are usually far fewer of them than tanks
+		for (int s = 0; s < entities.shellCount(); s++)
 		{
-			sprintf_s(msg, "MATCH DRAW!", blueScore);
-			drawingText.setString(sf::String(msg));
+			BoundingBox bb = entities.getShellBox(s);
+			BoundingBox area;
+			area.set(bb.getXc() - settings.fContactRange, bb.getYc() - settings.fContactRange, bb.getXc() + settings.fContactRange, bb.getYc() + settings.fContactRange);
+			tankGrid.query(area, nearby);
+			for (size_t n = 0; n < nearby.size(); n++)
+			{
+				if (!tankAi(nearby[n]) || entities.getTankTeam(nearby[n]) == entities.getShellTeam(s)) continue;
+				BoundingBox other = entities.getTankBox(nearby[n]);
+				float dx = bb.getXc() - other.getXc();
+				float dy = bb.getYc() - other.getYc();
+				aiSchedule.nearEnemy(nearby[n], std::sqrt(dx * dx + dy * dy));
+			}
 		}
-		target.draw(drawingText);
 	}
+
+	aiSchedule.decide(tick);
+}
+
+void Game::fireShell(int i)
+{
+	Tank *shooter = tank(i);
+	if (!shooter->canFire()) return;
+
+	Position fp = shooter->firingPosition();
+	shooter->fireShell();
+	entities.fireShell(fp, entities.getTankTeam(i));
 }
 
 void Game::keyPressed(sf::Keyboard::Key key)
 {
+	if (recording) recording->addKey(tick, key, true);
+
 	switch (key)
 	{
 	case	sf::Keyboard::Tab:
 		debugMode = !debugMode;
-		player.toggleDebugMode();
-		npc.toggleDebugMode();
-		for (list<Shell>::iterator it = shells.begin(); it != shells.end(); ++it) { it->toggleDebugMode(); }
 		break;
 	case  sf::Keyboard::W:
 		player.goForward();
@@ -527,10 +773,10 @@ void Game::keyPressed(sf::Keyboard::Key key)
 		player.goRight();
 		break;
 	case	sf::Keyboard::Space:
-		if (player.canFire())
+		if (playerIndex >= 0 && player.canFire())
 		{
 			player.fire();
-			fireShell(player.firingPosition(), false);
+			fireShell(playerIndex);
 		}
 		break;
 	case  sf::Keyboard::Left:
@@ -544,6 +790,8 @@ void Game::keyPressed(sf::Keyboard::Key key)
 
 void Game::keyReleased(sf::Keyboard::Key key)
 {
+	if (recording) recording->addKey(tick, key, false);
+
 	switch (key)
 	{
 	case  sf::Keyboard::W:
@@ -567,17 +815,131 @@ void Game::keyReleased(sf::Keyboard::Key key)
 	}
 }
 
+void Game::setTickScale(unsigned short ticks)
+{
+	tickScale = ticks;
+	for (int i = 0; i < numTanks(); i++) tank(i)->setStepTicks(ticks);
+}
+
+bool Game::sceneryCollision(const BoundingBox &bb) const
+{
+	return entities.getBoxes().collision(bb);
+}
+
+size_t Game::simulationBytes() const
+{
+	// The game itself holds the player's controls, the AI tanks hold their maps
+	size_t bytes = sizeof(Game);
+	bytes += aiTanks.size() * sizeof(NewTank) + lookaheadTanks.size() * sizeof(LookaheadTank) + dumbTanks.size() * sizeof(DumbTank);
+	bytes += numTanks() * sizeof(int) * 3;
+
+	// The tanks', shells', walls' and buildings' components
+	bytes += numTanks() * (11 * sizeof(float) + 5 * sizeof(int) + 2 * sizeof(unsigned char));
+	bytes += entities.shellCapacity() * (8 * sizeof(float) + sizeof(int) + sizeof(unsigned char));
+	bytes += entities.size() * (4 * sizeof(float) + sizeof(int) + sizeof(unsigned int) + sizeof(unsigned char));
+
+	return bytes;
+}
+
+void Game::setTeamParams(int team, const NewTankParams &params)
+{
+	for (int i = 0; i < numTanks(); i++)
+	{
+		if (tankAi(i) && entities.getTankTeam(i) == team) tankAi(i)->setParams(params);
+	}
+}
+
+void Game::setLookahead(const LookaheadSettings &settings)
+{
+	lookahead = settings;
+	lookahead.iHorizon = std::max(0, lookahead.iHorizon);
+	lookahead.iActionTicks = std::max(1, lookahead.iActionTicks);
+	lookahead.iDepth = std::min(std::max(1, lookahead.iDepth), (int)LookaheadTank::s_kiMaxDepth);
+	lookahead.iRolloutScale = std::max(1, lookahead.iRolloutScale);
+	lookahead.iBudget = std::max(0, lookahead.iBudget);
+	lookahead.iMaxRollouts = std::max(1, lookahead.iMaxRollouts);
+}
+
+void Game::setRecording(ReplayLog *log)
+{
+	recording = log;
+}
+
 bool Game::gameOver() const
 {
-	return numBlueBuildings() == 0 || numRedBuildings() == 0 || (!(player.hasAmmo() || npc.hasAmmo()) && shells.empty());
+	if (numBlueBuildings() == 0 || numRedBuildings() == 0) return true;
+	return entities.shellCount() == 0 && !entities.anyAmmo();
 }
 
 int Game::numBlueBuildings() const
 {
-	return blueBuildings.size();
+	return entities.buildingsLeft(BLUE_TEAM);
 }
 
 int Game::numRedBuildings() const
 {
-	return redBuildings.size();
+	return entities.buildingsLeft(RED_TEAM);
+}
+
+// Snapshots start with a tag and version, so a stale or foreign buffer is rejected
+static const unsigned int snapshotMagic = 0x53535754; // "TWSS"
+static const unsigned int snapshotVersion = 14;
+
+void Game::saveSnapshot(GameSnapshot &snapshot) const
+{
+	snapshot.clear();
+	snapshot.write(snapshotMagic);
+	snapshot.write(snapshotVersion);
+
+	// Field by field, so the setup's padding never reaches the snapshot
+	snapshot.write(setup.teams);
+	snapshot.write(setup.tanksPerTeam);
+	snapshot.write(setup.arenaWidth);
+	snapshot.write(setup.arenaHeight);
+	snapshot.write(setup.lookaheadTeam);
+	snapshot.write(setup.hasPlayer);
+	snapshot.write(setup.dumbTeam);
+	snapshot.write(seed);
+	snapshot.write(rng);
+	snapshot.write(debugMode);
+	snapshot.write(tickScale);
+	snapshot.write(tick);
+	snapshot.writeBytes(teamScores.data(), teamScores.size() * sizeof(int));
+
+	entities.saveState(snapshot);
+
+	// The tanks' controls, everything else about them is in the store
+	for (int i = 0; i < numTanks(); i++) getTank(i).saveState(snapshot);
+	aiSchedule.saveState(snapshot);
+	snapshot.write(lookahead);
+}
+
+bool Game::loadSnapshot(GameSnapshot &snapshot)
+{
+	snapshot.rewind();
+
+	unsigned int magic, version;
+	if (!snapshot.read(magic) || magic != snapshotMagic || !snapshot.read(version) || version != snapshotVersion) return false;
+
+	// A snapshot of a game with other teams or another arena needs the tanks built for it first
+	GameSetup savedSetup;
+	if (!snapshot.read(savedSetup.teams) || !snapshot.read(savedSetup.tanksPerTeam) || !snapshot.read(savedSetup.arenaWidth) || !snapshot.read(savedSetup.arenaHeight) ||
+		!snapshot.read(savedSetup.lookaheadTeam) || !snapshot.read(savedSetup.hasPlayer) || !snapshot.read(savedSetup.dumbTeam)) return false;
+	if (savedSetup.teams < 2 || savedSetup.tanksPerTeam < 1 || savedSetup.lookaheadTeam < -1 || savedSetup.lookaheadTeam >= savedSetup.teams) return false;
+	if (savedSetup.dumbTeam < -1 || savedSetup.dumbTeam >= savedSetup.teams || (savedSetup.dumbTeam >= 0 && savedSetup.dumbTeam == savedSetup.lookaheadTeam)) return false;
+	if (!(savedSetup == setup))
+	{
+		setup = savedSetup;
+		createTanks();
+	}
+
+	bool ok = snapshot.read(seed) && snapshot.read(rng) && snapshot.read(debugMode) && snapshot.read(tickScale) && snapshot.read(tick) &&
+		snapshot.readBytes(teamScores.data(), teamScores.size() * sizeof(int)) &&
+		entities.loadState(snapshot);
+	for (int i = 0; ok && i < numTanks(); i++) ok = tank(i)->loadState(snapshot);
+	if (!ok || !aiSchedule.loadState(snapshot) || !snapshot.read(lookahead)) return false;
+
+	// The grids aren't saved, they follow from the positions
+	for (int i = 0; i < numTanks(); i++) placeTank(i);
+	return true;
 }
\ No newline at end of file
@@ -0,0 +1,191 @@
+/*! \file gameRenderer.cpp
+* \brief Source file for the GameRenderer class.
+*
+* Contains the definitions for the GameRenderer class' constructor and methods.
+*/
+
+#include "gameRenderer.h"
+#include "resourceCache.h"
+
+GameRenderer::GameRenderer(const Game &newGame) : game(newGame)
+{
+	redBodyTex = ResourceCache::getTexture("assets\\redTank.png");
+	redTurretTex = ResourceCache::getTexture("assets\\redTankTurret.png");
+	blueBodyTex = ResourceCache::getTexture("assets\\blueTank.png");
+	blueTurretTex = ResourceCache::getTexture("assets\\blueTankTurret.png");
+	font = ResourceCache::getFont("C:\\Windows\\Fonts\\arial.ttf");
+}
+
+void GameRenderer::drawBox(sf::RenderTarget &target, const BoundingBox &bb) const
+{
+	sf::VertexArray box(sf::LinesStrip, 5);
+	box[0] = sf::Vertex(sf::Vector2f(bb.getX1(), bb.getY1()), sf::Color::White);
+	box[1] = sf::Vertex(sf::Vector2f(bb.getX1(), bb.getY2()), sf::Color::White);
+	box[2] = sf::Vertex(sf::Vector2f(bb.getX2(), bb.getY2()), sf::Color::White);
+	box[3] = sf::Vertex(sf::Vector2f(bb.getX2(), bb.getY1()), sf::Color::White);
+	box[4] = sf::Vertex(sf::Vector2f(bb.getX1(), bb.getY1()), sf::Color::White);
+	target.draw(box);
+}
+
+void GameRenderer::drawTank(sf::RenderTarget &target, const Tank &tank, const std::shared_ptr<const sf::Texture> &bodyTex, const std::shared_ptr<const sf::Texture> &turretTex, const sf::Color &tint) const
+{
+	// Nothing to draw with if the textures failed to load
+	if (!bodyTex || !turretTex) return;
+
+	sf::Sprite body(*bodyTex);
+	body.setOrigin(100, 100);
+	body.setScale(0.2f, 0.2f);
+	body.setPosition(tank.getX(), tank.getY());
+	body.setRotation(tank.getTh());
+	body.setColor(tint);
+
+	sf::Sprite turret(*turretTex);
+	turret.setOrigin(46, 44);
+	turret.setScale(0.2f, 0.2f);
+	turret.setPosition(tank.getX(), tank.getY());
+	turret.setRotation(tank.getTurretTh());
+	turret.setColor(tint);
+
+	target.draw(body);
+	target.draw(turret);
+	if (game.isDebugMode()) drawBox(target, tank.getBb());
+}
+
+void GameRenderer::drawMap(sf::RenderTarget &target, const Map &map) const
+{
+	sf::RectangleShape debugRect;
+	debugRect.setOutlineThickness(1.f);
+	debugRect.setOutlineColor(sf::Color(0, 0, 0, 135));
+
+	for (int i = 0; i < map.getWidth(); i++)
+	{
+		for (int j = 0; j < map.getHeight(); j++)
+		{
+			const MapNode &node = map.getNode(i, j);
+
+			// Colour the node by what it contains, path nodes over everything
+			sf::Color colour(0, 0, 0, 0);
+			if (node.getObjectType() == Object::OWNBASE) colour = sf::Color(135, 0, 0, 100);
+			if (node.getObjectType() == Object::PLAYERBASE || node.getObjectType() == Object::PLAYERTANK) colour = sf::Color(0, 0, 135, 100);
+			if (node.getObjectType() == Object::PLAYERSHELL) colour = sf::Color(0, 100, 50, 100);
+			if (node.isPath()) colour = sf::Color(255, 0, 0, 100);
+
+			// Build the rectangle from the border, inside the outline
+			sf::FloatRect border = node.getBorder();
+			debugRect.setSize(sf::Vector2f(border.width - 2.f, border.height - 2.f));
+			debugRect.setPosition(border.left + 1.f, border.top + 1.f);
+			debugRect.setFillColor(colour);
+			target.draw(debugRect);
+		}
+	}
+}
+
+void GameRenderer::draw(sf::RenderTarget &target, sf::RenderStates states) const
+{
+	bool debugMode = game.isDebugMode();
+
+	// Set Backgound
+	sf::RectangleShape background(sf::Vector2f(780.0f, 570.0f));
+	background.setFillColor(sf::Color(40, 70, 20));
+	background.setPosition(10.0f, 10.0f);
+	target.draw(background);
+
+	sf::RectangleShape ammoArea(sf::Vector2f(800.0f, 20.0f));
+	ammoArea.setFillColor(sf::Color(140, 90, 60));
+	ammoArea.setPosition(0.0f, 580.0f);
+	target.draw(ammoArea);
+
+	// Draw shells
+	const EntityStore &entities = game.getEntities();
+	sf::RectangleShape shellRect(sf::Vector2f(6.0f, 12.0f));
+	shellRect.setFillColor(sf::Color(90, 90, 90));
+	shellRect.setOrigin(2, 6);
+	for (int i = 0; i < entities.shellCount(); i++)
+	{
+		if (entities.isShellVisible(i) || debugMode)
+		{
+			Position pos = entities.getShellPos(i);
+			shellRect.setPosition(pos.getX(), pos.getY());
+			shellRect.setRotation(pos.getTh() - 90.0f);
+			target.draw(shellRect);
+			if (debugMode) drawBox(target, entities.getShellBox(i));
+		}
+	}
+
+	// Draw walls and buildings
+	sf::RectangleShape block;
+	for (int i = 0; i < entities.size(); i++)
+	{
+		// Walls are always shown, buildings once they have been seen
+		if (entities.isBuilding(i) && !entities.isVisible(i) && !debugMode) continue;
+
+		BoundingBox bb = entities.getBox(i);
+		block.setSize(sf::Vector2f(bb.getX2() - bb.getX1(), bb.getY2() - bb.getY1()));
+		block.setPosition(bb.getX1(), bb.getY1());
+		block.setFillColor(sf::Color(entities.getColour(i)));
+		target.draw(block);
+	}
+
+	// Draw AI tanks, teams past blue use the red textures tinted
+	static const sf::Color teamTints[] = { sf::Color::Green, sf::Color::Yellow, sf::Color::Magenta, sf::Color::Cyan };
+	for (int i = 0; i < game.numTanks(); i++)
+	{
+		if (i == game.getPlayerIndex() || !(entities.isTankVisible(i) || debugMode || game.getPlayerIndex() < 0)) continue; // With no player to hide them from, every tank is shown
+
+		const Tank &tank = game.getTank(i);
+		int team = game.getTankTeam(i);
+		if (team == BLUE_TEAM) drawTank(target, tank, blueBodyTex, blueTurretTex);
+		else if (team == RED_TEAM) drawTank(target, tank, redBodyTex, redTurretTex);
+		else drawTank(target, tank, redBodyTex, redTurretTex, teamTints[(team - 2) % 4]);
+	}
+
+	// Debug mode shows what the first AI tank knows
+	if (debugMode && game.getAiTank(0)) drawMap(target, game.getAiTank(0)->getMap());
+
+	// Draw Player
+	if (game.getPlayerIndex() >= 0) drawTank(target, game.player, blueBodyTex, blueTurretTex);
+
+	// Draw ammo, of the first blue tank whoever drives it
+	sf::RectangleShape ammo(sf::Vector2f(5, 10));
+	ammo.setFillColor(sf::Color(0, 0, 255));
+	for (int i = 0; i < game.getTank(BLUE_TEAM * game.getSetup().tanksPerTeam).getNumberOfShells(); i++)
+	{
+		ammo.setPosition((float)i * 15 + 10, 585.f);
+		target.draw(ammo);
+	}
+
+	ammo.setFillColor(sf::Color(255, 0, 0));
+	for (int i = 0; i < game.getTank(0).getNumberOfShells(); i++)
+	{
+		ammo.setPosition((float)790 - i * 15, 585.f);
+		target.draw(ammo);
+	}
+
+	// Draw scores
+	if (!font) return;
+	char msg[255];
+	sprintf_s(msg, "%d", game.getBlueScore());
+	sf::Text drawingText(sf::String(msg), *font, 18);
+	drawingText.setColor(sf::Color::White);
+
+	drawingText.setPosition(250, 577);
+	target.draw(drawingText);
+
+	sprintf_s(msg, "%d", game.getRedScore());
+	drawingText.setString(sf::String(msg));
+	drawingText.setPosition(550, 577);
+	target.draw(drawingText);
+
+	// Draw game over
+	if (game.gameOver())
+	{
+		sf::Text drawingText(sf::String("GAME OVER"), *font, 42);
+		drawingText.setPosition(300, 140);
+		target.draw(drawingText);
+		drawingText.setPosition(300, 240);
+		if (game.getRedScore() > game.getBlueScore()) drawingText.setString(sf::String("RED WINS!"));
+		if (game.getRedScore() < game.getBlueScore()) drawingText.setString(sf::String("BLUE WINS!"));
+		if (game.getRedScore() == game.getBlueScore()) drawingText.setString(sf::String("MATCH DRAW!"));
+		target.draw(drawingText);
+	}
+}
\ No newline at end of file
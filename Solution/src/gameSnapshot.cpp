@@ -0,0 +1,29 @@
+/*! \file gameSnapshot.cpp
+* \brief Source file for the GameSnapshot class.
+*
+* Contains the definitions for the GameSnapshot class' methods.
+*/
+
+#include "gameSnapshot.h"
+
+void GameSnapshot::assign(const void *pData, size_t uiSize)
+{
+	vBytes.resize(uiSize);
+	if (uiSize > 0) memcpy(vBytes.data(), pData, uiSize);
+	readPos = 0;
+}
+
+void GameSnapshot::writeBytes(const void *pData, size_t uiSize)
+{
+	size_t uiOld = vBytes.size();
+	vBytes.resize(uiOld + uiSize);
+	if (uiSize > 0) memcpy(vBytes.data() + uiOld, pData, uiSize);
+}
+
+bool GameSnapshot::readBytes(void *pData, size_t uiSize)
+{
+	if (readPos + uiSize > vBytes.size()) return false;
+	if (uiSize > 0) memcpy(pData, vBytes.data() + readPos, uiSize);
+	readPos += uiSize;
+	return true;
+}
\ No newline at end of file
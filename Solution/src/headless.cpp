@@ -0,0 +1,560 @@
+/*! \file headless.cpp
+* \brief Entry point for the headless runner.
+*
+* Plays games with no window or graphics context, stepping Game::play as fast as the CPU allows, and reports the simulation rate.
+* Usage: headless [matches] [maxTicks] [tickScale] [threads] [seed]
+*        headless --replay file [tick]
+*        headless --scale [maxTanks] [ticks] [seed] [aiBudget]
+*        headless --sweep matchesPerSet maxTicks samples seed name=low:high[:steps]...
+*        headless --evolve generations population matchesPerOpponent maxTicks seed checkpoint name=low:high...
+*        headless --lookahead matches maxTicks seed budgetMicroseconds [maxRollouts]
+*        headless --serve envs maxTicks seed name [tickScale] [threads]
+*        headless --tickcheck matches maxTicks seed tickScale [threads]
+*        headless --vecenv envs steps seed [threads]
+*/
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "aitank.h"
+#include "game.h"
+#include "map.h"
+#include "matchRunner.h"
+#include "paramEvolver.h"
+#include "paramSweep.h"
+#include "random.h"
+#include "replayLog.h"
+#include "replayReader.h"
+#include "vecEnv.h"
+
+// Plays a recorded game back from its seed and key presses, and reports how it ended
+static int playReplay(const char *sFile)
+{
+	ReplayLog replay;
+	if (!replay.load(sFile) || !replay.isFinished())
+	{
+		fprintf(stderr, "Can't read replay %s\n", sFile);
+		return EXIT_FAILURE;
+	}
+
+	Game game(replay.getSeed());
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	bool bOk = replay.playback(game);
+	double dSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	if (!bOk)
+	{
+		fprintf(stderr, "Damaged keyframe in %s\n", sFile);
+		return EXIT_FAILURE;
+	}
+
+	printf("Seed %llu, %zu events, red %d, blue %d%s\n", replay.getSeed(), replay.getEvents().size() - 1,
+		game.getRedScore(), game.getBlueScore(), game.gameOver() ? ", game over" : "");
+	printf("%u ticks in %.3f s, %.0f ticks/second\n", game.getTick(), dSeconds, dSeconds > 0.0 ? game.getTick() / dSeconds : 0.0);
+
+	// Where the AI tank's state machines spent the game
+	const NewTank *ai = game.getAiTank(0);
+	if (ai)
+	{
+		printf("%-12s %8s %10s\n", "State", "entries", "timesteps");
+		for (int i = 0; i < NewTank::numMovementStates(); i++) printf("%-12s %8u %10u\n", NewTank::movementStateName(i), ai->getStateEntries(i), ai->getStateTimesteps(i));
+		for (int i = 0; i < NewTank::numWeaponStates(); i++) printf("%-12s %8u %10u\n", NewTank::weaponStateName(i), ai->getWeaponStateEntries(i), ai->getWeaponStateTimesteps(i));
+	}
+
+	return EXIT_SUCCESS;
+}
+
+// Jumps straight to a timestep of a recorded game through its keyframes, and reports the state there
+static int seekReplay(const char *sFile, unsigned int uiTick)
+{
+	ReplayReader reader;
+	if (!reader.open(sFile))
+	{
+		fprintf(stderr, "Can't read replay %s\n", sFile);
+		return EXIT_FAILURE;
+	}
+
+	Game game(reader.getSeed());
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	bool bOk = reader.seek(game, uiTick);
+	double dSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	if (!bOk)
+	{
+		fprintf(stderr, "Damaged keyframe in %s\n", sFile);
+		return EXIT_FAILURE;
+	}
+
+	printf("Seed %llu, %u ticks, %u keyframes every %u ticks\n", reader.getSeed(), reader.getLength(), reader.getKeyframeCount(), reader.getKeyframeInterval());
+	printf("Tick %u: red %d, blue %d%s, reached in %.3f ms\n", game.getTick(), game.getRedScore(), game.getBlueScore(),
+		game.gameOver() ? ", game over" : "", dSeconds * 1000.0);
+
+	return EXIT_SUCCESS;
+}
+
+// Plays a game for a number of timesteps, and gives the seconds taken and the AI thinks per timestep
+static double timeScaleGame(const GameSetup &setup, int iTicks, unsigned long long ullSeed, const AiScheduleSettings &schedule, double &dThinks)
+{
+	Game game(ullSeed, setup);
+	game.setAiSchedule(schedule);
+
+	// Keeps playing after game over, only the cost per tick matters here
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int i = 0; i < iTicks; i++) game.play();
+	double dSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	dThinks = (double)game.getAiScheduler().getThinks() / iTicks;
+	return dSeconds;
+}
+
+// Times games with more and more tanks, two teams in an arena grown to keep the classic space per tank.
+// Each size is played with every tank thinking every timestep, which isolates the spatial queries, then again with level of detail on
+static int scaleBenchmark(int iMaxTanks, int iTicks, unsigned long long ullSeed, int iBudget)
+{
+	printf("%30s %27s %40s\n", "", "every tank every timestep", "level of detail");
+	printf("%6s %13s %9s %12s %14s %12s %14s %12s\n", "Tanks", "Arena", "Map node", "us/tick", "ns/tank-tick", "us/tick", "ns/tank-tick", "thinks/tick");
+
+	for (int iTanks = 2; ; iTanks = iTanks * 2 > iMaxTanks && iTanks < iMaxTanks ? iMaxTanks : iTanks * 2)
+	{
+		GameSetup setup;
+		setup.tanksPerTeam = iTanks / 2;
+		float fScale = std::sqrt((float)setup.tanksPerTeam);
+		setup.arenaWidth = std::floor(800.f * fScale);
+		setup.arenaHeight = std::floor(580.f * fScale);
+		int iCount = setup.teams * setup.tanksPerTeam;
+
+		// The AI's map keeps its node count and stretches over the arena, so big arenas have big nodes
+		float fNodeWidth = (setup.arenaWidth - 20.f) / Map::s_kiWidth;
+		float fNodeHeight = (setup.arenaHeight - 20.f) / Map::s_kiHeight;
+
+		double dThinks;
+		double dFull = timeScaleGame(setup, iTicks, ullSeed, AiScheduleSettings(), dThinks);
+
+		// Tanks away from danger think every fourth timestep
+		AiScheduleSettings schedule;
+		schedule.iMaxPeriod = 4;
+		schedule.iBudget = iBudget;
+		double dDetail = timeScaleGame(setup, iTicks, ullSeed, schedule, dThinks);
+
+		printf("%6d %6.0fx%-6.0f %4.0fx%-4.0f %12.1f %14.1f %12.1f %14.1f %12.1f\n", iCount, setup.arenaWidth, setup.arenaHeight, fNodeWidth, fNodeHeight,
+			dFull * 1e6 / iTicks, dFull * 1e9 / ((double)iTicks * iCount), dDetail * 1e6 / iTicks, dDetail * 1e9 / ((double)iTicks * iCount), dThinks);
+
+		if (iTanks >= iMaxTanks) break;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+// Prints the results table, the wins and the simulation rate of a batch of matches
+static void printResults(const std::vector<MatchResult> &results, double dSeconds)
+{
+	MatchRunner::printTable(results, stdout);
+
+	long long llTotalTicks = 0;
+	int iWins[3] = { 0, 0, 0 };
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		llTotalTicks += results[i].lTicks;
+		iWins[results[i].winner]++;
+	}
+	printf("Red %d, blue %d, draw %d\n", iWins[WINNER_RED], iWins[WINNER_BLUE], iWins[WINNER_DRAW]);
+	printf("%lld ticks in %.3f s, %.0f ticks/second\n", llTotalTicks, dSeconds, dSeconds > 0.0 ? llTotalTicks / dSeconds : 0.0);
+}
+
+// Means of one scale's matches, for tickScaleCheck
+struct TickScaleSummary
+{
+	double dRed; // Mean red score
+	double dBlue; // Mean blue score
+	double dTicks; // Mean game ticks played, matches stopped at the limit count as the limit
+	int iFinished; // Matches that ended before the limit
+};
+
+static TickScaleSummary summarise(const std::vector<MatchResult> &results)
+{
+	TickScaleSummary summary = { 0.0, 0.0, 0.0, 0 };
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		summary.dRed += results[i].iRedScore;
+		summary.dBlue += results[i].iBlueScore;
+		summary.dTicks += results[i].lTicks;
+		if (results[i].bFinished) summary.iFinished++;
+	}
+	summary.dRed /= results.size();
+	summary.dBlue /= results.size();
+	summary.dTicks /= results.size();
+	return summary;
+}
+
+// Plays the same seeds one tick a timestep and at a coarser tick scale, and compares each match's winner, scores and end tick.
+// Shells hit the same things at any scale, but the AI decides once a timestep, so small differences grow and a single match can play out differently.
+// Outcomes count as the same within these tolerances, which is what matters when many matches are played to judge the AI
+static const double s_kdSameWinners = 0.95; // Least share of matches keeping their winner
+static const double s_kdScoreTolerance = 0.1; // Most each side's mean score may move, as a share of the mean total score at one tick
+static const double s_kdTickTolerance = 0.2; // Most the mean game length may move, as a share of the length at one tick
+
+static int tickScaleCheck(int iMatches, long lMaxTicks, unsigned long long ullSeed, int iTickScale, int iThreads)
+{
+	static const char *s_kWinners[3] = { "RED", "BLUE", "DRAW" };
+	std::vector<MatchResult> fine = MatchRunner(lMaxTicks, 1, iThreads, ullSeed).run(iMatches);
+	std::vector<MatchResult> coarse = MatchRunner(lMaxTicks, iTickScale, iThreads, ullSeed).run(iMatches);
+
+	// A coarse game only ends on a timestep, so an end within one of the fine game's is the same end
+	int iSameWinner = 0;
+	int iSameScores = 0;
+	int iSameEnd = 0;
+	printf("Winners that changed\n");
+	printf("%20s %22s %22s\n", "seed", "1 tick", "scaled");
+	for (int m = 0; m < iMatches; m++)
+	{
+		if (fine[m].iRedScore == coarse[m].iRedScore && fine[m].iBlueScore == coarse[m].iBlueScore) iSameScores++;
+		if (labs(fine[m].lTicks - coarse[m].lTicks) < iTickScale) iSameEnd++;
+		if (fine[m].winner == coarse[m].winner)
+		{
+			iSameWinner++;
+			continue;
+		}
+		printf("%20llu %5s %4d-%-4d %6ld %5s %4d-%-4d %6ld\n", fine[m].ullSeed, s_kWinners[fine[m].winner], fine[m].iRedScore, fine[m].iBlueScore, fine[m].lTicks,
+			s_kWinners[coarse[m].winner], coarse[m].iRedScore, coarse[m].iBlueScore, coarse[m].lTicks);
+	}
+	printf("Of %d matches at %d ticks a timestep, %d kept the winner, %d the scores and %d the end tick\n", iMatches, iTickScale, iSameWinner, iSameScores, iSameEnd);
+
+	TickScaleSummary fineSummary = summarise(fine);
+	TickScaleSummary coarseSummary = summarise(coarse);
+	printf("%-10s %10s %10s %10s %10s\n", "", "red", "blue", "ticks", "finished");
+	printf("%-10s %10.1f %10.1f %10.0f %10d\n", "1 tick", fineSummary.dRed, fineSummary.dBlue, fineSummary.dTicks, fineSummary.iFinished);
+	printf("%-10s %10.1f %10.1f %10.0f %10d\n", "scaled", coarseSummary.dRed, coarseSummary.dBlue, coarseSummary.dTicks, coarseSummary.iFinished);
+
+	double dScoreTolerance = s_kdScoreTolerance * (fineSummary.dRed + fineSummary.dBlue);
+	bool bWinners = iSameWinner >= s_kdSameWinners * iMatches;
+	bool bScores = fabs(coarseSummary.dRed - fineSummary.dRed) <= dScoreTolerance && fabs(coarseSummary.dBlue - fineSummary.dBlue) <= dScoreTolerance;
+	bool bTicks = fabs(coarseSummary.dTicks - fineSummary.dTicks) <= s_kdTickTolerance * fineSummary.dTicks;
+	printf("Winners %s (at least %.0f%% the same), mean scores %s (within %.1f), mean length %s (within %.0f ticks)\n",
+		bWinners ? "pass" : "FAIL", s_kdSameWinners * 100.0, bScores ? "pass" : "FAIL", dScoreTolerance, bTicks ? "pass" : "FAIL", s_kdTickTolerance * fineSummary.dTicks);
+	return bWinners && bScores && bTicks ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Reads parameter ranges, each name=low:high with :steps for a grid, returns false after listing the parameters if one is bad
+static bool parseRanges(int argc, char *argv[], std::vector<SweepRange> &ranges)
+{
+	for (int i = 0; i < argc; i++)
+	{
+		char sName[64];
+		SweepRange range;
+		range.iSteps = 1;
+		if (sscanf(argv[i], "%63[^=]=%lf:%lf:%d", sName, &range.dLow, &range.dHigh, &range.iSteps) < 3 || (range.iParam = NewTankParams::find(sName)) < 0)
+		{
+			fprintf(stderr, "Bad range %s, parameters are:", argv[i]);
+			for (int n = 0; n < NewTankParams::count(); n++) fprintf(stderr, " %s", NewTankParams::name(n));
+			fprintf(stderr, "\n");
+			return false;
+		}
+		ranges.push_back(range);
+	}
+	return true;
+}
+
+// Two AI tanks a side in an arena twice the classic area, with no player so neither side starts a tank ahead
+static GameSetup tuningSetup()
+{
+	GameSetup setup;
+	setup.tanksPerTeam = 2;
+	setup.hasPlayer = false;
+	setup.arenaWidth = std::floor(800.f * std::sqrt(2.f));
+	setup.arenaHeight = std::floor(580.f * std::sqrt(2.f));
+	return setup;
+}
+
+// Plays each parameter set against the defaults from both sides, and reports the win rates and throughput
+static int parameterSweep(int iMatchesPerSet, long lMaxTicks, int iSamples, unsigned long long ullSeed, int argc, char *argv[])
+{
+	GameSetup setup = tuningSetup();
+	ParamSweep sweep(setup, iMatchesPerSet, lMaxTicks, 1, 0, ullSeed);
+
+	std::vector<SweepRange> ranges;
+	if (!parseRanges(argc, argv, ranges)) return EXIT_FAILURE;
+	for (size_t r = 0; r < ranges.size(); r++) sweep.addRange(ranges[r]);
+
+	std::vector<NewTankParams> sets = iSamples > 0 ? sweep.latinHypercube(iSamples, ullSeed) : sweep.grid();
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::vector<SweepResult> results = sweep.run(sets);
+	double dSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	sweep.printTable(results, stdout);
+	long long llMatches = (long long)sets.size() * sweep.matchesPerSet();
+	printf("%lld matches in %.3f s, %.2f matches per core-second\n", llMatches, dSeconds, sweep.getCoreSeconds() > 0.0 ? llMatches / sweep.getCoreSeconds() : 0.0);
+	return EXIT_SUCCESS;
+}
+
+// Evolves the red team's parameters, carrying on from the checkpoint if there is one and saving it after every generation
+static int evolveParameters(int iGenerations, const EvolverSettings &settings, unsigned long long ullSeed, const char *sCheckpoint, int argc, char *argv[])
+{
+	std::vector<SweepRange> ranges;
+	if (!parseRanges(argc, argv, ranges)) return EXIT_FAILURE;
+	ParamEvolver evolver(tuningSetup(), settings, ullSeed);
+	for (size_t r = 0; r < ranges.size(); r++) evolver.addRange(ranges[r]);
+
+	if (evolver.load(sCheckpoint)) printf("Carrying on from generation %d in %s\n", evolver.getGeneration(), sCheckpoint);
+	else evolver.start();
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	long long llMatches = 0;
+	double dCoreSeconds = 0.0;
+	while (evolver.getGeneration() < iGenerations)
+	{
+		llMatches += (long long)evolver.getPopulation().size() * evolver.matchesPerSet();
+		evolver.step();
+		dCoreSeconds += evolver.getCoreSeconds();
+		evolver.printGeneration(stdout);
+		fflush(stdout);
+		if (!evolver.save(sCheckpoint)) fprintf(stderr, "Couldn't write the checkpoint %s\n", sCheckpoint);
+	}
+	double dSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	printf("%lld matches in %.3f s, %.2f matches per core-second\n", llMatches, dSeconds, dCoreSeconds > 0.0 ? llMatches / dCoreSeconds : 0.0);
+	return EXIT_SUCCESS;
+}
+
+// Plays each seed with blue's AI tanks planning by lookahead and again with them on the state machine alone, and reports how blue did both ways and what the planning cost
+static int lookaheadBenchmark(int iMatches, long lMaxTicks, unsigned long long ullSeed, const LookaheadSettings &settings)
+{
+	printf("%-10s %5s %5s %5s %11s %10s %13s %14s\n", "blue", "won", "drew", "lost", "mean margin", "decisions", "rollouts/plan", "us/plan");
+	for (int planned = 1; planned >= 0; planned--)
+	{
+		GameSetup setup = tuningSetup();
+		setup.lookaheadTeam = planned ? BLUE_TEAM : -1;
+
+		int iWins = 0, iDraws = 0, iLosses = 0;
+		long long llMargin = 0, llDecisions = 0, llRollouts = 0;
+		double dSeconds = 0.0;
+		for (int m = 0; m < iMatches; m++)
+		{
+			Game game(ullSeed + (unsigned long long)m, setup);
+			game.setLookahead(settings);
+			for (long lTicks = 0; lTicks < lMaxTicks && !game.gameOver(); lTicks++) game.play();
+
+			int iMargin = game.getBlueScore() - game.getRedScore();
+			if (iMargin > 0) iWins++;
+			else if (iMargin < 0) iLosses++;
+			else iDraws++;
+			llMargin += iMargin;
+			llDecisions += (long long)game.getLookaheadDecisions();
+			llRollouts += (long long)game.getLookaheadRollouts();
+			dSeconds += game.getLookaheadSeconds();
+		}
+		printf("%-10s %5d %5d %5d %11.1f %10lld %13.1f %14.0f\n", planned ? "lookahead" : "baseline", iWins, iDraws, iLosses, (double)llMargin / iMatches, llDecisions,
+			llDecisions > 0 ? (double)llRollouts / llDecisions : 0.0, llDecisions > 0 ? dSeconds * 1e6 / llDecisions : 0.0);
+	}
+	return EXIT_SUCCESS;
+}
+
+// Steps a batch of environments with random actions, as a learner would through the shared block, and reports the rate and what the episodes scored
+static int vecEnvBenchmark(const VecEnvSettings &settings, long lSteps, unsigned long long ullSeed)
+{
+	VecEnv env(settings, GameSetup(), ullSeed);
+	if (!env.isReady())
+	{
+		fprintf(stderr, "Can't map the environments' buffers\n");
+		return EXIT_FAILURE;
+	}
+
+	// Actions held for a while, as a policy's would be, so the tank gets somewhere
+	Random rng(ullSeed);
+	long long llEpisodes = 0;
+	double dReturns = 0.0;
+	std::vector<double> vdReturns(settings.iEnvs, 0.0);
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (long s = 0; s < lSteps; s++)
+	{
+		float *pfActions = env.actions();
+		for (int e = 0; e < settings.iEnvs; e++)
+		{
+			float *pfAction = pfActions + e * VecEnv::s_kiActionSize;
+			if (s % 20 == 0)
+			{
+				pfAction[0] = (float)rng.range(5);
+				pfAction[1] = (float)rng.range(3);
+			}
+			pfAction[2] = rng.range(40) == 0 ? 1.f : 0.f;
+		}
+		env.step();
+		for (int e = 0; e < settings.iEnvs; e++)
+		{
+			vdReturns[e] += env.rewards()[e];
+			if (env.dones()[e] == 0.f) continue;
+			llEpisodes++;
+			dReturns += vdReturns[e];
+			vdReturns[e] = 0.0;
+		}
+	}
+	double dSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	double dEnvSteps = (double)lSteps * settings.iEnvs;
+	printf("%d envs, %.0f env-steps in %.3f s, %.0f env-steps per second, %d floats per observation\n", settings.iEnvs, dEnvSteps, dSeconds, dSeconds > 0.0 ? dEnvSteps / dSeconds : 0.0, env.observationSize());
+	printf("%lld episodes finished, mean return %.1f\n", llEpisodes, llEpisodes > 0 ? dReturns / llEpisodes : 0.0);
+	return EXIT_SUCCESS;
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc > 1 && strcmp(argv[1], "--replay") == 0)
+	{
+		if (argc != 3 && argc != 4)
+		{
+			fprintf(stderr, "Usage: %s --replay file [tick]\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+		AITank::quiet = true;
+		return argc == 4 ? seekReplay(argv[2], (unsigned int)strtoul(argv[3], nullptr, 10)) : playReplay(argv[2]);
+	}
+
+	if (argc > 1 && strcmp(argv[1], "--scale") == 0)
+	{
+		int iMaxTanks = argc > 2 ? atoi(argv[2]) : 1000; // Most tanks to time
+		int iTicks = argc > 3 ? atoi(argv[3]) : 200; // Timesteps played at each size
+		unsigned long long ullSeed = argc > 4 ? strtoull(argv[4], nullptr, 10) : Random::timeSeed();
+		int iBudget = argc > 5 ? atoi(argv[5]) : 0; // Most AI thinks in a timestep, 0 for no limit
+		if (iMaxTanks < 2 || iTicks < 1 || iBudget < 0)
+		{
+			fprintf(stderr, "Usage: %s --scale [maxTanks] [ticks] [seed] [aiBudget]\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+		AITank::quiet = true;
+		return scaleBenchmark(iMaxTanks, iTicks, ullSeed, iBudget);
+	}
+
+	if (argc > 1 && strcmp(argv[1], "--sweep") == 0)
+	{
+		int iMatchesPerSet = argc > 2 ? atoi(argv[2]) : 0; // Matches played with each parameter set
+		long lMaxTicks = argc > 3 ? atol(argv[3]) : 0; // Matches still running after this many ticks are stopped as a draw
+		int iSamples = argc > 4 ? atoi(argv[4]) : -1; // Latin hypercube samples, 0 for a grid
+		unsigned long long ullSeed = argc > 5 ? strtoull(argv[5], nullptr, 10) : 0; // Seed of the first match and of the samples
+		if (argc < 7 || iMatchesPerSet < 1 || lMaxTicks < 1 || iSamples < 0)
+		{
+			fprintf(stderr, "Usage: %s --sweep matchesPerSet maxTicks samples seed name=low:high[:steps]...\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+		AITank::quiet = true;
+		return parameterSweep(iMatchesPerSet, lMaxTicks, iSamples, ullSeed, argc - 6, argv + 6);
+	}
+
+	if (argc > 1 && strcmp(argv[1], "--evolve") == 0)
+	{
+		int iGenerations = argc > 2 ? atoi(argv[2]) : 0; // Generations to score in all, counting any in the checkpoint
+		EvolverSettings settings;
+		settings.iPopulation = argc > 3 ? atoi(argv[3]) : 0;
+		settings.iMatchesPerOpponent = argc > 4 ? atoi(argv[4]) : 0;
+		settings.lMaxTicks = argc > 5 ? atol(argv[5]) : 0;
+		unsigned long long ullSeed = argc > 6 ? strtoull(argv[6], nullptr, 10) : 0; // Seed of the first generation's matches and of the breeding
+		if (argc < 9 || iGenerations < 1 || settings.iPopulation < 2 || settings.iMatchesPerOpponent < 1 || settings.lMaxTicks < 1)
+		{
+			fprintf(stderr, "Usage: %s --evolve generations population matchesPerOpponent maxTicks seed checkpoint name=low:high...\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+		AITank::quiet = true;
+		return evolveParameters(iGenerations, settings, ullSeed, argv[7], argc - 8, argv + 8);
+	}
+
+	if (argc > 1 && strcmp(argv[1], "--lookahead") == 0)
+	{
+		int iMatches = argc > 2 ? atoi(argv[2]) : 4; // Seeds played each way
+		long lMaxTicks = argc > 3 ? atol(argv[3]) : 20000; // Matches still running after this many ticks are stopped
+		unsigned long long ullSeed = argc > 4 ? strtoull(argv[4], nullptr, 10) : Random::timeSeed(); // Seed of the first match, the rest count up from it
+		LookaheadSettings settings;
+		if (argc > 5) settings.iBudget = atoi(argv[5]);
+		if (argc > 6) settings.iMaxRollouts = atoi(argv[6]);
+		if (iMatches < 1 || lMaxTicks < 1 || settings.iBudget < 0 || settings.iMaxRollouts < 1)
+		{
+			fprintf(stderr, "Usage: %s --lookahead matches maxTicks seed budgetMicroseconds [maxRollouts]\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+		AITank::quiet = true;
+		return lookaheadBenchmark(iMatches, lMaxTicks, ullSeed, settings);
+	}
+
+	if (argc > 1 && strcmp(argv[1], "--serve") == 0)
+	{
+		VecEnvSettings settings;
+		settings.iEnvs = argc > 2 ? atoi(argv[2]) : 0;
+		settings.lMaxTicks = argc > 3 ? atol(argv[3]) : 0;
+		unsigned long long ullSeed = argc > 4 ? strtoull(argv[4], nullptr, 10) : 0; // Seed of the first environment's first episode
+		if (argc > 6) settings.iTickScale = atoi(argv[6]);
+		if (argc > 7) settings.iThreads = atoi(argv[7]);
+		if (argc < 6 || settings.iEnvs < 1 || settings.lMaxTicks < 1 || settings.iTickScale < 1 || settings.iThreads < 0)
+		{
+			fprintf(stderr, "Usage: %s --serve envs maxTicks seed name [tickScale] [threads]\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+		AITank::quiet = true;
+
+		VecEnv env(settings, GameSetup(), ullSeed, argv[5]);
+		if (!env.isReady())
+		{
+			fprintf(stderr, "Can't create shared memory %s\n", argv[5]);
+			return EXIT_FAILURE;
+		}
+		printf("Serving %d envs in shared memory %s, %d floats per observation\n", settings.iEnvs, argv[5], env.observationSize());
+		fflush(stdout);
+		return env.serve() ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	if (argc > 1 && strcmp(argv[1], "--tickcheck") == 0)
+	{
+		int iMatches = argc > 2 ? atoi(argv[2]) : 0; // Seeds played at both scales
+		long lMaxTicks = argc > 3 ? atol(argv[3]) : 0; // Matches still running after this many ticks are stopped as a draw
+		unsigned long long ullSeed = argc > 4 ? strtoull(argv[4], nullptr, 10) : 0; // Seed of the first match, the rest count up from it
+		int iTickScale = argc > 5 ? atoi(argv[5]) : 0; // Game ticks advanced by each timestep of the coarse games
+		int iThreads = argc > 6 ? atoi(argv[6]) : 0; // Worker threads, 0 for one per hardware thread
+		if (argc < 6 || iMatches < 1 || lMaxTicks < 1 || iTickScale < 1 || iThreads < 0)
+		{
+			fprintf(stderr, "Usage: %s --tickcheck matches maxTicks seed tickScale [threads]\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+		AITank::quiet = true;
+		return tickScaleCheck(iMatches, lMaxTicks, ullSeed, iTickScale, iThreads);
+	}
+
+	if (argc > 1 && strcmp(argv[1], "--vecenv") == 0)
+	{
+		VecEnvSettings settings;
+		settings.iEnvs = argc > 2 ? atoi(argv[2]) : 16;
+		long lSteps = argc > 3 ? atol(argv[3]) : 10000; // Steps of the whole batch
+		unsigned long long ullSeed = argc > 4 ? strtoull(argv[4], nullptr, 10) : Random::timeSeed(); // Seed of the first environment's first episode, and of the actions
+		if (argc > 5) settings.iThreads = atoi(argv[5]);
+		if (settings.iEnvs < 1 || lSteps < 1 || settings.iThreads < 0)
+		{
+			fprintf(stderr, "Usage: %s --vecenv envs steps seed [threads]\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+		AITank::quiet = true;
+		return vecEnvBenchmark(settings, lSteps, ullSeed);
+	}
+
+	int iMatches = argc > 1 ? atoi(argv[1]) : 10; // Number of games to play
+	long lMaxTicks = argc > 2 ? atol(argv[2]) : 100000; // Games still running after this many ticks are stopped as a draw
+	int iTickScale = argc > 3 ? atoi(argv[3]) : 1; // Game ticks advanced by each call to play()
+	int iThreads = argc > 4 ? atoi(argv[4]) : 0; // Worker threads, 0 for one per hardware thread
+	unsigned long long ullSeed = argc > 5 ? strtoull(argv[5], nullptr, 10) : Random::timeSeed(); // Seed of the first match, the rest count up from it
+	if (iMatches < 1 || lMaxTicks < 1 || iTickScale < 1 || iThreads < 0)
+	{
+		fprintf(stderr, "Usage: %s [matches] [maxTicks] [tickScale] [threads] [seed]\n       %s --replay file [tick]\n       %s --scale [maxTanks] [ticks] [seed] [aiBudget]\n       %s --sweep matchesPerSet maxTicks samples seed name=low:high[:steps]...\n       %s --evolve generations population matchesPerOpponent maxTicks seed checkpoint name=low:high...\n       %s --lookahead matches maxTicks seed budgetMicroseconds [maxRollouts]\n       %s --serve envs maxTicks seed name [tickScale] [threads]\n       %s --tickcheck matches maxTicks seed tickScale [threads]\n       %s --vecenv envs steps seed [threads]\n", argv[0], argv[0], argv[0], argv[0], argv[0], argv[0], argv[0], argv[0], argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	// Nobody is watching the console
+	AITank::quiet = true;
+
+	MatchRunner runner(lMaxTicks, iTickScale, iThreads, ullSeed);
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::vector<MatchResult> results = runner.run(iMatches);
+	double dSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	printResults(results, dSeconds);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,219 @@
+/*! \file influenceMap.cpp
+* \brief Source file for the InfluenceMap class.
+*
+* Contains the definitions for the InfluenceMap class' constructor and methods.
+*/
+
+#include "influenceMap.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define INFLUENCEMAP_SSE
+#endif
+
+const float InfluenceMap::s_kfDecay[InfluenceMap::LAYERS] = { 0.9f, 0.98f, 0.99f };
+
+// Weights of the layers in the scores, and how much each node of distance from the tank costs
+static const float kfSafeThreat = 2.f;
+static const float kfAttackThreat = 0.5f;
+static const float kfDistanceCost = 0.05f;
+
+// Less influence than this is treated as none
+static const float kfNoInfluence = 0.01f;
+
+// Influence that has faded below this is cut to zero, rather than fading on into denormals which are very slow to work with
+static const float kfFadedOut = 1.0e-6f;
+
+InfluenceMap::InfluenceMap()
+{
+	clear();
+}
+
+void InfluenceMap::clear()
+{
+	memset(fInfluence, 0, sizeof(fInfluence));
+	memset(fStamps, 0, sizeof(fStamps));
+	memset(fSources, 0, sizeof(fSources));
+	memset(fBlurred, 0, sizeof(fBlurred));
+	for (int i = 0; i < LAYERS; i++)
+	{
+		iSources[i] = 0;
+		bActive[i] = false;
+	}
+	bScored = false;
+	scoredFrom = bestSafe = bestAttack = sf::Vector2i(0, 0);
+	bHasSafe = bHasAttack = false;
+}
+
+void InfluenceMap::stamp(Layer layer, int i, int j, float fAmount)
+{
+	fStamps[layer][j + 1][i + 1] += fAmount;
+	bActive[layer] = true;
+}
+
+void InfluenceMap::setSource(Layer layer, int i, int j, float fAmount)
+{
+	float &source = fSources[layer][j + 1][i + 1];
+	if (source == fAmount) return;
+	iSources[layer] += (fAmount != 0.f) - (source != 0.f);
+	source = fAmount;
+
+	// Stamps hold only the sources until the timestep is stamped
+	fStamps[layer][j + 1][i + 1] = fAmount;
+	if (fAmount != 0.f) bActive[layer] = true;
+}
+
+void InfluenceMap::blur(int iLayer)
+{
+	float (*influence)[s_kiStride] = fInfluence[iLayer];
+	float (*stamps)[s_kiStride] = fStamps[iLayer];
+
+	// Horizontal pass, the border columns copy the edge nodes so influence doesn't leak off the map
+	for (int y = 1; y <= s_kiHeight; y++)
+	{
+		float *row = influence[y];
+		row[0] = row[1];
+		row[s_kiWidth + 1] = row[s_kiWidth];
+#if defined(INFLUENCEMAP_SSE)
+		__m128 quarter = _mm_set1_ps(0.25f);
+		__m128 half = _mm_set1_ps(0.5f);
+		for (int x = 1; x <= s_kiWidth; x += 4)
+		{
+			__m128 sum = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&row[x - 1]), quarter), _mm_mul_ps(_mm_loadu_ps(&row[x]), half));
+			_mm_storeu_ps(&fBlurred[y][x], _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(&row[x + 1]), quarter)));
+		}
+#else
+		for (int x = 1; x <= s_kiWidth; x++)
+		{
+			fBlurred[y][x] = row[x - 1] * 0.25f + row[x] * 0.5f + row[x + 1] * 0.25f;
+		}
+#endif
+	}
+
+	// Vertical pass with the fade and this timestep's stamps, the border rows copy the edge rows
+	memcpy(fBlurred[0], fBlurred[1], sizeof(fBlurred[0]));
+	memcpy(fBlurred[s_kiHeight + 1], fBlurred[s_kiHeight], sizeof(fBlurred[0]));
+	bool bAny = false;
+#if defined(INFLUENCEMAP_SSE)
+	__m128 quarter = _mm_set1_ps(0.25f * s_kfDecay[iLayer]);
+	__m128 half = _mm_set1_ps(0.5f * s_kfDecay[iLayer]);
+	__m128 fadedOut = _mm_set1_ps(kfFadedOut);
+	__m128 any = _mm_setzero_ps();
+	for (int y = 1; y <= s_kiHeight; y++)
+	{
+		for (int x = 0; x < s_kiStride; x += 4)
+		{
+			__m128 sum = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&fBlurred[y - 1][x]), quarter), _mm_mul_ps(_mm_loadu_ps(&fBlurred[y][x]), half));
+			sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(&fBlurred[y + 1][x]), quarter));
+			sum = _mm_add_ps(_mm_and_ps(sum, _mm_cmpgt_ps(sum, fadedOut)), _mm_loadu_ps(&stamps[y][x]));
+			any = _mm_or_ps(any, sum);
+			_mm_storeu_ps(&influence[y][x], sum);
+		}
+	}
+	bAny = _mm_movemask_ps(_mm_cmpneq_ps(any, _mm_setzero_ps())) != 0;
+#else
+	float fQuarter = 0.25f * s_kfDecay[iLayer];
+	float fHalf = 0.5f * s_kfDecay[iLayer];
+	for (int y = 1; y <= s_kiHeight; y++)
+	{
+		for (int x = 0; x < s_kiStride; x++)
+		{
+			float fSum = fBlurred[y - 1][x] * fQuarter + fBlurred[y][x] * fHalf + fBlurred[y + 1][x] * fQuarter;
+			if (!(fSum > kfFadedOut)) fSum = 0.f;
+			influence[y][x] = fSum + stamps[y][x];
+			bAny = bAny || (influence[y][x] != 0.f);
+		}
+	}
+#endif
+
+	memcpy(stamps, fSources[iLayer], sizeof(fStamps[iLayer]));
+	bActive[iLayer] = bAny || iSources[iLayer] > 0; // Once faded out to nothing with no sources, the layer is skipped until stamped again
+}
+
+void InfluenceMap::update()
+{
+	for (int i = 0; i < LAYERS; i++)
+	{
+		if (bActive[i]) blur(i);
+	}
+	bScored = false;
+}
+
+void InfluenceMap::score(const Map &map, sf::Vector2i from) const
+{
+	if (bScored && (from == scoredFrom)) return;
+	bScored = true;
+	scoredFrom = from;
+
+	// Scores every node the tank can drive through, the first node wins a tie
+	float fBestSafe = 0.f;
+	float fBestAttack = 0.f;
+	float fMaxSafe = 0.f;
+	float fMaxAttack = 0.f;
+	bool bFirst = true;
+	for (int i = 0; i < s_kiWidth; i++)
+	{
+		for (int j = 0; j < s_kiHeight; j++)
+		{
+			float fThreat = fInfluence[THREAT][j + 1][i + 1];
+			float fTarget = fInfluence[TARGET][j + 1][i + 1];
+			float fHome = fInfluence[HOME][j + 1][i + 1];
+			if (fThreat > fMaxSafe) fMaxSafe = fThreat;
+			if (fHome > fMaxSafe) fMaxSafe = fHome;
+			if (fTarget > fMaxAttack) fMaxAttack = fTarget;
+
+			if (!Map::traversable(map.getNodeObject(i, j))) continue;
+
+			float fDistance = kfDistanceCost * (float)(abs(i - from.x) + abs(j - from.y));
+			float fSafe = fHome - kfSafeThreat * fThreat - fDistance;
+			float fAttack = fTarget - kfAttackThreat * fThreat - fDistance;
+			if (bFirst || fSafe > fBestSafe)
+			{
+				fBestSafe = fSafe;
+				bestSafe = sf::Vector2i(i, j);
+			}
+			if (bFirst || fAttack > fBestAttack)
+			{
+				fBestAttack = fAttack;
+				bestAttack = sf::Vector2i(i, j);
+			}
+			bFirst = false;
+		}
+	}
+
+	bHasSafe = !bFirst && fMaxSafe > kfNoInfluence;
+	bHasAttack = !bFirst && fMaxAttack > kfNoInfluence;
+}
+
+bool InfluenceMap::bestSafeCell(const Map &map, sf::Vector2i from, sf::Vector2i &cell) const
+{
+	score(map, from);
+	cell = bestSafe;
+	return bHasSafe;
+}
+
+bool InfluenceMap::bestAttackCell(const Map &map, sf::Vector2i from, sf::Vector2i &cell) const
+{
+	score(map, from);
+	cell = bestAttack;
+	return bHasAttack;
+}
+
+void InfluenceMap::saveState(GameSnapshot &snapshot) const
+{
+	// Between timesteps the stamps are only the sources, which the tank sets again from its map, and the best cells are scored again when asked for, so only the layers are kept
+	snapshot.write(fInfluence);
+	snapshot.write(bActive);
+}
+
+bool InfluenceMap::loadState(GameSnapshot &snapshot)
+{
+	bScored = false;
+	memset(fStamps, 0, sizeof(fStamps));
+	memset(fSources, 0, sizeof(fSources));
+	for (int i = 0; i < LAYERS; i++) iSources[i] = 0;
+	return snapshot.read(fInfluence) && snapshot.read(bActive);
+}
\ No newline at end of file
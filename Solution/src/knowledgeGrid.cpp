@@ -0,0 +1,70 @@
+/*! \file knowledgeGrid.cpp
+* \brief Source file for the KnowledgeGrid class.
+*
+* Contains the definitions for the KnowledgeGrid class' constructor and methods.
+*/
+
+#include "knowledgeGrid.h"
+
+#include <algorithm>
+
+KnowledgeGrid::KnowledgeGrid()
+{
+	for (int i = 0; i < s_kiWidth; i++) fColumnMin[i] = fColumnMax[i] = 0.f;
+	for (int j = 0; j < s_kiHeight; j++) fRowMin[j] = fRowMax[j] = 0.f;
+	clear();
+}
+
+void KnowledgeGrid::setLayout(const Map &map)
+{
+	// Edges worked out as sf::Rect::intersects works them out, so marking overlaps exactly the nodes Map::mark would
+	for (int i = 0; i < s_kiWidth; i++)
+	{
+		sf::FloatRect border = map.getNodeBox(i, 0);
+		fColumnMin[i] = std::min(border.left, border.left + border.width);
+		fColumnMax[i] = std::max(border.left, border.left + border.width);
+	}
+
+	for (int j = 0; j < s_kiHeight; j++)
+	{
+		sf::FloatRect border = map.getNodeBox(0, j);
+		fRowMin[j] = std::min(border.top, border.top + border.height);
+		fRowMax[j] = std::max(border.top, border.top + border.height);
+	}
+}
+
+void KnowledgeGrid::clear()
+{
+	for (int i = 0; i < s_kiWidth; i++)
+	{
+		for (int j = 0; j < s_kiHeight; j++) contains[i][j] = Object::UNKNOWN;
+	}
+}
+
+void KnowledgeGrid::mark(sf::FloatRect objectBounds, Object type)
+{
+	float fMinX = std::min(objectBounds.left, objectBounds.left + objectBounds.width);
+	float fMaxX = std::max(objectBounds.left, objectBounds.left + objectBounds.width);
+	float fMinY = std::min(objectBounds.top, objectBounds.top + objectBounds.height);
+	float fMaxY = std::max(objectBounds.top, objectBounds.top + objectBounds.height);
+
+	// Rows the object overlaps
+	int iRows[s_kiHeight];
+	int iNumRows = 0;
+	for (int j = 0; j < s_kiHeight; j++)
+	{
+		if (std::max(fMinY, fRowMin[j]) < std::min(fMaxY, fRowMax[j])) iRows[iNumRows++] = j;
+	}
+	if (iNumRows == 0) return;
+
+	// Nodes in the columns it overlaps along those rows
+	for (int i = 0; i < s_kiWidth; i++)
+	{
+		if (!(std::max(fMinX, fColumnMin[i]) < std::min(fMaxX, fColumnMax[i]))) continue;
+
+		for (int r = 0; r < iNumRows; r++)
+		{
+			if (contains[i][iRows[r]] == Object::UNKNOWN) contains[i][iRows[r]] = type;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+/*! \file lookaheadTank.cpp
+* \brief Source file for the LookaheadTank class.
+*
+* Contains the definitions for the LookaheadTank class' constructor and methods.
+*/
+
+#include "lookaheadTank.h"
+
+LookaheadTank::LookaheadTank()
+{
+	for (int i = 0; i < s_kiMaxDepth; i++) ucPlan[i] = POLICY;
+	iPlanLength = 0;
+	iActionTicks = 1;
+	iPlanTicks = 0;
+}
+
+void LookaheadTank::setPlan(const unsigned char *pucActions, int iLength, int iNewActionTicks)
+{
+	iPlanLength = iLength < s_kiMaxDepth ? iLength : s_kiMaxDepth;
+	for (int i = 0; i < iPlanLength; i++) ucPlan[i] = pucActions[i];
+	iActionTicks = iNewActionTicks < 1 ? 1 : iNewActionTicks;
+	iPlanTicks = 0;
+}
+
+int LookaheadTank::currentAction() const
+{
+	int iStep = iPlanTicks / iActionTicks;
+	return iStep < iPlanLength ? ucPlan[iStep] : (int)POLICY;
+}
+
+void LookaheadTank::move()
+{
+	// Sees, aims and triggers as usual, so the plan only has to choose where to drive
+	NewTank::move();
+
+	switch (currentAction())
+	{
+	case FORWARD:
+		goForward();
+		break;
+	case BACKWARD:
+		goBackward();
+		break;
+	case TURN_LEFT:
+		goLeft();
+		break;
+	case TURN_RIGHT:
+		goRight();
+		break;
+	case STOP:
+		stop();
+		break;
+	}
+}
+
+bool LookaheadTank::isFiring()
+{
+	return currentAction() != HOLD_FIRE && NewTank::isFiring();
+}
+
+void LookaheadTank::reset()
+{
+	NewTank::reset();
+
+	// The plan was for where the tank was, not where it respawns
+	iPlanLength = 0;
+	iPlanTicks = 0;
+}
+
+void LookaheadTank::saveState(GameSnapshot &snapshot) const
+{
+	NewTank::saveState(snapshot);
+	snapshot.write(ucPlan);
+	snapshot.write(iPlanLength);
+	snapshot.write(iActionTicks);
+	snapshot.write(iPlanTicks);
+}
+
+bool LookaheadTank::loadState(GameSnapshot &snapshot)
+{
+	return NewTank::loadState(snapshot) && snapshot.read(ucPlan) && snapshot.read(iPlanLength) && snapshot.read(iActionTicks) && snapshot.read(iPlanTicks) &&
+		iPlanLength >= 0 && iPlanLength <= s_kiMaxDepth && iActionTicks >= 1;
+}
\ No newline at end of file
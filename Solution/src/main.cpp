@@ -1,19 +1,36 @@
 #include <SFML/Graphics.hpp>
+#include <cstdlib>
 #include "game.h"
+#include "gameRenderer.h"
+#include "fixedTimestep.h"
+#include "replayLog.h"
 
-int main()
+// Usage: tankwar [ticksPerSecond] [seed] [replayFile], 0 ticks per second runs the game as fast as possible
+// With a replay file the game is recorded into it, play it back with headless --replay
+int main(int argc, char *argv[])
 {
-
+	float ticksPerSecond = argc > 1 ? (float)atof(argv[1]) : 40.0f;
+	unsigned long long seed = argc > 2 ? strtoull(argv[2], nullptr, 10) : Random::timeSeed();
+	const char *replayFile = argc > 3 ? argv[3] : nullptr;
 
 	// Create main window
 	sf::RenderWindow window(sf::VideoMode(800, 600), "Tankwar");
 
-	// Create a game
-	Game game;
+	// Create a game, and the renderer that draws it
+	Game game(seed);
+	GameRenderer renderer(game);
+
+	// Record the seed and every key press if asked to
+	ReplayLog replay;
+	if (replayFile)
+	{
+		replay.begin(game);
+		game.setRecording(&replay);
+	}
 
-	// Create a clock for measuring the time elapsed
-	sf::Clock clock1;
-	float delay = 0.0f;
+	// Schedule game ticks at a fixed rate, F1 toggles running flat out
+	FixedTimestep timestep(ticksPerSecond > 0.0f ? ticksPerSecond : 40.0f);
+	timestep.setUncapped(ticksPerSecond <= 0.0f);
 
 	// Start game loop
 	while (window.isOpen())
@@ -35,6 +52,10 @@ int main()
 				{
 					window.close();
 				}
+				else if (event.key.code == sf::Keyboard::F1) // F1 key : toggle uncapped
+				{
+					timestep.setUncapped(!timestep.isUncapped());
+				}
 				else // Pass key press to game
 				{
 					game.keyPressed(event.key.code);
@@ -48,24 +69,34 @@ int main()
 		}
 
 
-		// Run at 40 frame a second
-		delay = clock1.getElapsedTime().asSeconds();
-		if (delay > 0.025 && !game.gameOver()) {
+		// Run every tick that is due, catching up if the last frame was slow
+		int ticks = timestep.ticksDue();
+		for (int i = 0; i < ticks && !game.gameOver(); i++)
+		{
 			game.play();
-			clock1.restart();
 		}
 
 		// Clear the window
 		window.clear(sf::Color::Black);
 
 		//Draw the game
-		window.draw(game);
+		window.draw(renderer);
 
 		// Finally, display the rendered frame on screen
 		window.display();
+
+		// Sleep until there is more to do, rather than spinning
+		timestep.waitForNextTick();
 	}
 
 
+	// Save the recording, ending it at the last timestep played
+	if (replayFile)
+	{
+		replay.end(game.getTick());
+		if (!replay.save(replayFile)) return EXIT_FAILURE;
+	}
+
 	return EXIT_SUCCESS;
 
 }
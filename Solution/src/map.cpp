@@ -5,10 +5,16 @@
 */
 
 #include "map.h"
+#include "knowledgeGrid.h"
 
 Map::Map()
 {
-	sf::Vector2f size = sf::Vector2f(kiBackgroundWidth / s_kiWidth, kiBackgroundHeight / s_kiHeight); // Size of each node
+	setArea(780.f, 560.f);
+}
+
+void Map::setArea(float fWidth, float fHeight)
+{
+	sf::Vector2f size = sf::Vector2f(fWidth / s_kiWidth, fHeight / s_kiHeight); // Size of each node
 	sf::Vector2f pos = sf::Vector2f(10.f + (size.x / 2.f), 10.f + (size.y / 2.f)); // Position of the first node
 
 	for (int i = 0; i < s_kiWidth; i++)
@@ -21,13 +27,6 @@ Map::Map()
 		}
 	}
 
-	// Resize the adjacency matrix to the number of nodes by the number of nodes
-	vbAdjacencyMatrix.resize(s_kiNodes);
-	for (int i = 0; i < s_kiNodes; i++)
-	{
-		vbAdjacencyMatrix[i].resize(s_kiNodes);
-	}
-
 	for (int i = 0; i < s_kiWidth; i++)
 	{
 		for (int j = 0; j < s_kiHeight; j++)
@@ -37,9 +36,37 @@ Map::Map()
 		}
 	}
 
+	markAllChanged();
+	currentPath.clear();
 	setMapTraversable(); // Set what nodes are traversable
 }
 
+void Map::setObject(int i, int j, Object type)
+{
+	if (node[i][j].getObjectType() == type) return;
+	node[i][j].updateType(type);
+
+	int iNode = (j * s_kiWidth) + i;
+	if (!bsChanged[iNode])
+	{
+		bsChanged[iNode] = true;
+		iChanged[iNumChanged++] = iNode;
+	}
+}
+
+void Map::clearChanged()
+{
+	bsChanged.reset();
+	iNumChanged = 0;
+}
+
+void Map::markAllChanged()
+{
+	bsChanged.set();
+	for (int i = 0; i < s_kiNodes; i++) iChanged[i] = i;
+	iNumChanged = s_kiNodes;
+}
+
 void Map::mark(sf::FloatRect objectBounds, Object type)
 {
 	for (int i = 0; i < s_kiWidth; i++)
@@ -50,12 +77,25 @@ void Map::mark(sf::FloatRect objectBounds, Object type)
 			if (node[i][j].getBorder().intersects(objectBounds))
 			{
 				if (node[i][j].getObjectType() == Object::UNKNOWN)
-					node[i][j].updateType(type); // Update the node with it's contained object type
+					setObject(i, j, type); // Update the node with it's contained object type
 			}
 		}
 	}
 }
 
+void Map::merge(const KnowledgeGrid &grid)
+{
+	for (int i = 0; i < s_kiWidth; i++)
+	{ // For each node
+		for (int j = 0; j < s_kiHeight; j++)
+		{
+			// Only unknown nodes take what the team saw, as in mark
+			if (node[i][j].getObjectType() == Object::UNKNOWN && grid.getNodeObject(i, j) != Object::UNKNOWN)
+				setObject(i, j, grid.getNodeObject(i, j));
+		}
+	}
+}
+
 void Map::update(int i, int j, bool canSee, Position pos, sf::Vector2i goal)
 {
 	// If the node can be seen
@@ -74,7 +114,7 @@ void Map::update(int i, int j, bool canSee, Position pos, sf::Vector2i goal)
 			if (!node[i][j].bSeen && !node[i][j].isPath())
 			{
 				// Update it's type to unknown (If it's been destroyed, it will be traversable again
-				node[i][j].updateType(Object::UNKNOWN);
+				setObject(i, j, Object::UNKNOWN);
 			}
 			// It is currently seen
 			node[i][j].bSeen = true;
@@ -102,7 +142,7 @@ void Map::update(int i, int j, bool canSee, Position pos, sf::Vector2i goal)
 	{
 
 		// Update it's type to unknown (If it's been destroyed, it will be traversable again
-		node[i][j].updateType(Object::UNKNOWN);
+		setObject(i, j, Object::UNKNOWN);
 
 	}
 
@@ -151,7 +191,6 @@ void Map::makeNewPath(float x, float y, sf::Vector2i &goalNode)
 			int j;
 			inverseIndex(*graphListIter, i, j); // Get the nodes map coordinates
 			node[i][j].setIfPath(false); // The node is no longer in a path
-			node[i][j].resetColour();
 		}
 		currentPath.clear(); // Clear the path
 	}
@@ -333,7 +372,7 @@ void Map::makeNewPath(float x, float y, sf::Vector2i &goalNode)
 	}
 }
 
-sf::Vector2f Map::followPath(Position pos)
+sf::Vector2f Map::followPath(Position pos, float fReach)
 {
 	// If there is no path to follow
 	if (currentPath.empty())
@@ -353,10 +392,10 @@ sf::Vector2f Map::followPath(Position pos)
 	sf::Vector2f nodeWorldPos = sf::Vector2f(nodeBorder.left + (nodeBorder.width / 2.f), nodeBorder.top + (nodeBorder.height / 2.f));
 
 	// If the node contains the tanks current position
-	if (/*node[nodeX][nodeY].getBorder().contains(sf::Vector2f(pos.getX(), pos.getY()))*/ pos.getX() > nodeWorldPos.x - 1.75f && pos.getX() < nodeWorldPos.x + 1.75f && pos.getY() > nodeWorldPos.y - 1.75f && pos.getY() < nodeWorldPos.y + 1.75f)
+	if (/*node[nodeX][nodeY].getBorder().contains(sf::Vector2f(pos.getX(), pos.getY()))*/ pos.getX() > nodeWorldPos.x - fReach && pos.getX() < nodeWorldPos.x + fReach && pos.getY() > nodeWorldPos.y - fReach && pos.getY() < nodeWorldPos.y + fReach)
 	{
 		node[nodeX][nodeY].setIfPath(false);
-		node[nodeX][nodeY].updateType(Object::UNKNOWN);
+		setObject(nodeX, nodeY, Object::UNKNOWN);
 		currentPath.pop_front(); // Remove the front node from the path list
 		if (!currentPath.empty()) // If there is still path to follow
 			nextNode = currentPath.front(); // Set the current value to the new front of the path list
@@ -369,13 +408,13 @@ sf::Vector2f Map::followPath(Position pos)
 	return nodeWorldPos;
 }
 
-sf::FloatRect Map::getNodeBox(int i, int j)
+sf::FloatRect Map::getNodeBox(int i, int j) const
 {
 	// Return the nodes floatrect
 	return node[i][j].getBorder();
 }
 
-Object Map::getNodeObject(int i, int j)
+Object Map::getNodeObject(int i, int j) const
 {
 	// Return the nodes object type
 	return node[i][j].getObjectType();
@@ -419,7 +458,7 @@ void Map::setMapTraversable()
 		for (int j = 0; j < s_kiNodes; j++)
 		{
 			// Set all values to false as a reset
-			vbAdjacencyMatrix[i][j] = false;
+			bsAdjacencyMatrix[i][j] = false;
 		}
 	}
 
@@ -439,7 +478,7 @@ void Map::setMapTraversable()
 					if (traversable(node[i - 1][j].getObjectType()))
 					{
 						// Set that in the adjacency matrix
-						vbAdjacencyMatrix[position][position - 1] = true;
+						bsAdjacencyMatrix[position][position - 1] = true;
 					}
 				}
 				// If the node is not at the far right
@@ -449,7 +488,7 @@ void Map::setMapTraversable()
 					if (traversable(node[i + 1][j].getObjectType()))
 					{
 						// Set that in the adjacency matrix
-						vbAdjacencyMatrix[position][position + 1] = true;
+						bsAdjacencyMatrix[position][position + 1] = true;
 					}
 				}
 				// If the node is not at the top
@@ -459,7 +498,7 @@ void Map::setMapTraversable()
 					if (traversable(node[i][j - 1].getObjectType()))
 					{
 						// Set that in the adjacency matrix
-						vbAdjacencyMatrix[position][position - s_kiWidth] = true;
+						bsAdjacencyMatrix[position][position - s_kiWidth] = true;
 					}
 				}
 				// If the node is not at the bottom
@@ -469,7 +508,7 @@ void Map::setMapTraversable()
 					if (traversable(node[i][j + 1].getObjectType()))
 					{
 						// Set that in the adjacency matrix
-						vbAdjacencyMatrix[position][position + s_kiWidth] = true;
+						bsAdjacencyMatrix[position][position + s_kiWidth] = true;
 					}
 				}
 				// If the node is not at the far left and not at the top
@@ -478,7 +517,7 @@ void Map::setMapTraversable()
 					if (traversable(node[i - 1][j - 1].getObjectType()))
 					{
 						// Set that in the adjacency matrix
-						vbAdjacencyMatrix[position][(position - s_kiWidth) - 1] = true;
+						bsAdjacencyMatrix[position][(position - s_kiWidth) - 1] = true;
 					}
 				}
 				// If the node is not at the far left and not at the bottom
@@ -487,7 +526,7 @@ void Map::setMapTraversable()
 					if (traversable(node[i - 1][j + 1].getObjectType()))
 					{
 						// Set that in the adjacency matrix
-						vbAdjacencyMatrix[position][(position + s_kiWidth) - 1] = true;
+						bsAdjacencyMatrix[position][(position + s_kiWidth) - 1] = true;
 					}
 				}
 				// If the node is not at the far right and not at the top
@@ -496,7 +535,7 @@ void Map::setMapTraversable()
 					if (traversable(node[i + 1][j - 1].getObjectType()))
 					{
 						// Set that in the adjacency matrix
-						vbAdjacencyMatrix[position][(position - s_kiWidth) + 1] = true;
+						bsAdjacencyMatrix[position][(position - s_kiWidth) + 1] = true;
 					}
 				}
 				// If the node is not at the far right and not at the bottom
@@ -505,7 +544,7 @@ void Map::setMapTraversable()
 					if (traversable(node[i + 1][j + 1].getObjectType()))
 					{
 						// Set that in the adjacency matrix
-						vbAdjacencyMatrix[position][(position + s_kiWidth) + 1] = true;
+						bsAdjacencyMatrix[position][(position + s_kiWidth) + 1] = true;
 					}
 				}
 			}
@@ -576,7 +615,7 @@ void Map::setAreaTraversable(int x1, int y1, int x2, int y2)
 		for (int j = startNode; j <= nodes; j++)
 		{
 			// Set all values being checked to false as a reset
-			vbAdjacencyMatrix[i][j] = false;
+			bsAdjacencyMatrix[i][j] = false;
 		}
 	}
 
@@ -596,7 +635,7 @@ void Map::setAreaTraversable(int x1, int y1, int x2, int y2)
 					if (traversable(node[i - 1][j].getObjectType()))
 					{
 						// Set that in the adjacency matrix
-						vbAdjacencyMatrix[position][position - 1] = true;
+						bsAdjacencyMatrix[position][position - 1] = true;
 					}
 				}
 				// If the node is not at the far right
@@ -606,7 +645,7 @@ void Map::setAreaTraversable(int x1, int y1, int x2, int y2)
 					if (traversable(node[i + 1][j].getObjectType()))
 					{
 						// Set that in the adjacency matrix
-						vbAdjacencyMatrix[position][position + 1] = true;
+						bsAdjacencyMatrix[position][position + 1] = true;
 					}
 				}
 				// If the node is not at the top
@@ -616,7 +655,7 @@ void Map::setAreaTraversable(int x1, int y1, int x2, int y2)
 					if (traversable(node[i][j - 1].getObjectType()))
 					{
 						// Set that in the adjacency matrix
-						vbAdjacencyMatrix[position][position - s_kiWidth] = true;
+						bsAdjacencyMatrix[position][position - s_kiWidth] = true;
 					}
 				}
 				// If the node is not at the bottom
@@ -626,7 +665,7 @@ void Map::setAreaTraversable(int x1, int y1, int x2, int y2)
 					if (traversable(node[i][j + 1].getObjectType()))
 					{
 						// Set that in the adjacency matrix
-						vbAdjacencyMatrix[position][position + s_kiWidth] = true;
+						bsAdjacencyMatrix[position][position + s_kiWidth] = true;
 					}
 				}
 				// If the node is not at the far left and not at the top
@@ -638,7 +677,7 @@ void Map::setAreaTraversable(int x1, int y1, int x2, int y2)
 						traversable(node[i][j - 1].getObjectType()))
 					{
 						// Set that in the adjacency matrix
-						vbAdjacencyMatrix[position][(position - s_kiWidth) - 1] = true;
+						bsAdjacencyMatrix[position][(position - s_kiWidth) - 1] = true;
 					}
 				}
 				// If the node is not at the far left and not at the bottom
@@ -650,7 +689,7 @@ void Map::setAreaTraversable(int x1, int y1, int x2, int y2)
 						traversable(node[i][j + 1].getObjectType()))
 					{
 						// Set that in the adjacency matrix
-						vbAdjacencyMatrix[position][(position + s_kiWidth) - 1] = true;
+						bsAdjacencyMatrix[position][(position + s_kiWidth) - 1] = true;
 					}
 				}
 				// If the node is not at the far right and not at the top
@@ -662,7 +701,7 @@ void Map::setAreaTraversable(int x1, int y1, int x2, int y2)
 						traversable(node[i][j - 1].getObjectType()))
 					{
 						// Set that in the adjacency matrix
-						vbAdjacencyMatrix[position][(position - s_kiWidth) + 1] = true;
+						bsAdjacencyMatrix[position][(position - s_kiWidth) + 1] = true;
 					}
 				}
 				// If the node is not at the far right and not at the bottom
@@ -674,7 +713,7 @@ void Map::setAreaTraversable(int x1, int y1, int x2, int y2)
 						traversable(node[i][j + 1].getObjectType()))
 					{
 						// Set that in the adjacency matrix
-						vbAdjacencyMatrix[position][(position + s_kiWidth) + 1] = true;
+						bsAdjacencyMatrix[position][(position + s_kiWidth) + 1] = true;
 					}
 				}
 			}
@@ -702,6 +741,9 @@ std::list<int> Map::aStarSearch(int currentX, int currentY, int goalX, int goalY
 
 	while (current != goal) // Repeat until reached goal node
 	{
+		// If every reachable node has been checked the goal can't be reached, so there is no path
+		if (open.empty()) return std::list<int>();
+
 		open.sort(); // Sort the open list
 		// Set the current node to the front node in the open list
 		currentNode = open.front();
@@ -713,7 +755,7 @@ std::list<int> Map::aStarSearch(int currentX, int currentY, int goalX, int goalY
 		for (int other = 0; other < s_kiNodes; other++)
 		{
 			// If current node to other node is traversable
-			if (vbAdjacencyMatrix[current][other])
+			if (bsAdjacencyMatrix[current][other])
 			{
 				std::list<MapNode>::iterator graphListIter; // Iterator to step through list
 				bool onClosed = false; // If the node is on the closed list
@@ -792,6 +834,9 @@ std::list<int> Map::dfsSearch(int currentX, int currentY, int goalX, int goalY)
 	// While hasn't reached the goal node
 	while (current != goal)
 	{
+		// If every reachable node has been checked the goal can't be reached, so there is no path
+		if (nodeStack.empty()) return std::list<int>();
+
 		// Current is the top node in the stack
 		currentNode = nodeStack.top();
 		nodeStack.pop(); // Remove the top node in the stack
@@ -802,7 +847,7 @@ std::list<int> Map::dfsSearch(int currentX, int currentY, int goalX, int goalY)
 		for (int other = 0; other < s_kiNodes; other++)
 		{
 			// If can move from current to other nodes
-			if (vbAdjacencyMatrix[current][other])
+			if (bsAdjacencyMatrix[current][other])
 			{
 				// If other hasn't been checked
 				if (!bVisited[other])
@@ -844,6 +889,9 @@ std::list<int> Map::bfsSearch(int currentX, int currentY, int goalX, int goalY)
 	// While hasn't reached the goal node
 	while (current != goal)
 	{
+		// If every reachable node has been checked the goal can't be reached, so there is no path
+		if (open.empty()) return std::list<int>();
+
 		// Current is the front node in the open list
 		currentNode = open.front();
 		open.pop_front(); // Remove the front node in the open list
@@ -854,7 +902,7 @@ std::list<int> Map::bfsSearch(int currentX, int currentY, int goalX, int goalY)
 		for (int other = 0; other < s_kiNodes; other++)
 		{
 			// If can move from current to other nodes
-			if (vbAdjacencyMatrix[current][other])
+			if (bsAdjacencyMatrix[current][other])
 			{
 				// If other hasn't been checked
 				if (!bVisited[other])
@@ -881,11 +929,14 @@ std::list<int> Map::buildPath(std::list<MapNode>& searched)
 	std::list<int> path;
 	int parent; // Index value of the parent node
 	std::list<MapNode>::iterator graphListIter; // To iterate through searched list
+	// Nothing was searched if the tank started on the goal node
+	if (searched.empty()) return path;
 	// Set the current node to the back node of the searched list
 	MapNode currentNode = searched.back();
 	parent = currentNode.iParentIndex; // Set parent to the parent index value of the current node
 	path.push_front(currentNode.iIndex); // Add the current index value to the path list
 	searched.pop_back(); // Remove the back node from the searched list
+	if (searched.empty()) return path;
 	// Iterate through the searched list
 	for (graphListIter = searched.end(), --graphListIter; graphListIter != searched.begin(); --graphListIter)
 	{
@@ -906,14 +957,32 @@ std::list<int> Map::buildPath(std::list<MapNode>& searched)
 	return path;
 }
 
-void Map::draw(sf::RenderTarget &target, sf::RenderStates states) const
+void Map::saveState(GameSnapshot &snapshot) const
 {
-	for (int i = 0; i < s_kiWidth; i++)
+	// Nodes and adjacency are flat arrays, so each goes in as one block
+	snapshot.write(node);
+	snapshot.write(bsAdjacencyMatrix);
+
+	int iPathLength = (int)currentPath.size();
+	snapshot.write(iPathLength);
+	for (std::list<int>::const_iterator graphListIter = currentPath.begin(); graphListIter != currentPath.end(); ++graphListIter)
 	{
-		for (int j = 0; j < s_kiHeight; j++)
-		{
-			// Draw each node
-			target.draw(node[i][j]);
-		}
+		snapshot.write(*graphListIter);
+	}
+}
+
+bool Map::loadState(GameSnapshot &snapshot)
+{
+	int iPathLength;
+	if (!snapshot.read(node) || !snapshot.read(bsAdjacencyMatrix) || !snapshot.read(iPathLength)) return false;
+
+	currentPath.clear();
+	for (int i = 0; i < iPathLength; i++)
+	{
+		int iNode;
+		if (!snapshot.read(iNode)) return false;
+		currentPath.push_back(iNode);
 	}
+	markAllChanged(); // Which nodes changed isn't kept, so anything built from them starts over
+	return true;
 }
\ No newline at end of file
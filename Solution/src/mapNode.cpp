@@ -8,26 +8,23 @@
 
 MapNode::MapNode(sf::Vector2f newPosition, sf::Vector2f newSize, Object type)
 {
-	// Sets everything for the debug rectangle
-	debugRect.setSize(newSize);
-	debugRect.setOrigin(sf::Vector2f(newSize.x / 2.f, newSize.y / 2.f));
-	debugRect.setPosition(newPosition);
-	debugRect.setFillColor(sf::Color(0, 0, 0, 0));
-	debugRect.setOutlineThickness(1.f);
-	debugRect.setOutlineColor(sf::Color(0, 0, 0, 135));
-
 	contains = type; // Sets the initial what is contained in the section
-	border = debugRect.getGlobalBounds(); // Set the border of the node to the rectangles global boundary (Relative to the world coordinates)
+	border = sf::FloatRect(newPosition - (newSize / 2.f) - sf::Vector2f(1.f, 1.f), newSize + sf::Vector2f(2.f, 2.f)); // Set the border of the node centred on its position, including the 1 pixel outline (Relative to the world coordinates)
+
+	// Search values are set when a search reaches the node, start them at nothing so every node is in a known state
+	fTotalCost = 0.f;
+	fHeuristicScore = 0.f;
+	fGeogScore = 0.f;
+	iIndex = -1;
+	iParentIndex = -1;
 
 	bPath = false;
-	resetColour();
+	bSeen = false;
 }
 
 void MapNode::updateType(Object newType)
 {
 	contains = newType; // Sets what is in the section when the tank sees it
-
-	resetColour(); // Set the nodes colour
 }
 
 Object MapNode::getObjectType() const
@@ -56,35 +53,4 @@ bool MapNode::operator<(const MapNode& other)
 void MapNode::setIfPath(bool is)
 {
 	bPath = is; // Set the stored bool if it is a path
-	if (bPath) // If it is
-		debugRect.setFillColor(sf::Color(255, 0, 0, 100)); // Set the debug rect to the path colour
-}
-
-void MapNode::resetColour()
-{
-	if (contains == Object::OWNBASE) // If it contains it's own base
-	{
-		debugRect.setFillColor(sf::Color(135, 0, 0, 100)); // Set the colour of the debug rectangle to red
-	}
-	if (contains == Object::PLAYERBASE || contains == Object::PLAYERTANK) // If it contains a player base or player tank
-	{
-		debugRect.setFillColor(sf::Color(0, 0, 135, 100)); // Set the colour of the debug rectangle to blue
-	}
-	if (contains == Object::PLAYERSHELL) // If it contains a player shell
-	{
-		debugRect.setFillColor(sf::Color(0, 100, 50, 100)); // Set the colour of the debug rectangle to green
-	}
-	if (contains == Object::UNKNOWN) // If it contains unknown
-	{
-		debugRect.setFillColor(sf::Color(0, 0, 0, 0)); // Set the colour of the debug rectangle to default
-	}
-	if (bPath) // If it is a path
-	{
-		debugRect.setFillColor(sf::Color(255, 0, 0, 100)); // Set the debug rect to the path colour
-	}
-}
-
-void MapNode::draw(sf::RenderTarget &target, sf::RenderStates states) const
-{
-	target.draw(debugRect); // Draw the debug rectangle
 }
\ No newline at end of file
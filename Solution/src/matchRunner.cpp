@@ -0,0 +1,69 @@
+/*! \file matchRunner.cpp
+* \brief Source file for the MatchRunner class.
+*
+* Contains the definitions for the MatchRunner class' constructor and methods.
+*/
+
+#include "matchRunner.h"
+#include "workStealingPool.h"
+#include "game.h"
+
+MatchRunner::MatchRunner(long lNewMaxTicks, int iNewTickScale, int iNewThreads, unsigned long long ullNewBaseSeed)
+{
+	lMaxTicks = lNewMaxTicks;
+	iTickScale = iNewTickScale < 1 ? 1 : iNewTickScale;
+	iThreads = iNewThreads;
+	ullBaseSeed = ullNewBaseSeed;
+}
+
+MatchResult MatchRunner::playMatch(int iMatch) const
+{
+	Game game(ullBaseSeed + (unsigned long long)iMatch);
+	game.setTickScale((unsigned short)iTickScale);
+
+	long lTicks = 0;
+	while (!game.gameOver() && lTicks < lMaxTicks)
+	{
+		game.play();
+		lTicks += iTickScale;
+	}
+
+	MatchResult result;
+	result.iMatch = iMatch;
+	result.ullSeed = game.getSeed();
+	result.lTicks = lTicks;
+	result.iRedScore = game.getRedScore();
+	result.iBlueScore = game.getBlueScore();
+	result.winner = WINNER_DRAW;
+	if (result.iRedScore > result.iBlueScore) result.winner = WINNER_RED;
+	if (result.iRedScore < result.iBlueScore) result.winner = WINNER_BLUE;
+	result.bFinished = game.gameOver();
+	return result;
+}
+
+std::vector<MatchResult> MatchRunner::run(int iMatches) const
+{
+	std::vector<MatchResult> results(iMatches < 0 ? 0 : iMatches);
+
+	// One task per match, each writes only its own row
+	WorkStealingPool pool(iThreads);
+	for (int i = 0; i < iMatches; i++)
+	{
+		pool.submit([this, &results, i] { results[i] = playMatch(i); });
+	}
+	pool.wait();
+
+	return results;
+}
+
+void MatchRunner::printTable(const std::vector<MatchResult> &results, FILE *file)
+{
+	static const char *s_kWinnerNames[] = { "RED", "BLUE", "DRAW" };
+
+	fprintf(file, "%6s %20s %9s %5s %5s %7s\n", "match", "seed", "ticks", "red", "blue", "winner");
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const MatchResult &r = results[i];
+		fprintf(file, "%6d %20llu %9ld %5d %5d %7s%s\n", r.iMatch, r.ullSeed, r.lTicks, r.iRedScore, r.iBlueScore, s_kWinnerNames[r.winner], r.bFinished ? "" : " (tick limit)");
+	}
+}
\ No newline at end of file
@@ -6,14 +6,17 @@
 
 #include "newTank.h"
 
+const float NewTank::kfBaseExtent = 20.f; // The width/height of a base
+const float NewTank::kfTankExtent = 40.f; // The width/height of a tank
+
 NewTank::NewTank()
 {
-	// Setting size and origin for player shell path, used for dodging
-	for (int i = 0; i < s_kiNumRectShellPath; i++)
-	{
-		shellPath[i].setSize(sf::Vector2f(kfShellPathExtent, kfShellPathExtent));
-		shellPath[i].setOrigin(sf::Vector2f(kfShellPathExtent/2, kfShellPathExtent/2));
-	}
+	// No shells seen yet
+	threat.iShell = -1;
+	threat.fTime = threat.fDistance = threat.fMissX = threat.fMissY = 0.f;
+
+	// Marks go onto the tank's own map until the game gives it a team grid
+	knowledge = nullptr;
 
 	// Default position of closest enemy when no enemy is seen, preventing it aiming towards something not there
 	closestEnemyPos = noEnemySeenPos;
@@ -21,13 +24,37 @@ NewTank::NewTank()
 	// Default states
 	iMovementState = AIMovementStates::SEARCHING;
 	iWeaponState = AIWeaponStates::SEARCHINGAIM;
+	iPrevMovementState = -1; // No state yet, so the first frame runs the entry actions
+	iPrevWeaponState = -1;
+	for (int i = 0; i < s_kiNumMovementStates; i++) uiStateEntries[i] = uiStateTimesteps[i] = 0;
+	for (int i = 0; i < s_kiNumWeaponStates; i++) uiWeaponStateEntries[i] = uiWeaponStateTimesteps[i] = 0;
+	iClosestEnemyObject = Object::UNKNOWN;
+	fAngleDiff = 0.f;
+	fDistanceToTarget = 0.f;
+	bFiring = false;
+	bDodging = false;
+	bCanSeeEnemyTank = false;
+	bCanSeeEnemyBase = false;
 
 	// Resetting tank
 	reset();
 }
 
+void NewTank::selectTarget()
+{
+	// Aims at the best of everything sensed since the last move, if anything was
+	int iBest = targets.best(getX(), getY(), getTurretTh(), params.targetUtility());
+	if (iBest < 0) return;
+
+	closestEnemyPos = sf::Vector2f(targets.getX(iBest), targets.getY(iBest));
+	iClosestEnemyObject = targets.getType(iBest);
+}
+
 void NewTank::setTargetInfo()
 {
+	// Chooses the target
+	selectTarget();
+
 	// Vector distance between AI tank and target
 	closestEnemyPosDiff = (sf::Vector2f(getX(), getY()) - closestEnemyPos);
 
@@ -47,6 +74,10 @@ void NewTank::checkVision()
 	bCanSeeEnemyTank = false;
 	bCanSeeEnemyBase = false;
 
+	// Works out where every shell seen will pass, and dodges the one that will come close soonest
+	threat = shellThreats.mostUrgent(getX(), getY(), params.fThreatRadius, params.fThreatHorizon);
+	bDodging = shellThreatened();
+
 	// If the AI tank can see an enemy player or base, it will set the bools to true, checks every node in map
 	for (int i = 0; i < map.getWidth(); i++)
 	{
@@ -57,14 +88,14 @@ void NewTank::checkVision()
 
 			box.set(nodeBox.left, nodeBox.top, nodeBox.left + nodeBox.width, nodeBox.top + nodeBox.height); // Set the bounding box for the area to check
 
-			// If can see an enemy tank
-			if (canSee(box) && (map.getNodeObject(i, j) == Object::PLAYERTANK))
+			// If can see an enemy tank, the type is checked first as most nodes are empty and canSee is the slow part
+			if ((map.getNodeObject(i, j) == Object::PLAYERTANK) && canSee(box))
 			{
 				bCanSeeEnemyTank = true;
 			}
 
 			// If can see an enemy base
-			if (canSee(box) && (map.getNodeObject(i, j) == Object::PLAYERBASE))
+			if ((map.getNodeObject(i, j) == Object::PLAYERBASE) && canSee(box))
 			{
 				bCanSeeEnemyBase = true;
 				//std::cout << "base is visible" << std::endl;
@@ -74,7 +105,7 @@ void NewTank::checkVision()
 
 	if (!bCanSeeEnemyTank)
 	{
-		iLostPlayerTankFrames++;
+		iLostPlayerTankFrames += getStepTicks();
 	}
 	else
 	{
@@ -83,384 +114,403 @@ void NewTank::checkVision()
 	//std::cout << iLostPlayerTankFrames << std::endl;
 }
 
-void NewTank::setStateMachineConditions()
+void NewTank::updateInfluence()
 {
-	// Higher priority states go before lower priority states. See newTank.h for priority list.
-
-	// If in a seen shell path's node, dodge.
-	if (map.getNodeObject(currentNode.x, currentNode.y) == Object::PLAYERSHELL)
+	// Enemy tanks and bases stay on the map where they were last seen, own bases once found, so they are sources and only the nodes that changed are set again
+	for (int n = 0; n < map.numChanged(); n++)
 	{
-		// Sets movement state to dodging
-		iMovementState = AIMovementStates::DODGING;
+		sf::Vector2i node = map.getChanged(n);
+		Object type = map.getNodeObject(node.x, node.y);
+		influence.setSource(InfluenceMap::THREAT, node.x, node.y, type == Object::PLAYERTANK ? params.fTankThreat : 0.f);
+		influence.setSource(InfluenceMap::TARGET, node.x, node.y, type == Object::PLAYERBASE ? params.fBaseTarget : 0.f);
+		influence.setSource(InfluenceMap::HOME, node.x, node.y, type == Object::OWNBASE ? params.fBaseHome : 0.f);
 	}
+	map.clearChanged();
 
-	// If the AI tank can see an enemy tank and has no ammo, attempt to escape to another corner of the map.
-	else if ((bCanSeeEnemyTank && !hasAmmo()) || ((currentNode != goalNode) && (iMovementState == AIMovementStates::ESCAPING)))
+	// Every shell seen makes the nodes along its path dangerous, from where it is now to the dodging horizon
+	sf::FloatRect first = map.getNodeBox(0, 0);
+	sf::FloatRect last = map.getNodeBox(map.getWidth() - 1, map.getHeight() - 1);
+	for (int n = 0; n < shellThreats.size(); n++)
 	{
-		// Sets movement state to escaping
-		iMovementState = AIMovementStates::ESCAPING;
-	}
-
-	// If the AI tank has no ammo, attempt to hide in the corner of the map.
-	else if ((!hasAmmo() && (iMovementState != AIMovementStates::ESCAPING)) || ((iMovementState == AIMovementStates::ESCAPING) && (goalNode == currentNode)))
-	{
-		// Sets movement state to hiding
-		iMovementState = AIMovementStates::HIDING;
-	}
-
-	// If the AI tank can see an enemy tank or enemy base, stop and shoot at it. Rotates perpendicular to the enemy object if it is a player tank.
-	else if ((bCanSeeEnemyTank || bCanSeeEnemyBase) && ((!(iMovementState == AIMovementStates::FOLLOWING)) || (iFollowingFrameCount > kiFollowingMinFrameCount)))
-	{
-		// Sets movement state to stopping
-		iMovementState = AIMovementStates::STOPPING;
-	}
-
-	// If an enemy has left the AI tank's vision, will check last seen location. Leaves state when it reaches the last seen location.
-	else if (((iMovementState == AIMovementStates::STOPPING) || (iMovementState == AIMovementStates::FOLLOWING)) && !(bCanSeeEnemyTank) && !(bCanSeeEnemyBase) && (goalNode != currentNode))
-	{
-		// Sets movement state to following
-		if (iLostPlayerTankFrames >= kiLostPlayerMinFrameCount)
+		for (int k = 0; k < s_kiShellThreatPoints; k++)
 		{
-			iMovementState = AIMovementStates::FOLLOWING;
-		}
+			float fTime = params.fThreatHorizon * k / (s_kiShellThreatPoints - 1);
+			float fX = shellThreats.getX(n) + shellThreats.getVx(n) * fTime;
+			float fY = shellThreats.getY(n) + shellThreats.getVy(n) * fTime;
+			if (fX < first.left || fY < first.top || fX >= last.left + last.width || fY >= last.top + last.height) break; // Off the map, so gone
 
-		// To prevent lag if rapid transitioning between FOLLOWING and STOPPING states.
-		else
-		{
-			iMovementState = AIMovementStates::STOPPING;
+			sf::Vector2i node = calcNodePos(fX, fY);
+			influence.stamp(InfluenceMap::THREAT, node.x, node.y, params.fShellThreat);
 		}
 	}
 
-	else
-	{
-		// Default state, tank searches around the map randomly
-		iMovementState = AIMovementStates::SEARCHING;
-	}
+	influence.update();
 }
 
-void NewTank::moveStateMachineActions()
+/*! \struct NewTankStates
+* \brief The NewTank state machine tables.
+*
+* Built at compile time, the dispatchers in setStateMachineConditions, moveStateMachineActions and turretStateMachineActions only walk them.
+*/
+struct NewTankStates
 {
-	// AI tank calculates goal nodes and moves depending on its state here.
-	switch (iMovementState)
-	{
-
-	// If dodging
-	case DODGING:
+	typedef bool (NewTank::*Guard)() const; //!< Condition for a transition.
+	typedef void (NewTank::*Action)(); //!< Action of a state, null for none.
 
-		// Search with turret
-		iWeaponState = AIWeaponStates::SEARCHINGAIM;
-
-		// If first frame of dodging, makes tank dodge forward. Dodging doesn't calculate a new path, as the tank would not have enough time to dodge a projectile if it did so.
-		if (iMovementState != iPrevMovementState)
-		{
-			goForward();
+	//! A movement transition, taken if its guard passes and no earlier one did.
+	struct Transition
+	{
+		Guard guard; //!< Condition to take it.
+		int iState; //!< Movement state it leads to.
+	};
 
-			// std::cout << "Enemy projectile inbound, dodging." << std::endl;
-		}
-		break;
+	//! What a movement state does.
+	struct MovementState
+	{
+		int iWeaponState; //!< Turret state used while in it.
+		bool bEntryAtGoal; //!< Run the entry action again on reaching the goal node.
+		Action onEntry; //!< Run on the first frame in the state.
+		Action onUpdate; //!< Run every frame in the state, after the entry action.
+	};
+
+	//! Movement transitions in priority order, see newTank.h for the priority list.
+	static constexpr Transition s_kTransitions[] = {
+		{ &NewTank::shellThreatened, NewTank::DODGING },
+		{ &NewTank::shouldEscape, NewTank::ESCAPING },
+		{ &NewTank::shouldHide, NewTank::HIDING },
+		{ &NewTank::shouldStop, NewTank::STOPPING },
+		{ &NewTank::lostTargetForLong, NewTank::FOLLOWING },
+		{ &NewTank::lostTarget, NewTank::STOPPING }, // To prevent lag if rapid transitioning between FOLLOWING and STOPPING states.
+		{ &NewTank::always, NewTank::SEARCHING }
+	};
+
+	//! Movement states, in AIMovementStates order. STUCK only lasts until the next frame's transitions, so it has no actions.
+	static constexpr MovementState s_kMovementStates[] = {
+		{ NewTank::SEARCHINGAIM, false, nullptr, &NewTank::dodgeUpdate }, // DODGING
+		{ NewTank::SEARCHINGAIM, true, &NewTank::escapeEntry, nullptr }, // ESCAPING
+		{ NewTank::SEARCHINGAIM, false, &NewTank::hideEntry, &NewTank::hideUpdate }, // HIDING
+		{ NewTank::AIMING, false, &NewTank::stopEntry, &NewTank::stopUpdate }, // STOPPING
+		{ NewTank::SEARCHINGAIM, false, nullptr, &NewTank::followUpdate }, // FOLLOWING
+		{ NewTank::SEARCHINGAIM, true, &NewTank::searchEntry, nullptr }, // SEARCHING
+		{ NewTank::SEARCHINGAIM, false, nullptr, nullptr } // STUCK
+	};
+
+	//! Turret state actions, in AIWeaponStates order.
+	static constexpr Action s_kWeaponStates[] = {
+		&NewTank::searchAimUpdate, // SEARCHINGAIM
+		&NewTank::aimUpdate // AIMING
+	};
+
+	static_assert(sizeof(s_kMovementStates) / sizeof(s_kMovementStates[0]) == NewTank::s_kiNumMovementStates, "One row per movement state");
+	static_assert(sizeof(s_kWeaponStates) / sizeof(s_kWeaponStates[0]) == NewTank::s_kiNumWeaponStates, "One row per turret state");
+};
+
+constexpr NewTankStates::Transition NewTankStates::s_kTransitions[];
+constexpr NewTankStates::MovementState NewTankStates::s_kMovementStates[];
+constexpr NewTankStates::Action NewTankStates::s_kWeaponStates[];
+
+const char *NewTank::movementStateName(int iState)
+{
+	static const char *s_kNames[s_kiNumMovementStates] = { "DODGING", "ESCAPING", "HIDING", "STOPPING", "FOLLOWING", "SEARCHING", "STUCK" };
+	return iState >= 0 && iState < s_kiNumMovementStates ? s_kNames[iState] : "?";
+}
 
-	// If escaping
-	case ESCAPING:
+const char *NewTank::weaponStateName(int iState)
+{
+	static const char *s_kNames[s_kiNumWeaponStates] = { "SEARCHINGAIM", "AIMING" };
+	return iState >= 0 && iState < s_kiNumWeaponStates ? s_kNames[iState] : "?";
+}
 
-		// Search with turret
-		iWeaponState = AIWeaponStates::SEARCHINGAIM;
+void NewTank::setStateMachineConditions()
+{
+	// Higher priority states go before lower priority states, the last guard always passes
+	const NewTankStates::Transition *transition = NewTankStates::s_kTransitions;
+	while (!(this->*transition->guard)()) transition++;
 
-		// If first frame of escaping or is on its goal node, calculate new path to the next corner in the map.
-		if ((iMovementState != iPrevMovementState) || (goalNode == currentNode))
-		{
-			// If at top left corner of map, escape to bottom left corner.
-			if ((currentNode.x < floor((map.getWidth() / 2) - 1)) && (currentNode.y < floor((map.getHeight() / 2) - 1)))
-			{
-				goalNode = sf::Vector2i(1, map.getHeight() - 2);
-			}
+	iMovementState = transition->iState;
+}
 
-			// If at top right corner of the map, escape to top left corner.
-			if ((currentNode.x >= floor(map.getWidth() / 2)) && (currentNode.y < floor((map.getHeight() / 2) - 1)))
-			{
-				goalNode = sf::Vector2i(1, 1);
-			}
+bool NewTank::shouldEscape() const
+{
+	// If the AI tank can see an enemy tank and has no ammo, attempt to escape to another corner of the map.
+	return (bCanSeeEnemyTank && !hasAmmo()) || ((currentNode != goalNode) && (iMovementState == AIMovementStates::ESCAPING));
+}
 
-			// If at bottom right corner of the map, escape to top right corner.
-			if ((currentNode.x >= floor(map.getWidth() / 2)) && (currentNode.y >= floor(map.getHeight() / 2)))
-			{
-				goalNode = sf::Vector2i(map.getWidth() - 2, 1);
-			}
+bool NewTank::shouldHide() const
+{
+	// If the AI tank has no ammo, attempt to hide in the corner of the map.
+	return (!hasAmmo() && (iMovementState != AIMovementStates::ESCAPING)) || ((iMovementState == AIMovementStates::ESCAPING) && (goalNode == currentNode));
+}
 
-			// If at bottom left corner of the map, escape to bottom right corner.
-			if ((currentNode.x < floor((map.getWidth() / 2) - 1)) && (currentNode.y >= floor(map.getHeight() / 2)))
-			{
-				goalNode = sf::Vector2i(map.getWidth() - 2, map.getHeight() - 2);
-			}
+bool NewTank::shouldStop() const
+{
+	// If the AI tank can see an enemy tank or enemy base, stop and shoot at it. Rotates perpendicular to the enemy object if it is a player tank.
+	return (bCanSeeEnemyTank || bCanSeeEnemyBase) && ((!(iMovementState == AIMovementStates::FOLLOWING)) || (iFollowingFrameCount > params.iFollowingMinFrameCount));
+}
 
+bool NewTank::lostTarget() const
+{
+	// If an enemy has left the AI tank's vision, will check last seen location. Leaves state when it reaches the last seen location.
+	return ((iMovementState == AIMovementStates::STOPPING) || (iMovementState == AIMovementStates::FOLLOWING)) && !(bCanSeeEnemyTank) && !(bCanSeeEnemyBase) && (goalNode != currentNode);
+}
 
-			// Random node on map away from player is escape destination.
-			/*if ((currentNode.x < calcNodePos(closestEnemyPos.x, closestEnemyPos.y).x) && (currentNode.y < calcNodePos(closestEnemyPos.x, closestEnemyPos.y).y))
-			{
-				goalNode = sf::Vector2i(rand() % currentNode.x + 1, rand() % currentNode.y + 1);
-				std::cout << "Running to top left" << std::endl;
-			}
-			else if ((currentNode.x >= calcNodePos(closestEnemyPos.x, closestEnemyPos.y).x) && (currentNode.y < calcNodePos(closestEnemyPos.x, closestEnemyPos.y).y))
-			{
-				goalNode = sf::Vector2i((map.getWidth() - currentNode.x + 1), rand() % currentNode.y + 1);
-				std::cout << "Running top right" << std::endl;
-			}
-			else if ((currentNode.x >= calcNodePos(closestEnemyPos.x, closestEnemyPos.y).x) && (currentNode.y >= calcNodePos(closestEnemyPos.x, closestEnemyPos.y).y))
-			{
-				goalNode = sf::Vector2i((rand() % (map.getWidth() - currentNode.x + 1)) + currentNode.x, (rand() % (map.getHeight() - currentNode.y + 1)) + currentNode.y);
-				std::cout << "Running to bottom right" << std::endl;
-			}
-			else if ((currentNode.x < calcNodePos(closestEnemyPos.x, closestEnemyPos.y).x) && (currentNode.y >= calcNodePos(closestEnemyPos.x, closestEnemyPos.y).y))
-			{
-				goalNode = sf::Vector2i(rand() % currentNode.x + 1, (map.getHeight() - currentNode.y + 1));
-				std::cout << "Running to bottom left" << std::endl;
-			}
-			else
-			{
-				std::cout << "Error" << std::endl;
-			}*/
+bool NewTank::lostTargetForLong() const
+{
+	return lostTarget() && (iLostPlayerTankFrames >= params.iLostPlayerMinFrameCount);
+}
 
-			// std::cout << "Player spotted and there is no ammo, escaping." << std::endl;
-		}
-		break;
+void NewTank::moveStateMachineActions()
+{
+	// AI tank calculates goal nodes and moves depending on its state here.
+	const NewTankStates::MovementState &state = NewTankStates::s_kMovementStates[iMovementState];
+	bool bEntered = iMovementState != iPrevMovementState;
 
-	// If hiding
-	case HIDING:
+	if (bEntered) uiStateEntries[iMovementState]++;
+	uiStateTimesteps[iMovementState]++;
 
-		// Search with turret to find potential threats
-		iWeaponState = AIWeaponStates::SEARCHINGAIM;
+	iWeaponState = state.iWeaponState;
+	if (state.onEntry && (bEntered || (state.bEntryAtGoal && (goalNode == currentNode)))) (this->*state.onEntry)();
+	if (state.onUpdate) (this->*state.onUpdate)();
 
-		// If first frame of hiding, calculate new path.
-		if (iMovementState != iPrevMovementState)
-		{
-			// Finds closest corner of the map to the tank, and sets the goal node to that corner.
-			// Path to top left corner
-			if ((currentNode.x < floor((map.getWidth() / 2) - 1)) && (currentNode.y < floor((map.getHeight() / 2) - 1)))
-			{
-				goalNode = sf::Vector2i(1, 1);
-			}
+	// If state or goal node has changed
+	if (((iPrevMovementState != iMovementState) || (goalNode != prevGoalNode)) && (goalNode != currentNode) && (iMovementState != AIMovementStates::DODGING))
+	{
+		// Calculate new path to new goal node
+		map.makeNewPath(getX(), getY(), goalNode);
+	}
 
-			// Path to top right corner
-			if ((currentNode.x >= floor(map.getWidth() / 2)) && (currentNode.y < floor((map.getHeight() / 2) - 1)))
-			{
-				goalNode = sf::Vector2i(map.getWidth() - 2, 1);
-			}
+	// Checks if tank is stuck when it should be moving, making it calculate a new path next frame to avoid object it is stuck on.
+	checkStuck();
 
-			// Path to bottom right corner
-			if ((currentNode.x >= floor(map.getWidth() / 2)) && (currentNode.y >= floor(map.getHeight() / 2)))
-			{
-				goalNode = sf::Vector2i(map.getWidth() - 2, map.getHeight() - 2);
-			}
+	// Resets previous variables that are used to check for differences in states.
+	iPrevMovementState = iMovementState;
+	prevNode = currentNode;
+	prevGoalNode = goalNode;
+}
 
-			// Path to bottom left corner
-			if ((currentNode.x < floor((map.getWidth() / 2) - 1)) && (currentNode.y >= floor(map.getHeight() / 2)))
-			{
-				goalNode = sf::Vector2i(1, map.getHeight() - 2);
-			}
-			// std::cout << "No ammo left, hiding." << std::endl;
-		}
+int NewTank::mapQuadrant() const
+{
+	bool bLeft = currentNode.x < floor((map.getWidth() / 2) - 1);
+	bool bRight = currentNode.x >= floor(map.getWidth() / 2);
+	bool bTop = currentNode.y < floor((map.getHeight() / 2) - 1);
+	bool bBottom = currentNode.y >= floor(map.getHeight() / 2);
+
+	if (bLeft && bTop) return 0;
+	if (bRight && bTop) return 1;
+	if (bRight && bBottom) return 2;
+	if (bLeft && bBottom) return 3;
+	return -1; // On a dividing line, so in no corner
+}
 
-		// If at goal node, stops tank from moving and rotating.
-		if (goalNode == currentNode)
-		{
-			stop();
-		}
+sf::Vector2i NewTank::mapCorner(int iCorner) const
+{
+	switch (iCorner)
+	{
+	case 0: return sf::Vector2i(1, 1);
+	case 1: return sf::Vector2i(map.getWidth() - 2, 1);
+	case 2: return sf::Vector2i(map.getWidth() - 2, map.getHeight() - 2);
+	default: return sf::Vector2i(1, map.getHeight() - 2);
+	}
+}
 
-		break;
+void NewTank::dodgeUpdate()
+{
+	// Drive whichever way along the tank's heading takes it away from where the shell will pass. Dodging doesn't calculate a new path, as the tank would not have enough time to dodge a projectile if it did so.
+	float thRad = DEG2RAD(getTh());
+	if (cos(thRad) * threat.fMissX + sin(thRad) * threat.fMissY >= 0.f) goForward();
+	else goBackward();
+}
 
-	// If stopping
-	case STOPPING:
+void NewTank::escapeEntry()
+{
+	// Escape to the safest node. With nothing known, escape to the next corner anticlockwise, top left to bottom left and so on round.
+	sf::Vector2i safe;
+	if (influence.bestSafeCell(map, currentNode, safe))
 	{
-		// Aim at closest target with turret
-		iWeaponState = AIWeaponStates::AIMING;
+		goalNode = safe;
+		return;
+	}
+	int iQuadrant = mapQuadrant();
+	if (iQuadrant >= 0) goalNode = mapCorner((iQuadrant + 3) % 4);
+}
 
-		// Resets following frame count to 0
-		iFollowingFrameCount = 0;
+void NewTank::hideEntry()
+{
+	// Hide in the safest node. With nothing known, hide in the closest corner of the map.
+	sf::Vector2i safe;
+	if (influence.bestSafeCell(map, currentNode, safe))
+	{
+		goalNode = safe;
+		return;
+	}
+	int iQuadrant = mapQuadrant();
+	if (iQuadrant >= 0) goalNode = mapCorner(iQuadrant);
+}
 
-		// Rotate 90 degrees perpendicular to target to aid in dodging
-		float fDodgeAngle = calcAngle(sf::Vector2f(pos.getX(), pos.getY()) - closestEnemyPos) + 180.f;
+void NewTank::hideUpdate()
+{
+	// If at goal node, stops tank from moving and rotating.
+	if (goalNode == currentNode)
+	{
+		stop();
+	}
+}
 
-		// Sort it out
-		if (fDodgeAngle >= 360)
-		{
-			fDodgeAngle -= 360;
-		}
+void NewTank::stopEntry()
+{
+	// Calculate new path to enemy location, which will be used in the FOLLOWING state.
+	goalNode = calcNodePos(closestEnemyPos.x, closestEnemyPos.y);
+}
 
-		// If not angled the right way, and its a player tank that is being aimed at
-		if ((!(fDodgeAngle >= pos.getTh() - 1.75f && fDodgeAngle <= pos.getTh() + 1.75f)) && (iClosestEnemyObject == Object::PLAYERTANK)) // If not facing the correct way
-		{
-			// Rotates tank left until perpendicular
-			if (fDodgeAngle < pos.getTh())
-			{
-				goLeft(); // Turn left
-				//std::cout << "Turning left" << std::endl;
-			}
+void NewTank::stopUpdate()
+{
+	// Resets following frame count to 0
+	iFollowingFrameCount = 0;
 
-			// Rotates tank right until perpendicular
-			if (fDodgeAngle > pos.getTh())
-			{
-				goRight(); // Turn right
-			}
+	// Rotate 90 degrees perpendicular to target to aid in dodging
+	float fDodgeAngle = calcAngle(sf::Vector2f(getX(), getY()) - closestEnemyPos) + 180.f;
 
-			// Same thing but for going across the 359-0 direction
-			if (pos.getTh() < 90 && fDodgeAngle > 270)
-			{
-				goLeft();
-				//std::cout << "Turning left" << std::endl;
-			}
+	// Sort it out
+	if (fDodgeAngle >= 360)
+	{
+		fDodgeAngle -= 360;
+	}
 
-			if (pos.getTh() > 270 && fDodgeAngle < 90)
-			{
-				goRight();
-			}
-		}
-		else
+	// If not angled the right way, and its a player tank that is being aimed at. At coarse tick scales the window is half a move's turn, so the body can't step over it
+	float fDodgeLimit = std::max(1.75f, stepTurn() / 2.f);
+	if ((!(fDodgeAngle >= getTh() - fDodgeLimit && fDodgeAngle <= getTh() + fDodgeLimit)) && (iClosestEnemyObject == Object::PLAYERTANK)) // If not facing the correct way
+	{
+		// Rotates tank left until perpendicular
+		if (fDodgeAngle < getTh())
 		{
-			// Stop turning
-			left = false;
-			right = false;
+			goLeft(); // Turn left
 		}
 
-		// If first frame of stopping, calculate new path to enemy location, which will be used in the FOLLOWING state.
-		if (iMovementState != iPrevMovementState)
+		// Rotates tank right until perpendicular
+		if (fDodgeAngle > getTh())
 		{
-			goalNode = calcNodePos(closestEnemyPos.x, closestEnemyPos.y);
-			// std::cout << "Enemy object spotted, stopping and aiming." << std::endl;
+			goRight(); // Turn right
 		}
 
-		// If target to follow is not in the goal node any more, calculate new path to the new enemy location.
-		if (closestEnemyPos != noEnemySeenPos)
+		// Same thing but for going across the 359-0 direction
+		if (getTh() < 90 && fDodgeAngle > 270)
 		{
-			if (goalNode.x <= calcNodePos(closestEnemyPos.x, closestEnemyPos.y).x - 2
-				|| goalNode.x >= calcNodePos(closestEnemyPos.x, closestEnemyPos.y).x + 2
-				|| goalNode.y <= calcNodePos(closestEnemyPos.x, closestEnemyPos.y).y - 2
-				|| goalNode.y >= calcNodePos(closestEnemyPos.x, closestEnemyPos.y).y + 2)
-			{
-				goalNode = calcNodePos(closestEnemyPos.x, closestEnemyPos.y);
-				// std::cout << "Enemy object spotted, stopping and aiming." << std::endl;
-			}
+			goLeft();
 		}
-	}
-	break;
-	
-	// If following
-	case FOLLOWING:
-
-		// Search with turret
-		iWeaponState = AIWeaponStates::SEARCHINGAIM;
-
-		// Increments FOLLOWING frame count
-		iFollowingFrameCount++;
 
-		// Used for debugging
-		/*if (iMovementState != iPrevMovementState)
+		if (getTh() > 270 && fDodgeAngle < 90)
 		{
-			//goalNode = calcNodePos(closestEnemyPos.x, closestEnemyPos.y);
-			// std::cout << "Enemy object lost, searching at last known location." << std::endl;
-		}*/
-
-		break;
-
-	// If searching
-	case SEARCHING:
-
-		// Search with turret
-		iWeaponState = AIWeaponStates::SEARCHINGAIM;
+			goRight();
+		}
+	}
+	else
+	{
+		// Stop turning
+		left = false;
+		right = false;
+	}
 
-		// If first frame of searching or reached the goal node, calculate a new path to random node on the map
-		if ((iMovementState != iPrevMovementState) || (currentNode == goalNode))
+	// If target to follow is not in the goal node any more, calculate new path to the new enemy location.
+	if (closestEnemyPos != noEnemySeenPos)
+	{
+		sf::Vector2i enemyNode = calcNodePos(closestEnemyPos.x, closestEnemyPos.y);
+		if (goalNode.x <= enemyNode.x - 2
+			|| goalNode.x >= enemyNode.x + 2
+			|| goalNode.y <= enemyNode.y - 2
+			|| goalNode.y >= enemyNode.y + 2)
 		{
-			goalNode = sf::Vector2i(rand() % (map.getWidth() / 2), rand() % map.getHeight());
-			// std::cout << "Searching for enemies." << std::endl;
+			goalNode = enemyNode;
 		}
-		break;
 	}
+}
 
-	// If state or goal node has changed
-	if (((iPrevMovementState != iMovementState) || (goalNode != prevGoalNode)) && (goalNode != currentNode) && (iMovementState != AIMovementStates::DODGING))
-	{
-		//std::cout << goalNode.x << ", " << goalNode.y;
+void NewTank::followUpdate()
+{
+	// Increments FOLLOWING frame count
+	iFollowingFrameCount += getStepTicks();
+}
 
-		// Calculate new path to new goal node
-		map.makeNewPath(pos.getX(), pos.getY(), goalNode);
+void NewTank::searchEntry()
+{
+	// Head for the best node to attack from, unless already there with nothing in sight
+	sf::Vector2i attack;
+	if (influence.bestAttackCell(map, currentNode, attack) && (attack != currentNode))
+	{
+		goalNode = attack;
+		return;
 	}
 
-	// Checks if tank is stuck when it should be moving, making it calculate a new path next frame to avoid object it is stuck on.
-	checkStuck();
-
-	// Resets previous variables that are used to check for differences in states.
-	iPrevMovementState = iMovementState;
-	prevNode = currentNode;
-	prevGoalNode = goalNode;
+	// Calculate a new path to random node on the map
+	goalNode = sf::Vector2i(random->range(map.getWidth() / 2), random->range(map.getHeight()));
 }
 
 void NewTank::turretStateMachineActions()
 {
-
 	// Depending on weapon state, aims or searches with turret
-	switch (iWeaponState)
-	{
-	
-	// If aiming
-	case AIMING:
+	if (iWeaponState != iPrevWeaponState) uiWeaponStateEntries[iWeaponState]++;
+	uiWeaponStateTimesteps[iWeaponState]++;
+	iPrevWeaponState = iWeaponState;
 
-		// Prevents firing whilst aiming and not aimed
-		if (bFiring)
-		{
-			bFiring = false;
-		}
+	(this->*NewTankStates::s_kWeaponStates[iWeaponState])();
+}
 
-		// Rotates turret towards target
-		//comparePositions(sf::Vector2f(getX(), getY()),)
-		aimTurret();
+void NewTank::aimUpdate()
+{
+	// Prevents firing whilst aiming and not aimed
+	if (bFiring)
+	{
+		bFiring = false;
+	}
 
-		// If aimed correctly, fire turret
-		if (((fAngleDiff >= turretTh - 1) && (fAngleDiff <= turretTh + 1) && fDistanceToTarget < kfViewDistance) && (!bFiring))
-		{
-			bFiring = true;
-		}
-		break;
+	// Rotates turret towards target
+	aimTurret();
 
-	// If searching
-	case SEARCHINGAIM:
+	// If aimed correctly, fire turret. The window is at least half a move's turn, so a turret turning several ticks a move can't step over it
+	float fAimLimit = std::max(1.f, stepTurretTurn() / 2.f);
+	if (((fAngleDiff >= getTurretTh() - fAimLimit) && (fAngleDiff <= getTurretTh() + fAimLimit) && fDistanceToTarget < params.fViewDistance) && (!bFiring))
+	{
+		bFiring = true;
+	}
+}
 
-		// Prevents firing whilst searching
-		if (bFiring)
-		{
-			bFiring = false;
-		}
+void NewTank::searchAimUpdate()
+{
+	// Prevents firing whilst searching
+	if (bFiring)
+	{
+		bFiring = false;
+	}
 
-		if (left)
-		{
-			iLeftFrames++;
-			iRightFrames = 0;
-		}
+	if (left)
+	{
+		iLeftFrames += getStepTicks();
+		iRightFrames = 0;
+	}
 
-		else if (right)
-		{
-			iRightFrames++;
-			iLeftFrames = 0;
-		}
+	else if (right)
+	{
+		iRightFrames += getStepTicks();
+		iLeftFrames = 0;
+	}
 
-		// Rotates turret left if tank is turning left, allowing for more vision to be covered in smaller amount of time.
-		if (iLeftFrames > kiTurningMinFrameCount)
-		{
-			turretGoLeft();
-		}
+	// Rotates turret left if tank is turning left, allowing for more vision to be covered in smaller amount of time.
+	if (iLeftFrames > params.iTurningMinFrameCount)
+	{
+		turretGoLeft();
+	}
 
-		// Rotates turret right if tank is turning right, allowing for more vision to be covered in smaller amount of time.
-		if (iRightFrames > kiTurningMinFrameCount)
-		{
-			turretGoRight();
-		}
+	// Rotates turret right if tank is turning right, allowing for more vision to be covered in smaller amount of time.
+	if (iRightFrames > params.iTurningMinFrameCount)
+	{
+		turretGoRight();
+	}
 
-		// Makes turret turn left if it is not turning
-		if (!turretLeft && !turretRight)
-		{
-			turretGoLeft();
-			iLeftFrames = 0;
-			iRightFrames = 0;
-		}
-		break;
+	// Makes turret turn left if it is not turning
+	if (!turretLeft && !turretRight)
+	{
+		turretGoLeft();
+		iLeftFrames = 0;
+		iRightFrames = 0;
 	}
 }
 
@@ -480,25 +530,32 @@ void NewTank::aimTurret()
 		fAngleDiff -= 360;
 	}
 
+	// A move covering several ticks turns the turret several times as far, so it stops on the target rather than stepping past it. A single tick never turns past the firing window, and is left as it always was
+	if (getStepTicks() > 1)
+	{
+		float fRemaining = std::fabs(fAngleDiff - getTurretTh());
+		limitTurretTurn(fRemaining > 180.f ? 360.f - fRemaining : fRemaining);
+	}
+
 	// If needs to aim left
-	if (fAngleDiff < turretTh)
+	if (fAngleDiff < getTurretTh())
 	{
 		turretGoLeft(); // Go left
 	}
 
 	// If needs to aim right
-	if (fAngleDiff > turretTh)
+	if (fAngleDiff > getTurretTh())
 	{
 		turretGoRight(); // Go right
 	}
 
 	// Same thing but for going across the 359-0 direction
-	if (turretTh < 90 && fAngleDiff > 270)
+	if (getTurretTh() < 90 && fAngleDiff > 270)
 	{
 		turretGoLeft();
 	}
 
-	if (turretTh > 270 && fAngleDiff < 90)
+	if (getTurretTh() > 270 && fAngleDiff < 90)
 	{
 		turretGoRight();
 	}
@@ -506,12 +563,18 @@ void NewTank::aimTurret()
 
 void NewTank::move()
 {
+	// Only aiming limits the turret's turn, and only for this move
+	clearTurretTurnLimit();
+
 	// Sets variables related to a target's location (Their position, the difference in position between the tank and the target and the angle between the tank and the target)
 	setTargetInfo();
 
 	// Checks if tank can see any enemy objects
 	checkVision();
 
+	// Spreads what the tank knows over the map, for choosing goals
+	updateInfluence();
+
 	// Tests conditions to put the tank in the right movement and weapon states
 	setStateMachineConditions();
 	
@@ -528,7 +591,7 @@ void NewTank::move()
 	if ((iMovementState != AIMovementStates::STOPPING) && (iMovementState != AIMovementStates::DODGING))
 	{
 		// Follows path
-		newPos = map.followPath(pos);
+		newPos = map.followPath(getPos(), std::max(1.75f, stepMove() / 2.f)); // Half a move, so a tank driving several ticks a move can't pass over a node
 	}
 
 	else
@@ -539,49 +602,54 @@ void NewTank::move()
 			forward = false;
 		}
 		
-		// Stops backward movement
-		backward = false;
+		// Stops backward movement, unless dodging backwards
+		if (iMovementState != AIMovementStates::DODGING)
+		{
+			backward = false;
+		}
 	}
 
 	// If there is a path to follow
-	if ((newPos != sf::Vector2f(pos.getX(), pos.getY())) && (iMovementState != AIMovementStates::STOPPING) && (iMovementState != AIMovementStates::DODGING))
+	if ((newPos != sf::Vector2f(getX(), getY())) && (iMovementState != AIMovementStates::STOPPING) && (iMovementState != AIMovementStates::DODGING))
 	{
 		// Find the target angle for the tank
-		float fNewAngle = calcAngle(sf::Vector2f(pos.getX(), pos.getY()) - newPos) + 90.f;
+		float fNewAngle = calcAngle(sf::Vector2f(getX(), getY()) - newPos) + 90.f;
 		// Sort it out
 		if (fNewAngle >= 360)
 		{
 			fNewAngle -= 360;
 		}
 		// If facing the correct way
-		if (fNewAngle >= pos.getTh() - kfTurretAccuracyLimit && fNewAngle <= pos.getTh() + kfTurretAccuracyLimit)
+		float fFacingLimit = std::max(params.fTurretAccuracyLimit, stepTurn() / 2.f);
+		float fWrapLimit = std::max(params.fBodyAccuracyLimit, stepTurn() / 2.f);
+		if (fNewAngle >= getTh() - fFacingLimit && fNewAngle <= getTh() + fFacingLimit)
 		{
 			goForward(); // Move forwards
 		}
 		else // If not facing the correct way
 		{
 			// If needs to turn left
-			if (fNewAngle < pos.getTh())
+			if (fNewAngle < getTh())
 			{
 				goLeft(); // Turn left
 			}
 			// If needs to turn right
-			if (fNewAngle > pos.getTh())
+			if (fNewAngle > getTh())
 			{
 				goRight(); // Turn right
 			}
 			// Same thing but for going across the 359-0 direction
-			if (pos.getTh() < 90.f && fNewAngle > 270.f)
+			if (getTh() < 90.f && fNewAngle > 270.f)
 			{
 				goLeft();
 				//std::cout << "Left: " << pos.getTh() << ", " << fNewAngle << std::endl;
 			}
-			if (pos.getTh() > 270.f && fNewAngle < 90.f)
+			if (getTh() > 270.f && fNewAngle < 90.f)
 			{
 				goRight();
 				//std::cout << "Right: " << pos.getTh() << ", " << fNewAngle << std::endl;
 			}
-			if ((pos.getTh() < kfBodyAccuracyLimit && fNewAngle > 360.f - kfBodyAccuracyLimit) || (pos.getTh() > 360.f - kfBodyAccuracyLimit && fNewAngle < kfBodyAccuracyLimit))
+			if ((getTh() < fWrapLimit && fNewAngle > 360.f - fWrapLimit) || (getTh() > 360.f - fWrapLimit && fNewAngle < fWrapLimit))
 			{
 				right = false;
 				left = false;
@@ -596,7 +664,10 @@ void NewTank::move()
 		{
 			forward = false; // Don't move
 		}
-		backward = false;
+		if (iMovementState != AIMovementStates::DODGING)
+		{
+			backward = false;
+		}
 	}
 
 	for (int i = 0; i < map.getWidth(); i++)
@@ -608,7 +679,7 @@ void NewTank::move()
 
 			box.set(nodeBox.left, nodeBox.top, nodeBox.left + nodeBox.width, nodeBox.top + nodeBox.height); // Set the bounding box for the area to check
 
-			map.update(i, j, canSee(box), pos, goalNode); // Update the map
+			map.update(i, j, canSee(box), getPos(), goalNode); // Update the map
 
 			/*BoundingBox boxTopLeft, boxTopRight, boxBottomLeft, boxBottomRight;
 			sf::FloatRect nodeBox = map.getNodeBox(i, j);
@@ -631,15 +702,14 @@ void NewTank::move()
 		}
 	}
 
-	for (int i = 0; i < s_kiNumRectShellPath; i++)
-		shellPath[i].setFillColor(sf::Color(0, 0, 0, 0)); // Reset the fill colour of the shell path rectangles
-
 	// Reset information about closest enemy
 	iClosestEnemyObject = Object::UNKNOWN;
 	closestEnemyPos = noEnemySeenPos;
+	targets.clear();
 
-	// Reset dodging flag
+	// Reset dodging flag, the next shells seen are evaluated next move
 	bDodging = false;
+	shellThreats.clear();
 	
 	// If recently reset
 	if (bResetFlag)
@@ -648,21 +718,35 @@ void NewTank::move()
 		if (iResetFrames > 2)
 		{
 			// Make a new path to the goal (Will go around bases now)
-			map.makeNewPath(pos.getX(), pos.getY(), goalNode);
+			map.makeNewPath(getX(), getY(), goalNode);
 			bResetFlag = false; // To not do it again
 			
 		}	
-		iResetFrames++; // Count frames passing
+		iResetFrames += getStepTicks(); // Count ticks passing
 	}
 }
 
+void NewTank::coast()
+{
+	// Keeps driving and turning as the last move decided, but never fires without aiming again
+	bFiring = false;
+	clearTurretTurnLimit();
+
+	// Anything sensed will be sensed again before the tank next thinks, and an enemy close enough to matter makes it think every timestep
+	iClosestEnemyObject = Object::UNKNOWN;
+	closestEnemyPos = noEnemySeenPos;
+	targets.clear();
+	bDodging = false;
+	shellThreats.clear();
+}
+
 void NewTank::checkStuck()
 {
 	// If position hasn't changed and it is meant to be moving forward or backward
-	if ((pos.getX() == oldPos.getX()) && (pos.getY() == oldPos.getY()) && (!right) && (!left) && (forward || backward))
+	if ((getX() == getOldPos().getX()) && (getY() == getOldPos().getY()) && (!right) && (!left) && (forward || backward))
 	{
 		// Increment counter for amount of frames stuck
-		iStuckFrames++;
+		iStuckFrames += getStepTicks();
 	}
 	else
 	{
@@ -671,9 +755,10 @@ void NewTank::checkStuck()
 	}
 
 	// Changes state to stuck when stuck for 100 frames
-	if (iStuckFrames >= kiStuckMinFrameCount)
+	if (iStuckFrames >= params.iStuckMinFrameCount)
 	{
 		iMovementState = AIMovementStates::STUCK;
+		uiStateEntries[STUCK]++;
 		iStuckFrames = 0;
 		//std::cout << "AI tank is stuck! State being reset." << std::endl;
 	}
@@ -733,7 +818,7 @@ void NewTank::reset()
 
 			sf::FloatRect nodeBorder = map.getNodeBox(nodePos.x, nodePos.y);
 			sf::Vector2f nodeWorldPos = sf::Vector2f(nodeBorder.left + (nodeBorder.width / 2.f), nodeBorder.top + (nodeBorder.height / 2.f));
-			resetTank(nodeWorldPos.x, nodeWorldPos.y, pos.getTh(), turretTh);
+			resetTank(nodeWorldPos.x, nodeWorldPos.y, getTh(), getTurretTh());
 			//std::cout << "Changed pos" << std::endl;
 		}
 		else // If the goal node is traversable
@@ -749,6 +834,18 @@ void NewTank::collided()
 	//right = true;
 }
 
+void NewTank::markMap(sf::FloatRect bounds, Object type)
+{
+	// Into the team's grid when the tank has one, merged into the map once the whole team has looked
+	if (knowledge) knowledge->mark(bounds, type);
+	else map.mark(bounds, type);
+}
+
+void NewTank::mergeKnowledge()
+{
+	if (knowledge) map.merge(*knowledge);
+}
+
 bool NewTank::isFiring()
 {
 	return bFiring; // Shoots if true
@@ -760,69 +857,59 @@ void NewTank::markTarget(Position p)
 	// Get the global bounds of the thing spotted
 	sf::FloatRect targetBounds = sf::FloatRect(sf::Vector2f(p.getX() - (kfBaseExtent/2), p.getY() - (kfBaseExtent / 2)), sf::Vector2f(kfBaseExtent, kfBaseExtent));
 	// Tell map to mark it
-	map.mark(targetBounds, Object::PLAYERBASE);
-	// Compare the position with the current closest object
-	comparePositions(sf::Vector2f(getX(), getY()), sf::Vector2f(p.getX(), p.getY()), Object::PLAYERBASE);
+	markMap(targetBounds, Object::PLAYERBASE);
+	// Scored against the other targets at the start of the next move
+	targets.add(p, Object::PLAYERBASE, 0.f, params.fBaseTargetValue);
 	//bCanSeeEnemyBase = true;
 }
 
+void NewTank::spotTarget(Position p)
+{
+	// A teammate has already marked it, only add it as a target
+	targets.add(p, Object::PLAYERBASE, 0.f, params.fBaseTargetValue);
+}
+
 void NewTank::markEnemy(Position p)
 {
 	//std::cout << "Enemy tank spotted at (" << p.getX() << ", " << p.getY() << ")\n"; // Show in console
 																					 // Get the global bounds of the thing spotted
 	sf::FloatRect targetBounds = sf::FloatRect(sf::Vector2f(p.getX() - (kfTankExtent/2), p.getY() - (kfTankExtent/2)), sf::Vector2f(kfTankExtent, kfTankExtent));
 	// Tell map to mark it
-	map.mark(targetBounds, Object::PLAYERTANK);
-	// Compare the position with the current closest object
-	comparePositions(sf::Vector2f(getX(), getY()), sf::Vector2f(p.getX(), p.getY()), Object::PLAYERTANK);
+	markMap(targetBounds, Object::PLAYERTANK);
+	// Scored against the other targets at the start of the next move
+	targets.add(p, Object::PLAYERTANK, params.fEnemyTargetThreat, params.fEnemyTargetValue);
 	//bCanSeeEnemyTank = true;
 }
 
+void NewTank::spotEnemy(Position p)
+{
+	// A teammate has already marked it, only add it as a target
+	targets.add(p, Object::PLAYERTANK, params.fEnemyTargetThreat, params.fEnemyTargetValue);
+}
+
 void NewTank::markBase(Position p)
 {
 	//std::cout << "Friendly base spotted at (" << p.getX() << ", " << p.getY() << ")\n"; // Show in console
 	// Get the global bounds of the thing spotted
 	sf::FloatRect targetBounds = sf::FloatRect(sf::Vector2f(p.getX() - (kfBaseExtent / 2), p.getY() - (kfBaseExtent / 2)), sf::Vector2f(kfBaseExtent, kfBaseExtent));
 	// Tell map to mark it
-	map.mark(targetBounds, Object::OWNBASE);
+	markMap(targetBounds, Object::OWNBASE);
 }
 
 void NewTank::markShell(Position p)
 {
-	//std::cout << "Shell spotted at (" << p.getX() << ", " << p.getY() << ")\n"; // Show in console
-	// For the global bounds of every point in the path
-	bDodging = true;
-
-	// Bounding boxes for shell path
-	sf::FloatRect targetBounds[s_kiNumRectShellPath];
-
-	// Calculates difference in shell positions
-	sf::Vector2f shellPosDiff = sf::Vector2f(p.getX(), p.getY()) - prevShellPos;
-	prevShellPos = sf::Vector2f(p.getX(), p.getY());
-
-	// Find angle
-	float fAngle = calcAngle(shellPosDiff);
-
-	for (int i = 0; i < s_kiNumRectShellPath; i++)
-	{
-		// Set the rectangle shapes so that they show the path the shell will take
-		shellPath[i].setPosition(sf::Vector2f(p.getX() - (kfShellPathExtent/2), p.getY() - (kfShellPathExtent/2)) + (shellPosDiff * (kfShellPathDist * i)));
-		// shellPath[i].setFillColor(sf::Color(255, 0, 0, 135));
-		// Get the bounds of the point rectangle
-		targetBounds[i] = sf::FloatRect(shellPath[i].getPosition(), shellPath[i].getSize());
-		// Mark the point on the map
-		map.mark(targetBounds[i], Object::PLAYERSHELL);
-	}
-	
-	//map.mark(sf::FloatRect(shellPath.getPosition(), shellPath.getSize()), Object::SHELL);
-
-	//std::cout << fAngle << std::endl;
+	// Remembered with its heading, every shell is evaluated at the start of the next move
+	shellThreats.add(p);
 }
 
 void NewTank::score(int thisScore, int enemyScore)
 {
+	if (quiet) return;
+
 	// Show the score in the console
+#ifdef _WIN32
 	system("CLS");
+#endif
 	std::cout << "AI Score: " << thisScore << "\tPlayer Score: " << enemyScore << std::endl;
 }
 
@@ -859,27 +946,10 @@ float NewTank::calcAngle(sf::Vector2f posDiff)
 	}
 }
 
-void NewTank::comparePositions(sf::Vector2f tankPos, sf::Vector2f checkPos, Object type)
-{
-	// If the object being checked is closer than the current closest object
-	if ((pow(tankPos.x - checkPos.x, 2) + pow(tankPos.y - checkPos.y, 2)) < (pow(tankPos.x - closestEnemyPos.x, 2) + pow(tankPos.y - closestEnemyPos.y, 2)))
-	{
-		// Replaces current closest object with checked object
-		iClosestEnemyObject = Object::PLAYERBASE;
-		closestEnemyPos = checkPos;
-	}
-
-	// Prioritises aiming at player's tank over player's bases
-	if (type == Object::PLAYERTANK)
-	{
-		// Replaces current closest object with checked object
-		iClosestEnemyObject = Object::PLAYERTANK;
-		closestEnemyPos = checkPos;
-	}
-}
-
 sf::Vector2i NewTank::calcNodePos(float fWorldX, float fWorldY)
 {
+	BoundingBox bb = getBb(); // Read once, the tank doesn't move while searching
+
 	// For each node in the map
 	for (int i = 0; i < map.getWidth(); i++)
 	{ 
@@ -898,18 +968,57 @@ sf::Vector2i NewTank::calcNodePos(float fWorldX, float fWorldY)
 	return sf::Vector2i(0, 0);
 }
 
-void NewTank::draw(sf::RenderTarget &target, sf::RenderStates states) const
+void NewTank::saveState(GameSnapshot &snapshot) const
 {
-	// Stuff to draw the tank
-	target.draw(body);
-	target.draw(turret);
+	AITank::saveState(snapshot);
+	map.saveState(snapshot);
+
+	influence.saveState(snapshot);
+	shellThreats.saveState(snapshot);
+	targets.saveState(snapshot);
+	snapshot.write(params);
+	snapshot.write(closestEnemyPos);
+	snapshot.write(closestEnemyPosDiff);
+	snapshot.write(currentTankPos);
+	snapshot.write(prevTankPos);
+	snapshot.write(fAngleDiff);
+	snapshot.write(fDistanceToTarget);
+	snapshot.write(bFiring);
+	snapshot.write(bDodging);
+	snapshot.write(bCanSeeEnemyTank);
+	snapshot.write(bCanSeeEnemyBase);
+	snapshot.write(bResetFlag);
+	snapshot.write(goalNode);
+	snapshot.write(prevGoalNode);
+	snapshot.write(currentNode);
+	snapshot.write(prevNode);
+	snapshot.write(iClosestEnemyObject);
+	snapshot.write(iMovementState);
+	snapshot.write(iWeaponState);
+	snapshot.write(iPrevMovementState);
+	snapshot.write(iPrevWeaponState);
+	snapshot.write(uiStateEntries);
+	snapshot.write(uiStateTimesteps);
+	snapshot.write(uiWeaponStateEntries);
+	snapshot.write(uiWeaponStateTimesteps);
+	snapshot.write(iFollowingFrameCount);
+	snapshot.write(iStuckFrames);
+	snapshot.write(iLeftFrames);
+	snapshot.write(iRightFrames);
+	snapshot.write(iLostPlayerTankFrames);
+	snapshot.write(iResetFrames);
+}
 
-	// Drawing stuff for debug mode
-	if (debugMode)
-	{
-		target.draw(bb); // Drawing bounding box
-		target.draw(map); // Draw the map nodes if in debug mode
-		for (int i = 0; i < s_kiNumRectShellPath; i++)
-			target.draw(shellPath[i]); // Draw the shell path if in debug mode
-	}
+bool NewTank::loadState(GameSnapshot &snapshot)
+{
+	if (!AITank::loadState(snapshot) || !map.loadState(snapshot)) return false;
+
+	return influence.loadState(snapshot) && shellThreats.loadState(snapshot) && targets.loadState(snapshot) && snapshot.read(params) && snapshot.read(closestEnemyPos) && snapshot.read(closestEnemyPosDiff) &&
+		snapshot.read(currentTankPos) && snapshot.read(prevTankPos) && snapshot.read(fAngleDiff) && snapshot.read(fDistanceToTarget) &&
+		snapshot.read(bFiring) && snapshot.read(bDodging) && snapshot.read(bCanSeeEnemyTank) && snapshot.read(bCanSeeEnemyBase) && snapshot.read(bResetFlag) &&
+		snapshot.read(goalNode) && snapshot.read(prevGoalNode) && snapshot.read(currentNode) && snapshot.read(prevNode) &&
+		snapshot.read(iClosestEnemyObject) && snapshot.read(iMovementState) && snapshot.read(iWeaponState) && snapshot.read(iPrevMovementState) && snapshot.read(iPrevWeaponState) &&
+		snapshot.read(uiStateEntries) && snapshot.read(uiStateTimesteps) && snapshot.read(uiWeaponStateEntries) && snapshot.read(uiWeaponStateTimesteps) &&
+		snapshot.read(iFollowingFrameCount) && snapshot.read(iStuckFrames) && snapshot.read(iLeftFrames) && snapshot.read(iRightFrames) &&
+		snapshot.read(iLostPlayerTankFrames) && snapshot.read(iResetFrames);
 }
\ No newline at end of file
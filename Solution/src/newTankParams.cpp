@@ -0,0 +1,114 @@
+/*! \file newTankParams.cpp
+* \brief Source file for the NewTankParams struct.
+*
+* Contains the tuned defaults and the table of parameters by name.
+*/
+
+#include "newTankParams.h"
+
+#include <cmath>
+#include <cstring>
+
+NewTankParams::NewTankParams()
+{
+	iFollowingMinFrameCount = 20;
+	iStuckMinFrameCount = 100;
+	iTurningMinFrameCount = 20;
+	iLostPlayerMinFrameCount = 20;
+
+	fThreatRadius = 35.f;
+	fThreatHorizon = 60.f;
+	fTankThreat = 1.f;
+	fShellThreat = 1.f;
+	fBaseTarget = 1.f;
+	fBaseHome = 0.2f;
+	fEnemyTargetThreat = 1.f;
+	fEnemyTargetValue = 1.f;
+	fBaseTargetValue = 1.f;
+	fViewDistance = 250.f;
+	fTurretAccuracyLimit = 1.25f;
+	fBodyAccuracyLimit = 2.f;
+
+	// Enemy tanks come first, then whichever target is closest, with a small pull towards where the turret already points
+	fUtilityDistance = 1.f;
+	fUtilityAim = 50.f;
+	fUtilityThreat = 1000.f;
+	fUtilityValue = 100.f;
+}
+
+TargetUtility NewTankParams::targetUtility() const
+{
+	TargetUtility utility;
+	utility.fDistance = fUtilityDistance;
+	utility.fAim = fUtilityAim;
+	utility.fThreat = fUtilityThreat;
+	utility.fValue = fUtilityValue;
+	return utility;
+}
+
+// One row per parameter, pointing at an int or a float member
+struct ParamField
+{
+	const char *sName;
+	int NewTankParams::*piValue;
+	float NewTankParams::*pfValue;
+};
+
+static const ParamField s_kFields[] = {
+	{ "FollowingMinFrameCount", &NewTankParams::iFollowingMinFrameCount, nullptr },
+	{ "StuckMinFrameCount", &NewTankParams::iStuckMinFrameCount, nullptr },
+	{ "TurningMinFrameCount", &NewTankParams::iTurningMinFrameCount, nullptr },
+	{ "LostPlayerMinFrameCount", &NewTankParams::iLostPlayerMinFrameCount, nullptr },
+	{ "ThreatRadius", nullptr, &NewTankParams::fThreatRadius },
+	{ "ThreatHorizon", nullptr, &NewTankParams::fThreatHorizon },
+	{ "TankThreat", nullptr, &NewTankParams::fTankThreat },
+	{ "ShellThreat", nullptr, &NewTankParams::fShellThreat },
+	{ "BaseTarget", nullptr, &NewTankParams::fBaseTarget },
+	{ "BaseHome", nullptr, &NewTankParams::fBaseHome },
+	{ "EnemyTargetThreat", nullptr, &NewTankParams::fEnemyTargetThreat },
+	{ "EnemyTargetValue", nullptr, &NewTankParams::fEnemyTargetValue },
+	{ "BaseTargetValue", nullptr, &NewTankParams::fBaseTargetValue },
+	{ "ViewDistance", nullptr, &NewTankParams::fViewDistance },
+	{ "TurretAccuracyLimit", nullptr, &NewTankParams::fTurretAccuracyLimit },
+	{ "BodyAccuracyLimit", nullptr, &NewTankParams::fBodyAccuracyLimit },
+	{ "UtilityDistance", nullptr, &NewTankParams::fUtilityDistance },
+	{ "UtilityAim", nullptr, &NewTankParams::fUtilityAim },
+	{ "UtilityThreat", nullptr, &NewTankParams::fUtilityThreat },
+	{ "UtilityValue", nullptr, &NewTankParams::fUtilityValue }
+};
+
+int NewTankParams::count()
+{
+	return (int)(sizeof(s_kFields) / sizeof(s_kFields[0]));
+}
+
+const char *NewTankParams::name(int i)
+{
+	return s_kFields[i].sName;
+}
+
+bool NewTankParams::isInteger(int i)
+{
+	return s_kFields[i].piValue != nullptr;
+}
+
+int NewTankParams::find(const char *sName)
+{
+	for (int i = 0; i < count(); i++)
+	{
+		if (strcmp(s_kFields[i].sName, sName) == 0) return i;
+	}
+	return -1;
+}
+
+double NewTankParams::get(int i) const
+{
+	if (s_kFields[i].piValue) return this->*s_kFields[i].piValue;
+	return this->*s_kFields[i].pfValue;
+}
+
+void NewTankParams::set(int i, double dValue)
+{
+	if (s_kFields[i].piValue) this->*s_kFields[i].piValue = (int)std::floor(dValue + 0.5);
+	else this->*s_kFields[i].pfValue = (float)dValue;
+}
\ No newline at end of file
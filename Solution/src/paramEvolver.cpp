@@ -0,0 +1,317 @@
+/*! \file paramEvolver.cpp
+* \brief Source file for the ParamEvolver class.
+*
+* Contains the definitions for the ParamEvolver class' constructor and methods.
+*/
+
+#include "paramEvolver.h"
+#include "gameSnapshot.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <numeric>
+
+// Checkpoints start with a tag and version, so a stale or foreign file is rejected
+static const unsigned int s_kuiCheckpointMagic = 0x50435754; // "TWCP"
+static const unsigned int s_kuiCheckpointVersion = 1;
+
+ParamEvolver::ParamEvolver(const GameSetup &newSetup, const EvolverSettings &newSettings, unsigned long long ullNewBaseSeed, int iThreads) : pool(iThreads)
+{
+	setup = newSetup;
+	settings = newSettings;
+	if (settings.iPopulation < 2) settings.iPopulation = 2;
+	settings.iElites = std::max(0, std::min(settings.iElites, settings.iPopulation - 1));
+	if (settings.iTournament < 1) settings.iTournament = 1;
+	if (settings.iHallOfFame < 0) settings.iHallOfFame = 0;
+	settings.iMatchesPerOpponent = settings.iMatchesPerOpponent < 1 ? 2 : (settings.iMatchesPerOpponent + 1) / 2 * 2;
+	ullBaseSeed = ullNewBaseSeed;
+
+	iGeneration = 0;
+	dLastBest = dLastMean = 0.0;
+	dCoreSeconds = 0.0;
+
+	// Each worker builds its games the first time it plays a match on them, one with no DumbTanks, one with them on red and one on blue
+	vGames.resize(pool.threadCount() * 3);
+}
+
+double ParamEvolver::uniform()
+{
+	return (rng.next() + 0.5) / 4294967296.0;
+}
+
+double ParamEvolver::gaussian()
+{
+	// Box-Muller, uniform never returns 0 so the log is finite
+	return std::sqrt(-2.0 * std::log(uniform())) * std::cos(6.283185307179586 * uniform());
+}
+
+int ParamEvolver::tournament()
+{
+	int iBest = rng.range((int)vPopulation.size());
+	for (int i = 1; i < settings.iTournament; i++)
+	{
+		int iOther = rng.range((int)vPopulation.size());
+		if (vdFitness[iOther] > vdFitness[iBest]) iBest = iOther;
+	}
+	return iBest;
+}
+
+void ParamEvolver::clamp(NewTankParams &params) const
+{
+	for (size_t r = 0; r < vRanges.size(); r++)
+	{
+		const SweepRange &range = vRanges[r];
+		double dLow = std::min(range.dLow, range.dHigh);
+		double dHigh = std::max(range.dLow, range.dHigh);
+		params.set(range.iParam, std::min(std::max(params.get(range.iParam), dLow), dHigh));
+	}
+}
+
+void ParamEvolver::start()
+{
+	rng.seed(ullBaseSeed);
+	iGeneration = 0;
+	vHallOfFame.clear();
+
+	// The defaults take part, so the run can only start from something worse if they're outside the ranges
+	vPopulation.assign(settings.iPopulation, NewTankParams());
+	clamp(vPopulation[0]);
+	for (size_t i = 1; i < vPopulation.size(); i++)
+	{
+		for (size_t r = 0; r < vRanges.size(); r++) vPopulation[i].set(vRanges[r].iParam, vRanges[r].dLow + (vRanges[r].dHigh - vRanges[r].dLow) * uniform());
+	}
+	vdFitness.assign(vPopulation.size(), 0.0);
+}
+
+int ParamEvolver::matchesPerSet() const
+{
+	return (1 + (settings.bDumbOpponent ? 1 : 0) + (int)vHallOfFame.size()) * settings.iMatchesPerOpponent;
+}
+
+Game &ParamEvolver::workerGame(int iDumbTeam)
+{
+	std::unique_ptr<Game> &game = vGames[WorkStealingPool::currentWorker() * 3 + iDumbTeam + 1];
+	if (!game)
+	{
+		GameSetup gameSetup = setup;
+		gameSetup.dumbTeam = iDumbTeam;
+		game.reset(new Game(ullBaseSeed, gameSetup));
+	}
+	return *game;
+}
+
+double ParamEvolver::playMatch(Game &game, const NewTankParams &candidate, const NewTankParams &opponent, unsigned long long ullSeed) const
+{
+	// Restarting keeps the tanks' tuning, so it is set first
+	game.setTeamParams(RED_TEAM, candidate);
+	for (int t = BLUE_TEAM; t < setup.teams; t++) game.setTeamParams(t, opponent);
+	game.restart(ullSeed);
+
+	long lTicks = 0;
+	while (!game.gameOver() && lTicks < settings.lMaxTicks)
+	{
+		game.play();
+		lTicks++;
+	}
+
+	// Red against the best of the other teams
+	int iBest = game.getScore(BLUE_TEAM);
+	for (int t = BLUE_TEAM + 1; t < setup.teams; t++) iBest = std::max(iBest, game.getScore(t));
+	if (game.getScore(RED_TEAM) > iBest) return 1.0;
+	if (game.getScore(RED_TEAM) < iBest) return 0.0;
+	return 0.5;
+}
+
+void ParamEvolver::step()
+{
+	if (vPopulation.empty()) start();
+
+	// The defaults, the DumbTanks, whose parameters go unused, then the hall of fame
+	int iDumb = settings.bDumbOpponent ? 1 : -1;
+	std::vector<NewTankParams> opponents(settings.bDumbOpponent ? 2 : 1);
+	opponents.insert(opponents.end(), vHallOfFame.begin(), vHallOfFame.end());
+
+	int iSets = (int)vPopulation.size();
+	int iMatches = matchesPerSet();
+	int iPairsPerOpponent = settings.iMatchesPerOpponent / 2;
+	std::vector<double> vdOutcomes(iSets * iMatches, 0.0);
+	std::atomic<long long> llNanoseconds(0);
+
+	// One task per match, each writes only its own outcome and plays on its own worker's game. Every set plays this generation's seeds, which follow on from the last generation's.
+	// Matches come in pairs on one seed against one opponent, the set taking red then the other teams
+	unsigned long long ullFirstSeed = ullBaseSeed + (unsigned long long)iGeneration * iMatches;
+	for (int s = 0; s < iSets; s++)
+	{
+		for (int m = 0; m < iMatches; m++)
+		{
+			pool.submit([this, &opponents, &vdOutcomes, &llNanoseconds, iMatches, iPairsPerOpponent, iDumb, ullFirstSeed, s, m]
+			{
+				std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+				int iPair = m / 2;
+				int iOpponent = iPair / iPairsPerOpponent;
+				bool bRed = m % 2 == 0;
+				Game &game = workerGame(iOpponent != iDumb ? -1 : bRed ? BLUE_TEAM : RED_TEAM);
+				const NewTankParams &opponent = opponents[iOpponent];
+				unsigned long long ullSeed = ullFirstSeed + (unsigned long long)iPair;
+				vdOutcomes[s * iMatches + m] = bRed ? playMatch(game, vPopulation[s], opponent, ullSeed) : 1.0 - playMatch(game, opponent, vPopulation[s], ullSeed);
+				llNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+			});
+		}
+	}
+	pool.wait();
+	dCoreSeconds = llNanoseconds.load() * 1e-9;
+
+	int iBest = 0;
+	dLastMean = 0.0;
+	for (int s = 0; s < iSets; s++)
+	{
+		vdFitness[s] = std::accumulate(vdOutcomes.begin() + s * iMatches, vdOutcomes.begin() + (s + 1) * iMatches, 0.0) / iMatches;
+		dLastMean += vdFitness[s] / iSets;
+		if (vdFitness[s] > vdFitness[iBest]) iBest = s;
+	}
+	lastBest = vPopulation[iBest];
+	dLastBest = vdFitness[iBest];
+
+	// The best joins the opponents, pushing out the oldest
+	if (settings.iHallOfFame > 0)
+	{
+		vHallOfFame.push_back(lastBest);
+		if ((int)vHallOfFame.size() > settings.iHallOfFame) vHallOfFame.erase(vHallOfFame.begin());
+	}
+
+	iGeneration++;
+	breed();
+}
+
+void ParamEvolver::breed()
+{
+	int iSets = (int)vPopulation.size();
+	std::vector<int> viOrder(iSets);
+	std::iota(viOrder.begin(), viOrder.end(), 0);
+	std::stable_sort(viOrder.begin(), viOrder.end(), [this](int a, int b) { return vdFitness[a] > vdFitness[b]; });
+
+	std::vector<NewTankParams> next;
+	next.reserve(iSets);
+	for (int e = 0; e < settings.iElites; e++) next.push_back(vPopulation[viOrder[e]]);
+
+	// About one parameter mutates per child
+	double dMutationChance = vRanges.empty() ? 0.0 : 1.0 / vRanges.size();
+	while ((int)next.size() < iSets)
+	{
+		const NewTankParams &a = vPopulation[tournament()];
+		const NewTankParams &b = vPopulation[tournament()];
+		bool bBlend = uniform() < settings.dCrossover;
+
+		NewTankParams child = a;
+		for (size_t r = 0; r < vRanges.size(); r++)
+		{
+			const SweepRange &range = vRanges[r];
+			double dValue = a.get(range.iParam);
+			if (bBlend)
+			{
+				// Anywhere between the parents and up to half the gap beyond either, so the population doesn't only shrink inwards
+				double dLow = std::min(dValue, b.get(range.iParam));
+				double dGap = std::max(dValue, b.get(range.iParam)) - dLow;
+				dValue = dLow - 0.5 * dGap + 2.0 * dGap * uniform();
+			}
+			if (uniform() < dMutationChance) dValue += gaussian() * settings.dMutation * (range.dHigh - range.dLow);
+			child.set(range.iParam, dValue);
+		}
+		clamp(child);
+		next.push_back(child);
+	}
+
+	vPopulation.swap(next);
+	vdFitness.assign(iSets, 0.0);
+}
+
+bool ParamEvolver::save(const std::string &sFile) const
+{
+	GameSnapshot snapshot;
+	snapshot.write(s_kuiCheckpointMagic);
+	snapshot.write(s_kuiCheckpointVersion);
+	snapshot.write((int)vRanges.size());
+	for (size_t r = 0; r < vRanges.size(); r++)
+	{
+		snapshot.write(vRanges[r].iParam);
+		snapshot.write(vRanges[r].dLow);
+		snapshot.write(vRanges[r].dHigh);
+	}
+
+	snapshot.write(rng);
+	snapshot.write(iGeneration);
+	snapshot.write(lastBest);
+	snapshot.write(dLastBest);
+	snapshot.write(dLastMean);
+	snapshot.write((int)vPopulation.size());
+	snapshot.writeBytes(vPopulation.data(), vPopulation.size() * sizeof(NewTankParams));
+	snapshot.write((int)vHallOfFame.size());
+	snapshot.writeBytes(vHallOfFame.data(), vHallOfFame.size() * sizeof(NewTankParams));
+
+	// Written whole beside the checkpoint then moved over it, so the old one survives a crash part way through
+	std::string sTemp = sFile + ".tmp";
+	{
+		std::ofstream file(sTemp.c_str(), std::ios::binary);
+		if (!file || !file.write((const char *)snapshot.data(), snapshot.size())) return false;
+	}
+	if (std::rename(sTemp.c_str(), sFile.c_str()) == 0) return true;
+
+	// Windows won't rename over a file that exists
+	std::remove(sFile.c_str());
+	return std::rename(sTemp.c_str(), sFile.c_str()) == 0;
+}
+
+bool ParamEvolver::load(const std::string &sFile)
+{
+	std::ifstream file(sFile.c_str(), std::ios::binary);
+	if (!file) return false;
+	std::vector<char> vBytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	GameSnapshot snapshot;
+	snapshot.assign(vBytes.data(), vBytes.size());
+
+	unsigned int uiMagic, uiVersion;
+	int iRanges;
+	if (!snapshot.read(uiMagic) || uiMagic != s_kuiCheckpointMagic || !snapshot.read(uiVersion) || uiVersion != s_kuiCheckpointVersion) return false;
+	if (!snapshot.read(iRanges) || iRanges != (int)vRanges.size()) return false;
+	for (int r = 0; r < iRanges; r++)
+	{
+		int iParam;
+		double dLow, dHigh;
+		if (!snapshot.read(iParam) || !snapshot.read(dLow) || !snapshot.read(dHigh) || iParam != vRanges[r].iParam || dLow != vRanges[r].dLow || dHigh != vRanges[r].dHigh) return false;
+	}
+
+	// Read into copies, so a damaged file leaves the run as it was
+	Random savedRng;
+	int iSavedGeneration, iSets, iHall;
+	NewTankParams savedBest;
+	double dSavedBest, dSavedMean;
+	if (!snapshot.read(savedRng) || !snapshot.read(iSavedGeneration) || !snapshot.read(savedBest) || !snapshot.read(dSavedBest) || !snapshot.read(dSavedMean)) return false;
+	if (!snapshot.read(iSets) || iSets < 2 || (size_t)iSets > snapshot.size() / sizeof(NewTankParams)) return false;
+	std::vector<NewTankParams> population(iSets);
+	if (!snapshot.readBytes(population.data(), iSets * sizeof(NewTankParams))) return false;
+	if (!snapshot.read(iHall) || iHall < 0 || (size_t)iHall > snapshot.size() / sizeof(NewTankParams)) return false;
+	std::vector<NewTankParams> hall(iHall);
+	if (!snapshot.readBytes(hall.data(), iHall * sizeof(NewTankParams))) return false;
+
+	rng = savedRng;
+	iGeneration = iSavedGeneration;
+	lastBest = savedBest;
+	dLastBest = dSavedBest;
+	dLastMean = dSavedMean;
+	vPopulation.swap(population);
+	vdFitness.assign(vPopulation.size(), 0.0);
+	vHallOfFame.swap(hall);
+	return true;
+}
+
+void ParamEvolver::printGeneration(FILE *file) const
+{
+	fprintf(file, "generation %d: best %.3f, mean %.3f,", iGeneration, dLastBest, dLastMean);
+	for (size_t r = 0; r < vRanges.size(); r++) fprintf(file, " %s=%.4g", NewTankParams::name(vRanges[r].iParam), lastBest.get(vRanges[r].iParam));
+	fprintf(file, "\n");
+}
\ No newline at end of file
@@ -0,0 +1,171 @@
+/*! \file paramSweep.cpp
+* \brief Source file for the ParamSweep class.
+*
+* Contains the definitions for the ParamSweep class' constructor and methods.
+*/
+
+#include "paramSweep.h"
+#include "random.h"
+#include "workStealingPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+
+ParamSweep::ParamSweep(const GameSetup &newSetup, int iNewMatchesPerSet, long lNewMaxTicks, int iNewTickScale, int iNewThreads, unsigned long long ullNewBaseSeed)
+{
+	setup = newSetup;
+	iMatchesPerSet = iNewMatchesPerSet < 1 ? 2 : (iNewMatchesPerSet + 1) / 2 * 2;
+	lMaxTicks = lNewMaxTicks;
+	iTickScale = iNewTickScale < 1 ? 1 : iNewTickScale;
+	iThreads = iNewThreads;
+	ullBaseSeed = ullNewBaseSeed;
+	dCoreSeconds = 0.0;
+}
+
+std::vector<NewTankParams> ParamSweep::grid() const
+{
+	std::vector<NewTankParams> sets(1);
+	for (size_t r = 0; r < vRanges.size(); r++)
+	{
+		const SweepRange &range = vRanges[r];
+		int iSteps = range.iSteps < 1 ? 1 : range.iSteps;
+
+		// Each set so far is copied once per step of this range
+		std::vector<NewTankParams> expanded;
+		expanded.reserve(sets.size() * iSteps);
+		for (size_t n = 0; n < sets.size(); n++)
+		{
+			for (int k = 0; k < iSteps; k++)
+			{
+				NewTankParams params = sets[n];
+				params.set(range.iParam, iSteps == 1 ? range.dLow : range.dLow + (range.dHigh - range.dLow) * k / (iSteps - 1));
+				expanded.push_back(params);
+			}
+		}
+		sets.swap(expanded);
+	}
+	return sets;
+}
+
+std::vector<NewTankParams> ParamSweep::latinHypercube(int iSamples, unsigned long long ullSeed) const
+{
+	std::vector<NewTankParams> sets(iSamples < 0 ? 0 : iSamples);
+	Random rng(ullSeed);
+	std::vector<int> viStrata(sets.size());
+	for (size_t r = 0; r < vRanges.size(); r++)
+	{
+		const SweepRange &range = vRanges[r];
+
+		// Shuffle the strata, so each sample takes a different one
+		for (int i = 0; i < iSamples; i++) viStrata[i] = i;
+		for (int i = iSamples - 1; i > 0; i--) std::swap(viStrata[i], viStrata[rng.range(i + 1)]);
+
+		for (int i = 0; i < iSamples; i++)
+		{
+			double dWithin = (rng.next() + 0.5) / 4294967296.0; // Somewhere inside the stratum
+			sets[i].set(range.iParam, range.dLow + (range.dHigh - range.dLow) * (viStrata[i] + dWithin) / iSamples);
+		}
+	}
+	return sets;
+}
+
+int ParamSweep::playMatch(const NewTankParams &params, int iMatch) const
+{
+	// Each seed is played with the set on red, then with it on every other team against the defaults on red
+	bool bRed = iMatch % 2 == 0;
+	Game game(ullBaseSeed + (unsigned long long)(iMatch / 2), setup);
+	game.setTickScale((unsigned short)iTickScale);
+	if (bRed) game.setTeamParams(RED_TEAM, params);
+	else for (int t = BLUE_TEAM; t < setup.teams; t++) game.setTeamParams(t, params);
+
+	long lTicks = 0;
+	while (!game.gameOver() && lTicks < lMaxTicks)
+	{
+		game.play();
+		lTicks += iTickScale;
+	}
+
+	// Red against the best of the other teams
+	int iBest = game.getScore(BLUE_TEAM);
+	for (int t = BLUE_TEAM + 1; t < setup.teams; t++) iBest = std::max(iBest, game.getScore(t));
+	int iOutcome = game.getScore(RED_TEAM) > iBest ? 1 : game.getScore(RED_TEAM) < iBest ? -1 : 0;
+	return bRed ? iOutcome : -iOutcome;
+}
+
+std::vector<SweepResult> ParamSweep::run(const std::vector<NewTankParams> &sets)
+{
+	int iSets = (int)sets.size();
+	std::vector<int> viOutcomes(iSets * iMatchesPerSet, 0);
+	std::atomic<long long> llNanoseconds(0);
+
+	// One task per match, each writes only its own outcome
+	WorkStealingPool pool(iThreads);
+	for (int s = 0; s < iSets; s++)
+	{
+		for (int m = 0; m < iMatchesPerSet; m++)
+		{
+			pool.submit([this, &sets, &viOutcomes, &llNanoseconds, s, m]
+			{
+				std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+				viOutcomes[s * iMatchesPerSet + m] = playMatch(sets[s], m);
+				llNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+			});
+		}
+	}
+	pool.wait();
+	dCoreSeconds = llNanoseconds.load() * 1e-9;
+
+	std::vector<SweepResult> results(iSets);
+	for (int s = 0; s < iSets; s++)
+	{
+		SweepResult &result = results[s];
+		result.params = sets[s];
+		result.iWins = result.iDraws = result.iLosses = 0;
+		for (int m = 0; m < iMatchesPerSet; m++)
+		{
+			int iOutcome = viOutcomes[s * iMatchesPerSet + m];
+			if (iOutcome > 0) result.iWins++;
+			else if (iOutcome < 0) result.iLosses++;
+			else result.iDraws++;
+		}
+		result.dWinRate = (double)result.iWins / iMatchesPerSet;
+		wilson(result.iWins, iMatchesPerSet, 1.96, result.dLow, result.dHigh);
+	}
+	return results;
+}
+
+void ParamSweep::wilson(int iSuccesses, int iTrials, double dZ, double &dLow, double &dHigh)
+{
+	if (iTrials <= 0)
+	{
+		dLow = 0.0;
+		dHigh = 1.0;
+		return;
+	}
+
+	// Centre pulled towards a half and a width that stays sensible at 0 or n successes, unlike the normal approximation
+	double dP = (double)iSuccesses / iTrials;
+	double dZ2 = dZ * dZ;
+	double dDenominator = 1.0 + dZ2 / iTrials;
+	double dCentre = (dP + dZ2 / (2.0 * iTrials)) / dDenominator;
+	double dHalfWidth = dZ * std::sqrt(dP * (1.0 - dP) / iTrials + dZ2 / (4.0 * iTrials * iTrials)) / dDenominator;
+	dLow = std::max(0.0, dCentre - dHalfWidth);
+	dHigh = std::min(1.0, dCentre + dHalfWidth);
+}
+
+void ParamSweep::printTable(const std::vector<SweepResult> &results, FILE *file) const
+{
+	fprintf(file, "%4s", "set");
+	for (size_t r = 0; r < vRanges.size(); r++) fprintf(file, " %12.12s", NewTankParams::name(vRanges[r].iParam));
+	fprintf(file, " %5s %5s %5s %7s %13s\n", "won", "drew", "lost", "winrate", "95% interval");
+
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const SweepResult &result = results[i];
+		fprintf(file, "%4zu", i);
+		for (size_t r = 0; r < vRanges.size(); r++) fprintf(file, " %12.4g", result.params.get(vRanges[r].iParam));
+		fprintf(file, " %5d %5d %5d %7.3f %6.3f-%.3f\n", result.iWins, result.iDraws, result.iLosses, result.dWinRate, result.dLow, result.dHigh);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+/*! \file random.cpp
+* \brief Source file for the Random class.
+*
+* Contains the definitions for the Random class' constructor and methods.
+*/
+
+#include "random.h"
+
+#include <chrono>
+
+Random::Random(unsigned long long ullSeed)
+{
+	seed(ullSeed);
+}
+
+void Random::seed(unsigned long long ullSeed)
+{
+	// Standard PCG32 seeding, so the first number already depends on every bit of the seed
+	ullState = 0;
+	ullIncrement = (ullSeed << 1u) | 1u;
+	next();
+	ullState += ullSeed;
+	next();
+}
+
+unsigned long long Random::timeSeed()
+{
+	return (unsigned long long)std::chrono::high_resolution_clock::now().time_since_epoch().count();
+}
\ No newline at end of file
@@ -0,0 +1,176 @@
+/*! \file replayLog.cpp
+* \brief Source file for the ReplayLog class.
+*
+* Contains the definitions for the ReplayLog class' constructor and methods.
+*/
+
+#include "replayLog.h"
+#include "game.h"
+
+#include <cstring>
+#include <fstream>
+
+// Keyframes and the index start on 8 byte boundaries so a mapped file can be read in place
+static size_t padTo8(size_t uiSize) { return (uiSize + 7) & ~(size_t)7; }
+
+ReplayLog::ReplayLog()
+{
+	memset(&header, 0, sizeof(header));
+	memcpy(header.cMagic, "TWRP", 4);
+	header.uiVersion = s_kuiVersion;
+	header.uiKeyframeInterval = s_kuiDefaultKeyframeInterval;
+}
+
+void ReplayLog::begin(const Game &game, unsigned int uiKeyframeInterval)
+{
+	vEvents.clear();
+	vKeyframes.clear();
+	vKeyframeData.clear();
+	header.ullSeed = game.getSeed();
+	header.usTickScale = game.getTickScale();
+	header.uiKeyframeInterval = uiKeyframeInterval > 0 ? uiKeyframeInterval : 1;
+
+	// Seeking anywhere needs a keyframe at or before it, so the first is the starting state
+	addKeyframe(game);
+}
+
+void ReplayLog::addKeyframe(const Game &game)
+{
+	game.saveSnapshot(snapshot);
+
+	ReplayKeyframe keyframe;
+	keyframe.uiTick = game.getTick();
+	keyframe.uiSize = (unsigned int)snapshot.size();
+	keyframe.ullOffset = vKeyframeData.size();
+	vKeyframes.push_back(keyframe);
+
+	vKeyframeData.insert(vKeyframeData.end(), snapshot.data(), snapshot.data() + snapshot.size());
+	vKeyframeData.resize(padTo8(vKeyframeData.size()), 0);
+}
+
+void ReplayLog::timestepPlayed(const Game &game)
+{
+	if (isFinished() || game.getTick() % header.uiKeyframeInterval != 0) return;
+	addKeyframe(game);
+}
+
+void ReplayLog::addKey(unsigned int uiTick, int iKey, bool bPressed)
+{
+	if (isFinished()) return;
+
+	ReplayEvent event;
+	event.uiTick = uiTick;
+	event.usKey = (unsigned short)iKey;
+	event.ucType = (unsigned char)(bPressed ? REPLAY_KEY_PRESSED : REPLAY_KEY_RELEASED);
+	event.ucPad = 0;
+	vEvents.push_back(event);
+}
+
+void ReplayLog::end(unsigned int uiTick)
+{
+	if (isFinished()) return;
+
+	ReplayEvent event;
+	event.uiTick = uiTick;
+	event.usKey = 0;
+	event.ucType = REPLAY_END;
+	event.ucPad = 0;
+	vEvents.push_back(event);
+}
+
+unsigned int ReplayLog::getLength() const
+{
+	return isFinished() ? vEvents.back().uiTick : 0;
+}
+
+bool ReplayLog::save(const std::string &sFile) const
+{
+	std::ofstream file(sFile.c_str(), std::ios::binary);
+	if (!file) return false;
+
+	// Keyframes follow the events, then the index with its offsets made absolute
+	size_t uiKeyframeStart = padTo8(sizeof(ReplayHeader) + vEvents.size() * sizeof(ReplayEvent));
+	std::vector<ReplayKeyframe> vIndex(vKeyframes);
+	for (size_t i = 0; i < vIndex.size(); i++) vIndex[i].ullOffset += uiKeyframeStart;
+
+	ReplayHeader out = header;
+	out.uiEventCount = (unsigned int)vEvents.size();
+	out.uiKeyframeCount = (unsigned int)vIndex.size();
+	out.ullIndexOffset = uiKeyframeStart + vKeyframeData.size();
+
+	static const char s_kcZeros[8] = { 0 };
+	file.write((const char *)&out, sizeof(out));
+	if (!vEvents.empty()) file.write((const char *)vEvents.data(), vEvents.size() * sizeof(ReplayEvent));
+	file.write(s_kcZeros, uiKeyframeStart - sizeof(ReplayHeader) - vEvents.size() * sizeof(ReplayEvent));
+	if (!vKeyframeData.empty()) file.write((const char *)vKeyframeData.data(), vKeyframeData.size());
+	if (!vIndex.empty()) file.write((const char *)vIndex.data(), vIndex.size() * sizeof(ReplayKeyframe));
+	return (bool)file;
+}
+
+bool ReplayLog::load(const std::string &sFile)
+{
+	std::ifstream file(sFile.c_str(), std::ios::binary);
+	if (!file) return false;
+
+	ReplayHeader in;
+	if (!file.read((char *)&in, sizeof(in))) return false;
+	if (memcmp(in.cMagic, "TWRP", 4) != 0 || in.uiVersion != s_kuiVersion || in.uiKeyframeInterval == 0) return false;
+
+	std::vector<ReplayEvent> vIn(in.uiEventCount);
+	if (!vIn.empty() && !file.read((char *)vIn.data(), vIn.size() * sizeof(ReplayEvent))) return false;
+
+	// Keyframe data runs from the end of the events up to the index
+	size_t uiKeyframeStart = padTo8(sizeof(ReplayHeader) + vIn.size() * sizeof(ReplayEvent));
+	if (in.ullIndexOffset < uiKeyframeStart) return false;
+	std::vector<unsigned char> vData((size_t)(in.ullIndexOffset - uiKeyframeStart));
+	std::vector<ReplayKeyframe> vIndex(in.uiKeyframeCount);
+	file.seekg(uiKeyframeStart);
+	if (!vData.empty() && !file.read((char *)vData.data(), vData.size())) return false;
+	if (!vIndex.empty() && !file.read((char *)vIndex.data(), vIndex.size() * sizeof(ReplayKeyframe))) return false;
+	for (size_t i = 0; i < vIndex.size(); i++)
+	{
+		if (vIndex[i].ullOffset < uiKeyframeStart || vIndex[i].ullOffset - uiKeyframeStart + vIndex[i].uiSize > vData.size()) return false;
+		vIndex[i].ullOffset -= uiKeyframeStart;
+	}
+
+	header = in;
+	vEvents.swap(vIn);
+	vKeyframes.swap(vIndex);
+	vKeyframeData.swap(vData);
+	return true;
+}
+
+void ReplayLog::applyEvents(Game &game, const ReplayEvent *pEvents, size_t uiCount, size_t &uiNext)
+{
+	while (uiNext < uiCount && pEvents[uiNext].uiTick <= game.getTick())
+	{
+		const ReplayEvent &event = pEvents[uiNext];
+		if (event.ucType == REPLAY_KEY_PRESSED) game.keyPressed((sf::Keyboard::Key)event.usKey);
+		if (event.ucType == REPLAY_KEY_RELEASED) game.keyReleased((sf::Keyboard::Key)event.usKey);
+		if (event.ucType == REPLAY_END) return;
+		uiNext++;
+	}
+}
+
+bool ReplayLog::playback(Game &game) const
+{
+	if (!isFinished()) return false;
+
+	// The first keyframe holds the tanks and arena the game was set up with
+	if (!vKeyframes.empty())
+	{
+		GameSnapshot start;
+		start.assign(vKeyframeData.data() + vKeyframes[0].ullOffset, vKeyframes[0].uiSize);
+		if (!game.loadSnapshot(start)) return false;
+	}
+	game.setTickScale(header.usTickScale);
+
+	size_t uiNext = 0;
+	unsigned int uiLength = getLength();
+	while (game.getTick() < uiLength)
+	{
+		applyEvents(game, uiNext);
+		game.play();
+	}
+	return true;
+}
\ No newline at end of file
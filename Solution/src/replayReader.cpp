@@ -0,0 +1,164 @@
+/*! \file replayReader.cpp
+* \brief Source file for the ReplayReader class.
+*
+* Contains the definitions for the ReplayReader class' constructor, destructor and methods.
+*/
+
+#include "replayReader.h"
+#include "game.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+ReplayReader::ReplayReader()
+{
+	pData = nullptr;
+	uiSize = 0;
+#ifdef _WIN32
+	pFile = nullptr;
+	pMapping = nullptr;
+#endif
+	pHeader = nullptr;
+	pEvents = nullptr;
+	pKeyframes = nullptr;
+	uiNextEvent = 0;
+}
+
+ReplayReader::~ReplayReader()
+{
+	close();
+}
+
+bool ReplayReader::open(const std::string &sFile)
+{
+	close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(sFile.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) return false;
+	pFile = file;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+	{
+		close();
+		return false;
+	}
+	uiSize = (size_t)size.QuadPart;
+
+	pMapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (pMapping) pData = (const unsigned char *)MapViewOfFile(pMapping, FILE_MAP_READ, 0, 0, 0);
+#else
+	int iFile = ::open(sFile.c_str(), O_RDONLY);
+	if (iFile < 0) return false;
+
+	struct stat info;
+	if (fstat(iFile, &info) == 0 && info.st_size > 0)
+	{
+		uiSize = (size_t)info.st_size;
+		void *pMap = mmap(nullptr, uiSize, PROT_READ, MAP_PRIVATE, iFile, 0);
+		if (pMap != MAP_FAILED) pData = (const unsigned char *)pMap;
+	}
+	// The mapping stays valid once the file is closed
+	::close(iFile);
+#endif
+
+	if (!pData || !validate())
+	{
+		close();
+		return false;
+	}
+	return true;
+}
+
+void ReplayReader::close()
+{
+#ifdef _WIN32
+	if (pData) UnmapViewOfFile(pData);
+	if (pMapping) CloseHandle(pMapping);
+	if (pFile) CloseHandle(pFile);
+	pMapping = nullptr;
+	pFile = nullptr;
+#else
+	if (pData) munmap((void *)pData, uiSize);
+#endif
+	pData = nullptr;
+	uiSize = 0;
+	pHeader = nullptr;
+	pEvents = nullptr;
+	pKeyframes = nullptr;
+	uiNextEvent = 0;
+}
+
+bool ReplayReader::validate()
+{
+	if (uiSize < sizeof(ReplayHeader)) return false;
+	const ReplayHeader *pHead = (const ReplayHeader *)pData;
+	if (memcmp(pHead->cMagic, "TWRP", 4) != 0 || pHead->uiVersion != ReplayLog::s_kuiVersion || pHead->uiKeyframeInterval == 0) return false;
+
+	// Events must end with the end record, and seeking needs a keyframe at the start
+	unsigned long long ullEventsEnd = sizeof(ReplayHeader) + (unsigned long long)pHead->uiEventCount * sizeof(ReplayEvent);
+	unsigned long long ullIndexEnd = pHead->ullIndexOffset + (unsigned long long)pHead->uiKeyframeCount * sizeof(ReplayKeyframe);
+	if (pHead->uiEventCount == 0 || pHead->uiKeyframeCount == 0 || ullEventsEnd > pHead->ullIndexOffset || ullIndexEnd > uiSize) return false;
+	if (pHead->ullIndexOffset % 8 != 0) return false;
+
+	const ReplayEvent *pEv = (const ReplayEvent *)(pData + sizeof(ReplayHeader));
+	const ReplayKeyframe *pKey = (const ReplayKeyframe *)(pData + pHead->ullIndexOffset);
+	if (pEv[pHead->uiEventCount - 1].ucType != REPLAY_END || pKey[0].uiTick != 0) return false;
+	for (unsigned int i = 0; i < pHead->uiKeyframeCount; i++)
+	{
+		if (pKey[i].ullOffset < ullEventsEnd || pKey[i].ullOffset + pKey[i].uiSize > pHead->ullIndexOffset) return false;
+		if (i > 0 && pKey[i].uiTick <= pKey[i - 1].uiTick) return false;
+	}
+
+	pHeader = pHead;
+	pEvents = pEv;
+	pKeyframes = pKey;
+	return true;
+}
+
+unsigned int ReplayReader::getLength() const
+{
+	return pEvents[pHeader->uiEventCount - 1].uiTick;
+}
+
+bool ReplayReader::seek(Game &game, unsigned int uiTick)
+{
+	if (uiTick > getLength()) uiTick = getLength();
+
+	// Last keyframe at or before the timestep, the first is always at 0
+	const ReplayKeyframe *pKeyEnd = pKeyframes + pHeader->uiKeyframeCount;
+	const ReplayKeyframe *pKey = std::upper_bound(pKeyframes, pKeyEnd, uiTick,
+		[](unsigned int uiT, const ReplayKeyframe &key) { return uiT < key.uiTick; }) - 1;
+
+	snapshot.assign(pData + pKey->ullOffset, pKey->uiSize);
+	if (!game.loadSnapshot(snapshot)) return false;
+
+	// Keyframes are taken before the events of their timestep
+	const ReplayEvent *pEventEnd = pEvents + pHeader->uiEventCount;
+	uiNextEvent = std::lower_bound(pEvents, pEventEnd, pKey->uiTick,
+		[](const ReplayEvent &event, unsigned int uiT) { return event.uiTick < uiT; }) - pEvents;
+
+	while (game.getTick() < uiTick) step(game);
+	return true;
+}
+
+bool ReplayReader::step(Game &game)
+{
+	if (game.getTick() >= getLength()) return false;
+
+	ReplayLog::applyEvents(game, pEvents, pHeader->uiEventCount, uiNextEvent);
+	game.play();
+	return true;
+}
\ No newline at end of file
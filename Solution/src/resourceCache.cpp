@@ -0,0 +1,65 @@
+/*! \file resourceCache.cpp
+* \brief Source file for the ResourceCache class.
+*
+* Contains the definitions for the ResourceCache class' methods.
+*/
+
+#include "resourceCache.h"
+
+std::map<std::string, std::shared_ptr<const sf::Texture>> ResourceCache::s_textures;
+std::map<std::string, std::shared_ptr<const sf::Font>> ResourceCache::s_fonts;
+std::mutex ResourceCache::s_mutex;
+bool ResourceCache::s_bHeadless = false;
+
+std::shared_ptr<const sf::Texture> ResourceCache::getTexture(const std::string &sFile)
+{
+	// Nothing to draw with
+	if (s_bHeadless) return nullptr;
+
+	std::lock_guard<std::mutex> lock(s_mutex);
+
+	// Already loaded
+	std::map<std::string, std::shared_ptr<const sf::Texture>>::iterator it = s_textures.find(sFile);
+	if (it != s_textures.end()) return it->second;
+
+	// Load it and keep it for next time
+	std::shared_ptr<sf::Texture> texture = std::make_shared<sf::Texture>();
+	texture->loadFromFile(sFile);
+	s_textures[sFile] = texture;
+	return texture;
+}
+
+std::shared_ptr<const sf::Font> ResourceCache::getFont(const std::string &sFile)
+{
+	// Nothing to draw with
+	if (s_bHeadless) return nullptr;
+
+	std::lock_guard<std::mutex> lock(s_mutex);
+
+	// Already loaded
+	std::map<std::string, std::shared_ptr<const sf::Font>>::iterator it = s_fonts.find(sFile);
+	if (it != s_fonts.end()) return it->second;
+
+	// Load it and keep it for next time
+	std::shared_ptr<sf::Font> font = std::make_shared<sf::Font>();
+	font->loadFromFile(sFile);
+	s_fonts[sFile] = font;
+	return font;
+}
+
+void ResourceCache::purge()
+{
+	std::lock_guard<std::mutex> lock(s_mutex);
+
+	// Only the cache holds an asset when its use count is 1
+	for (std::map<std::string, std::shared_ptr<const sf::Texture>>::iterator it = s_textures.begin(); it != s_textures.end();)
+	{
+		if (it->second.use_count() == 1) it = s_textures.erase(it);
+		else ++it;
+	}
+	for (std::map<std::string, std::shared_ptr<const sf::Font>>::iterator it = s_fonts.begin(); it != s_fonts.end();)
+	{
+		if (it->second.use_count() == 1) it = s_fonts.erase(it);
+		else ++it;
+	}
+}
@@ -0,0 +1,82 @@
+/*! \file sharedMemory.cpp
+* \brief Source file for the SharedMemory class.
+*
+* Contains the definitions for the SharedMemory class' constructor and destructor, for Windows and for POSIX systems.
+*/
+
+#include "sharedMemory.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <cstring>
+
+SharedMemory::SharedMemory(size_t uiNewSize, const std::string &sNewName)
+{
+	pData = nullptr;
+	uiSize = uiNewSize;
+	sName = sNewName;
+	pHandle = nullptr;
+	if (uiSize == 0) return;
+
+#ifdef _WIN32
+	// Backed by the paging file, a null name keeps it to this process
+	HANDLE hMapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, (DWORD)((unsigned long long)uiSize >> 32), (DWORD)(uiSize & 0xFFFFFFFFu),
+		sName.empty() ? nullptr : sName.c_str());
+	if (!hMapping) return;
+	pData = MapViewOfFile(hMapping, FILE_MAP_ALL_ACCESS, 0, 0, uiSize);
+	if (!pData)
+	{
+		CloseHandle(hMapping);
+		return;
+	}
+	pHandle = hMapping;
+#else
+	if (sName.empty())
+	{
+		void *pMapped = mmap(nullptr, uiSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+		if (pMapped != MAP_FAILED) pData = pMapped;
+		return;
+	}
+
+	// POSIX names start with a slash, and a block left by a run that crashed is replaced
+	std::string sPath = sName[0] == '/' ? sName : "/" + sName;
+	shm_unlink(sPath.c_str());
+	int iFile = shm_open(sPath.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+	if (iFile < 0) return;
+	if (ftruncate(iFile, (off_t)uiSize) == 0)
+	{
+		void *pMapped = mmap(nullptr, uiSize, PROT_READ | PROT_WRITE, MAP_SHARED, iFile, 0);
+		if (pMapped != MAP_FAILED) pData = pMapped;
+	}
+	close(iFile);
+	if (!pData) shm_unlink(sPath.c_str());
+#endif
+
+	// New mappings are zeroed already, but a learner reading before the first step should see zeros whatever the platform
+	if (pData) memset(pData, 0, uiSize);
+}
+
+SharedMemory::~SharedMemory()
+{
+	if (!pData) return;
+
+#ifdef _WIN32
+	UnmapViewOfFile(pData);
+	CloseHandle((HANDLE)pHandle);
+#else
+	munmap(pData, uiSize);
+	if (!sName.empty()) shm_unlink((sName[0] == '/' ? sName : "/" + sName).c_str());
+#endif
+}
\ No newline at end of file
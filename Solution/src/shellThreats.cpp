@@ -0,0 +1,161 @@
+/*! \file shellThreats.cpp
+* \brief Source file for the ShellThreats class.
+*
+* Contains the definitions for the ShellThreats class' constructor and methods.
+*/
+
+#include "shellThreats.h"
+#include "entityStore.h"
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SHELLTHREATS_SSE
+#endif
+
+ShellThreats::ShellThreats()
+{
+	iCount = 0;
+	while ((int)vfX.size() < s_kiStartCapacity) grow();
+}
+
+void ShellThreats::setPadding(int i)
+{
+	// Far away and flying away, its closest approach is where it is now
+	vfX[i] = 1.0e9f;
+	vfY[i] = 1.0e9f;
+	vfVx[i] = 1.f;
+	vfVy[i] = 0.f;
+}
+
+void ShellThreats::grow()
+{
+	int iSize = (int)vfX.size();
+	int iNewSize = iSize + s_kiWidth;
+	vfX.resize(iNewSize);
+	vfY.resize(iNewSize);
+	vfVx.resize(iNewSize);
+	vfVy.resize(iNewSize);
+	vfTime.resize(iNewSize);
+	vfMissX.resize(iNewSize);
+	vfMissY.resize(iNewSize);
+	for (int i = iSize; i < iNewSize; i++) setPadding(i);
+}
+
+void ShellThreats::clear()
+{
+	for (int i = 0; i < iCount; i++) setPadding(i);
+	iCount = 0;
+}
+
+void ShellThreats::push(float fNewX, float fNewY, float fNewVx, float fNewVy)
+{
+	if (iCount == (int)vfX.size()) grow();
+
+	vfX[iCount] = fNewX;
+	vfY[iCount] = fNewY;
+	vfVx[iCount] = fNewVx;
+	vfVy[iCount] = fNewVy;
+	iCount++;
+}
+
+void ShellThreats::add(Position p)
+{
+	float thRad = DEG2RAD(p.getTh()); // Heading in radians
+	push(p.getX(), p.getY(), cos(thRad) * EntityStore::s_kfShellSpeed, sin(thRad) * EntityStore::s_kfShellSpeed);
+}
+
+ShellThreat ShellThreats::mostUrgent(float fTankX, float fTankY, float fRadius, float fHorizon) const
+{
+	// Plain pointers into the arrays, so the kernel reads as it did over fixed arrays
+	const float *fX = vfX.data();
+	const float *fY = vfY.data();
+	const float *fVx = vfVx.data();
+	const float *fVy = vfVy.data();
+	float *fTime = vfTime.data();
+	float *fMissX = vfMissX.data();
+	float *fMissY = vfMissY.data();
+
+	// Closest approach is at t = (d . v) / (v . v), where d is the tank relative to the shell, clamped to now and the horizon
+	int iEnd = (iCount + 3) & ~3;
+#if defined(SHELLTHREATS_SSE)
+	__m128 tankX = _mm_set1_ps(fTankX);
+	__m128 tankY = _mm_set1_ps(fTankY);
+	__m128 zero = _mm_setzero_ps();
+	__m128 horizon = _mm_set1_ps(fHorizon);
+	for (int i = 0; i < iEnd; i += 4)
+	{
+		__m128 dx = _mm_sub_ps(tankX, _mm_loadu_ps(&fX[i]));
+		__m128 dy = _mm_sub_ps(tankY, _mm_loadu_ps(&fY[i]));
+		__m128 vx = _mm_loadu_ps(&fVx[i]);
+		__m128 vy = _mm_loadu_ps(&fVy[i]);
+		__m128 along = _mm_add_ps(_mm_mul_ps(dx, vx), _mm_mul_ps(dy, vy));
+		__m128 speed2 = _mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy));
+		__m128 t = _mm_min_ps(_mm_max_ps(_mm_div_ps(along, speed2), zero), horizon);
+		_mm_storeu_ps(&fTime[i], t);
+		_mm_storeu_ps(&fMissX[i], _mm_sub_ps(dx, _mm_mul_ps(vx, t)));
+		_mm_storeu_ps(&fMissY[i], _mm_sub_ps(dy, _mm_mul_ps(vy, t)));
+	}
+#else
+	for (int i = 0; i < iEnd; i++)
+	{
+		float dx = fTankX - fX[i];
+		float dy = fTankY - fY[i];
+		float t = (dx * fVx[i] + dy * fVy[i]) / (fVx[i] * fVx[i] + fVy[i] * fVy[i]);
+		if (t < 0.f) t = 0.f;
+		if (t > fHorizon) t = fHorizon;
+		fTime[i] = t;
+		fMissX[i] = dx - fVx[i] * t;
+		fMissY[i] = dy - fVy[i] * t;
+	}
+#endif
+
+	// The soonest of the shells that come close enough, the first seen wins a tie
+	ShellThreat threat;
+	threat.iShell = -1;
+	threat.fTime = fHorizon;
+	threat.fDistance = 0.f;
+	threat.fMissX = 0.f;
+	threat.fMissY = 0.f;
+	for (int i = 0; i < iCount; i++)
+	{
+		float fDistance2 = fMissX[i] * fMissX[i] + fMissY[i] * fMissY[i];
+		if (fDistance2 >= fRadius * fRadius) continue;
+		if (threat.iShell >= 0 && fTime[i] >= threat.fTime) continue;
+
+		threat.iShell = i;
+		threat.fTime = fTime[i];
+		threat.fDistance = sqrt(fDistance2);
+		threat.fMissX = fMissX[i];
+		threat.fMissY = fMissY[i];
+	}
+	return threat;
+}
+
+void ShellThreats::saveState(GameSnapshot &snapshot) const
+{
+	snapshot.write(iCount);
+	for (int i = 0; i < iCount; i++)
+	{
+		snapshot.write(vfX[i]);
+		snapshot.write(vfY[i]);
+		snapshot.write(vfVx[i]);
+		snapshot.write(vfVy[i]);
+	}
+}
+
+bool ShellThreats::loadState(GameSnapshot &snapshot)
+{
+	int iNewCount;
+	if (!snapshot.read(iNewCount) || iNewCount < 0) return false;
+
+	clear();
+	for (int i = 0; i < iNewCount; i++)
+	{
+		float fNewX, fNewY, fNewVx, fNewVy;
+		if (!snapshot.read(fNewX) || !snapshot.read(fNewY) || !snapshot.read(fNewVx) || !snapshot.read(fNewVy)) return false;
+		push(fNewX, fNewY, fNewVx, fNewVy);
+	}
+	return true;
+}
\ No newline at end of file
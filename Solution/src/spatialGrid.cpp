@@ -0,0 +1,107 @@
+/*! \file spatialGrid.cpp
+* \brief Source file for the SpatialGrid class.
+*
+* Contains the definitions for the SpatialGrid class' constructor and methods.
+*/
+
+#include "spatialGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+SpatialGrid::SpatialGrid()
+{
+	fCellSize = 1.f;
+	fMaxHalfExtent = 0.f;
+	iColumns = 0;
+	iRows = 0;
+}
+
+void SpatialGrid::setup(float fWidth, float fHeight, float fNewCellSize, float fNewMaxHalfExtent, int iItems)
+{
+	fCellSize = fNewCellSize;
+	fMaxHalfExtent = fNewMaxHalfExtent;
+	iColumns = std::max(1, (int)std::ceil(fWidth / fCellSize));
+	iRows = std::max(1, (int)std::ceil(fHeight / fCellSize));
+	viHead.assign(iColumns * iRows, -1);
+	resize(iItems);
+}
+
+void SpatialGrid::resize(int iItems)
+{
+	std::fill(viHead.begin(), viHead.end(), -1);
+	viNext.assign(iItems, -1);
+	viPrev.assign(iItems, -1);
+	viCell.assign(iItems, -1);
+}
+
+void SpatialGrid::clear()
+{
+	std::fill(viHead.begin(), viHead.end(), -1);
+	std::fill(viCell.begin(), viCell.end(), -1);
+}
+
+int SpatialGrid::cellX(float fX) const
+{
+	int iX = (int)std::floor(fX / fCellSize);
+	return std::min(std::max(iX, 0), iColumns - 1);
+}
+
+int SpatialGrid::cellY(float fY) const
+{
+	int iY = (int)std::floor(fY / fCellSize);
+	return std::min(std::max(iY, 0), iRows - 1);
+}
+
+void SpatialGrid::unlink(int i)
+{
+	if (viPrev[i] >= 0) viNext[viPrev[i]] = viNext[i];
+	else viHead[viCell[i]] = viNext[i];
+	if (viNext[i] >= 0) viPrev[viNext[i]] = viPrev[i];
+	viCell[i] = -1;
+}
+
+void SpatialGrid::link(int i, int iCell)
+{
+	viCell[i] = iCell;
+	viPrev[i] = -1;
+	viNext[i] = viHead[iCell];
+	if (viNext[i] >= 0) viPrev[viNext[i]] = i;
+	viHead[iCell] = i;
+}
+
+void SpatialGrid::place(int i, float fX, float fY)
+{
+	int iCell = cellY(fY) * iColumns + cellX(fX);
+
+	// Most moves stay inside the same cell
+	if (viCell[i] == iCell) return;
+	if (viCell[i] >= 0) unlink(i);
+	link(i, iCell);
+}
+
+void SpatialGrid::remove(int i)
+{
+	if (viCell[i] >= 0) unlink(i);
+}
+
+void SpatialGrid::query(const BoundingBox &box, std::vector<int> &viOut) const
+{
+	viOut.clear();
+
+	// An item can overlap the box with its centre up to its half size outside it
+	int iX1 = cellX(box.getX1() - fMaxHalfExtent);
+	int iX2 = cellX(box.getX2() + fMaxHalfExtent);
+	int iY1 = cellY(box.getY1() - fMaxHalfExtent);
+	int iY2 = cellY(box.getY2() + fMaxHalfExtent);
+
+	for (int iY = iY1; iY <= iY2; iY++)
+	{
+		for (int iX = iX1; iX <= iX2; iX++)
+		{
+			for (int i = viHead[iY * iColumns + iX]; i >= 0; i = viNext[i]) viOut.push_back(i);
+		}
+	}
+
+	std::sort(viOut.begin(), viOut.end());
+}
\ No newline at end of file
@@ -1,29 +1,30 @@
-#include "Tank.h"
+#include "tank.h"
 #include <iostream>
 
 
 Tank::Tank()
 {
-	fireCounter = 0;
-	debugMode = false;
+	store = nullptr;
+	entity = -1;
+	stepTicks = 1;
+	turretTurnLimit = s_kfNoTurnLimit;
+
+	// Start from a known state, games must play out the same from the same seed. The store starts the position, ammo and reload
+	clearMovement();
+	stopTurret();
 }
 
 const float Tank::moveConst = 1.75f; // Total amount of movement allowed each timestep
 const float Tank::rotMoveConst = 1.25f; // Total amount of rotational movement allowed each timestep for the tank
 const float Tank::turRotMoveConst = 0.75f; // Total amount of rotational movement allowed each timestep for the turrent
+const float Tank::s_kfNoTurnLimit = 1e9f; // Larger than any move's turn, so taking the smaller of the two leaves the turn exactly as it was
 
 void Tank::resetTank(float newX, float newY, float newTh, float newTurretTh)
 {
+	Position pos;
 	pos.set(newX, newY, newTh);
-	turretTh = newTurretTh;
-
-	body.setPosition(newX, newY);
-	body.setRotation(newTh);
-
-	turret.setPosition(newX, newY);
-	turret.setRotation(newTh);
-
-	updateBb();
+	store->setTankPos(entity, pos);
+	store->setTurret(entity, newTurretTh);
 }
 
 void Tank::fireShell()
@@ -31,18 +32,17 @@ void Tank::fireShell()
 	if (canFire())
 	{
 		// Set fire counter
-		fireCounter = 80;
+		store->setReload(entity, 80);
 		// Decrement ammo
-		numberOfShells--;
+		store->setAmmo(entity, store->getAmmo(entity) - 1);
 	}
 }
 
 // Can the tank see the bounding box
 bool Tank::canSee(BoundingBox other) const
 {
-
-	float dx = other.getXc() - bb.getXc();
-	float dy = other.getYc() - bb.getYc();
+	float dx = other.getXc() - store->getTankXc(entity);
+	float dy = other.getYc() - store->getTankYc(entity);
 	float dist = sqrt(dx * dx + dy * dy);
 
 	if (dist > 250.0f) return false;
@@ -50,7 +50,7 @@ bool Tank::canSee(BoundingBox other) const
 
 	float angle = atan2(dy, dx);
 
-	float thRad = DEG2RAD(turretTh);
+	float thRad = DEG2RAD(getTurretTh());
 	if (thRad > PI) { thRad = thRad - 2.0f * PI; }
 	float diff = angle - thRad;
 
@@ -61,6 +61,8 @@ bool Tank::canSee(BoundingBox other) const
 Position Tank::firingPosition() const
 {
 	Position fp;
+	Position pos = getPos();
+	float turretTh = getTurretTh();
 
 	float thRad = DEG2RAD(turretTh);
 	float fireX = cos(thRad) * 40.0f + pos.getX();
@@ -70,23 +72,20 @@ Position Tank::firingPosition() const
 	return fp;
 }
 
-void Tank::updateBb()
-{
-	float x, y;
-	x = pos.getX();
-	y = pos.getY();
-	bb.set(x - 20.0f, y - 20.0f, x + 20.0f, y + 20.0f);
-}
-
 void Tank::implementMove()
 {
+	// Worked on a copy, and written back to the store once
+	Position pos = getPos();
+	float turretTh = getTurretTh();
 	float x, y, th;
 	x = pos.getX();
 	y = pos.getY();
 	th = pos.getTh();
 	float thRad = DEG2RAD(th); // Heading in radians
-	float dx = cos(thRad) * moveConst;
-	float dy = sin(thRad) * moveConst;
+	float dx = cos(thRad) * moveConst * stepTicks;
+	float dy = sin(thRad) * moveConst * stepTicks;
+	float rot = rotMoveConst * stepTicks;
+	float turRot = turretTurn();
 
 	if (forward)
 	{
@@ -100,49 +99,46 @@ void Tank::implementMove()
 
 	if (left)
 	{
-		float newTh = th - rotMoveConst;
+		float newTh = th - rot;
 		if (newTh < 0) { newTh += 360.0; }
 		pos.set(x, y, newTh);
 
-		newTh = turretTh - rotMoveConst;
+		newTh = turretTh - rot;
 		if (newTh < 0) { newTh += 360.0; }
 		turretTh = newTh;
 	}
 
 	if (right)
 	{
-		float newTh = th + rotMoveConst;
+		float newTh = th + rot;
 		if (newTh > 360.0) { newTh -= 360.0; }
 		pos.set(x, y, newTh);
 
-		newTh = turretTh + rotMoveConst;
+		newTh = turretTh + rot;
 		if (newTh > 360.0) { newTh -= 360.0; }
 		turretTh = newTh;
 	}
 
 	if (turretLeft)
 	{
-		float newTh = turretTh - turRotMoveConst;
+		float newTh = turretTh - turRot;
 		if (newTh < 0.0) { newTh += 360.0; }
 		turretTh = newTh;
 	}
 
 	if (turretRight)
 	{
-		float newTh = turretTh + turRotMoveConst;
+		float newTh = turretTh + turRot;
 		if (newTh > 360.0) { newTh -= 360.0; }
 		turretTh = newTh;
 	}
 
-	body.setPosition(pos.getX(), pos.getY());
-	body.setRotation(pos.getTh());
-
-	turret.setPosition(pos.getX(), pos.getY());
-	turret.setRotation(turretTh);
-
-	updateBb(); // Update the bounding box
+	store->setTankPos(entity, pos); // Moves the bounding box too
+	store->setTurret(entity, turretTh);
 	// Decrement fire counter
-	if (fireCounter > 0) fireCounter--;
+	int fireCounter = store->getReload(entity) - stepTicks;
+	if (fireCounter < 0) fireCounter = 0;
+	store->setReload(entity, fireCounter);
 }
 
 void Tank::clearMovement()
@@ -195,62 +191,20 @@ void Tank::stopTurret()
 	turretRight = false;
 }
 
-void Tank::draw(sf::RenderTarget &target, sf::RenderStates states) const // Draw Tank
+void Tank::saveState(GameSnapshot &snapshot) const
 {
-	target.draw(body);
-	target.draw(turret);
-	if (debugMode)target.draw(bb);
-	/*glPushMatrix();
-	glTranslatef(pos.getX(),pos.getY(),0);
-	glRotatef(pos.getTh()-90.0,0.0,0.0,1.0);
-
-	// Main body
-	glColor3f((float)colour.r / 255.0, (float)colour.g / 255.0, (float)colour.b / 255.0);
-	glBegin(GL_QUADS);
-	glVertex2d(-16,24);
-	glVertex2d(16,24);
-	glVertex2d(16,-24);
-	glVertex2d(-16,-24);
-	glEnd();
-
-	// Left track
-	glColor3f(0.0, 0.0, 0.0);
-	glBegin(GL_QUADS);
-	glVertex2d(-24,22);
-	glVertex2d(-17,22);
-	glVertex2d(-17,-22);
-	glVertex2d(-24,-22);
-	glEnd();
-
-	// Right track
-	glColor3f(0.0, 0.0, 0.0);
-	glBegin(GL_QUADS);
-	glVertex2d(24,22);
-	glVertex2d(17,22);
-	glVertex2d(17,-22);
-	glVertex2d(24,-22);
-	glEnd();
-	glPopMatrix();
-
-	glPushMatrix();
-	glTranslatef(pos.getX(),pos.getY(),0);
-	glRotatef(turretTh-90.0,0.0,0.0,1.0);
-	// Turret
-	glColor3f(0.0, 0.0, 0.0);
-	glBegin(GL_QUADS);
-	glVertex2d(-4,10);
-	glVertex2d(4,10);
-	glVertex2d(4,50);
-	glVertex2d(-4,50);
-	glEnd();
-
-	glPopMatrix();
-
-	drawing.drawArc(pos.getX(),pos.getY(),10.0,0,6.28,60,3.0,sf::Color(0,0,0));
-
-	if(debugMode)bb.draw();*/
+	snapshot.write(stepTicks);
+	snapshot.write(forward);
+	snapshot.write(backward);
+	snapshot.write(left);
+	snapshot.write(right);
+	snapshot.write(turretLeft);
+	snapshot.write(turretRight);
 }
 
-
-
-
+bool Tank::loadState(GameSnapshot &snapshot)
+{
+	return snapshot.read(stepTicks) &&
+		snapshot.read(forward) && snapshot.read(backward) && snapshot.read(left) && snapshot.read(right) &&
+		snapshot.read(turretLeft) && snapshot.read(turretRight);
+}
@@ -0,0 +1,122 @@
+/*! \file targetSelector.cpp
+* \brief Source file for the TargetSelector class.
+*
+* Contains the definitions for the TargetSelector class' constructor and methods.
+*/
+
+#include "targetSelector.h"
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TARGETSELECTOR_SSE
+#endif
+
+TargetSelector::TargetSelector()
+{
+	for (int i = 0; i < s_kiCapacity; i++) setPadding(i);
+	iCount = 0;
+}
+
+void TargetSelector::setPadding(int i)
+{
+	fX[i] = 0.f;
+	fY[i] = 0.f;
+	fThreat[i] = 0.f;
+	fValue[i] = 0.f;
+	iType[i] = 0;
+}
+
+void TargetSelector::clear()
+{
+	for (int i = 0; i < iCount; i++) setPadding(i);
+	iCount = 0;
+}
+
+bool TargetSelector::add(Position p, int iNewType, float fNewThreat, float fNewValue)
+{
+	if (iCount == s_kiCapacity) return false;
+
+	fX[iCount] = p.getX();
+	fY[iCount] = p.getY();
+	fThreat[iCount] = fNewThreat;
+	fValue[iCount] = fNewValue;
+	iType[iCount] = iNewType;
+	iCount++;
+	return true;
+}
+
+int TargetSelector::best(float fTankX, float fTankY, float fTurretTh, const TargetUtility &utility) const
+{
+	float fUtility[s_kiCapacity]; // Utility of each target
+	float thRad = DEG2RAD(fTurretTh);
+	float fAimX = cos(thRad); // Direction the turret points in
+	float fAimY = sin(thRad);
+
+	int iEnd = (iCount + 3) & ~3;
+#if defined(TARGETSELECTOR_SSE)
+	__m128 tankX = _mm_set1_ps(fTankX);
+	__m128 tankY = _mm_set1_ps(fTankY);
+	__m128 aimX = _mm_set1_ps(fAimX);
+	__m128 aimY = _mm_set1_ps(fAimY);
+	__m128 wDistance = _mm_set1_ps(utility.fDistance);
+	__m128 wAim = _mm_set1_ps(utility.fAim);
+	__m128 wThreat = _mm_set1_ps(utility.fThreat);
+	__m128 wValue = _mm_set1_ps(utility.fValue);
+	__m128 tiny = _mm_set1_ps(1.0e-6f);
+	for (int i = 0; i < iEnd; i += 4)
+	{
+		__m128 dx = _mm_sub_ps(_mm_loadu_ps(&fX[i]), tankX);
+		__m128 dy = _mm_sub_ps(_mm_loadu_ps(&fY[i]), tankY);
+		__m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+		__m128 aim = _mm_div_ps(_mm_add_ps(_mm_mul_ps(dx, aimX), _mm_mul_ps(dy, aimY)), _mm_max_ps(distance, tiny)); // Cosine of the angle to turn, 0 for a target on top of the tank
+		__m128 sum = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&fValue[i]), wValue), _mm_mul_ps(_mm_loadu_ps(&fThreat[i]), wThreat));
+		sum = _mm_add_ps(sum, _mm_mul_ps(aim, wAim));
+		_mm_storeu_ps(&fUtility[i], _mm_sub_ps(sum, _mm_mul_ps(distance, wDistance)));
+	}
+#else
+	for (int i = 0; i < iEnd; i++)
+	{
+		float dx = fX[i] - fTankX;
+		float dy = fY[i] - fTankY;
+		float fDistance = sqrt(dx * dx + dy * dy);
+		float fAim = (dx * fAimX + dy * fAimY) / (fDistance > 1.0e-6f ? fDistance : 1.0e-6f);
+		fUtility[i] = fValue[i] * utility.fValue + fThreat[i] * utility.fThreat + fAim * utility.fAim - fDistance * utility.fDistance;
+	}
+#endif
+
+	int iBest = -1;
+	for (int i = 0; i < iCount; i++)
+	{
+		if (iBest < 0 || fUtility[i] > fUtility[iBest]) iBest = i;
+	}
+	return iBest;
+}
+
+void TargetSelector::saveState(GameSnapshot &snapshot) const
+{
+	snapshot.write(iCount);
+	for (int i = 0; i < iCount; i++)
+	{
+		snapshot.write(fX[i]);
+		snapshot.write(fY[i]);
+		snapshot.write(fThreat[i]);
+		snapshot.write(fValue[i]);
+		snapshot.write(iType[i]);
+	}
+}
+
+bool TargetSelector::loadState(GameSnapshot &snapshot)
+{
+	int iNewCount;
+	if (!snapshot.read(iNewCount) || iNewCount < 0 || iNewCount > s_kiCapacity) return false;
+
+	clear();
+	for (int i = 0; i < iNewCount; i++)
+	{
+		if (!snapshot.read(fX[i]) || !snapshot.read(fY[i]) || !snapshot.read(fThreat[i]) || !snapshot.read(fValue[i]) || !snapshot.read(iType[i])) return false;
+	}
+	iCount = iNewCount;
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,334 @@
+/*! \file vecEnv.cpp
+* \brief Source file for the VecEnv class.
+*
+* Contains the definitions for the VecEnv class' constructor and methods.
+*/
+
+#include "vecEnv.h"
+#include "map.h"
+#include "position.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <new>
+#include <thread>
+
+// Bounds of a bounding box, in the form the map nodes are marked with
+static sf::FloatRect bounds(const BoundingBox &bb)
+{
+	return sf::FloatRect(bb.getX1(), bb.getY1(), bb.getX2() - bb.getX1(), bb.getY2() - bb.getY1());
+}
+
+// One of the choices 0 to iMost from an action's float, rounded to the nearest, so a learner can send indices or continuous values
+static int choice(float fValue, int iMost)
+{
+	if (!(fValue > 0.5f)) return 0; // Negative, small or not a number
+	if (fValue >= (float)iMost) return iMost;
+	return (int)(fValue + 0.5f);
+}
+
+VecEnv::VecEnv(const VecEnvSettings &newSettings, const GameSetup &newSetup, unsigned long long ullSeed, const std::string &sName) :
+	settings(newSettings), setup(newSetup), iObservationSize(s_kiGridChannels * s_kiGridWidth * s_kiGridHeight + s_kiStateSize),
+	memory(blockBytes(newSettings.iEnvs, iObservationSize, nullptr), sName), pHeader(nullptr),
+	pfActions(nullptr), pfObservations(nullptr), pfRewards(nullptr), pfDones(nullptr), pool(newSettings.iThreads)
+{
+	if (!memory.isMapped()) return;
+
+	size_t uiOffsets[4];
+	blockBytes(settings.iEnvs, iObservationSize, uiOffsets);
+	unsigned char *pucBlock = (unsigned char *)memory.data();
+	VecEnvHeader *pNewHeader = new (pucBlock) VecEnvHeader();
+	pNewHeader->uiEnvs = (unsigned int)settings.iEnvs;
+	pNewHeader->uiActionSize = s_kiActionSize;
+	pNewHeader->uiObservationSize = (unsigned int)iObservationSize;
+	pNewHeader->uiGridChannels = s_kiGridChannels;
+	pNewHeader->uiGridWidth = s_kiGridWidth;
+	pNewHeader->uiGridHeight = s_kiGridHeight;
+	pNewHeader->uiStateSize = s_kiStateSize;
+	pNewHeader->uiActionsOffset = (unsigned int)uiOffsets[0];
+	pNewHeader->uiObservationsOffset = (unsigned int)uiOffsets[1];
+	pNewHeader->uiRewardsOffset = (unsigned int)uiOffsets[2];
+	pNewHeader->uiDonesOffset = (unsigned int)uiOffsets[3];
+	pNewHeader->uiCommand.store(NONE);
+	pNewHeader->uiRequest.store(0);
+	pNewHeader->uiCompleted.store(0);
+	pfActions = (float *)(pucBlock + uiOffsets[0]);
+	pfObservations = (float *)(pucBlock + uiOffsets[1]);
+	pfRewards = (float *)(pucBlock + uiOffsets[2]);
+	pfDones = (float *)(pucBlock + uiOffsets[3]);
+
+	// The grid covers the same nodes as the AI tanks' maps
+	Map layout;
+	layout.setArea(setup.arenaWidth - 20.f, setup.arenaHeight - 20.f);
+	vEnvs.resize(settings.iEnvs);
+	for (int e = 0; e < settings.iEnvs; e++)
+	{
+		vEnvs[e].grid.setLayout(layout);
+		vEnvs[e].ullSeed = ullSeed + (unsigned long long)e;
+		vEnvs[e].lTicks = 0;
+	}
+
+	// Building a game takes milliseconds, so they are built in parallel too
+	for (int e = 0; e < settings.iEnvs; e++)
+	{
+		pool.submit([this, e]
+		{
+			begin(e);
+			observe(e);
+		});
+	}
+	pool.wait();
+
+	// The magic goes in last, so a learner waiting for it finds the first observations written
+	std::atomic_thread_fence(std::memory_order_release);
+	pNewHeader->uiVersion = s_kuiVersion;
+	memcpy(pNewHeader->cMagic, "TWVE", 4);
+	pHeader = pNewHeader;
+}
+
+size_t VecEnv::blockBytes(int iEnvs, int iObservations, size_t *puiOffsets)
+{
+	// Each buffer starts on a cache line of its own
+	const size_t kuiLine = 64;
+	size_t uiSizes[4] = { (size_t)iEnvs * s_kiActionSize * sizeof(float), (size_t)iEnvs * iObservations * sizeof(float), (size_t)iEnvs * sizeof(float), (size_t)iEnvs * sizeof(float) };
+	size_t uiBytes = (sizeof(VecEnvHeader) + kuiLine - 1) / kuiLine * kuiLine;
+	for (int b = 0; b < 4; b++)
+	{
+		if (puiOffsets) puiOffsets[b] = uiBytes;
+		uiBytes += (uiSizes[b] + kuiLine - 1) / kuiLine * kuiLine;
+	}
+	return uiBytes;
+}
+
+int VecEnv::lead(const Game &game)
+{
+	int iBest = game.getScore(RED_TEAM);
+	for (int t = BLUE_TEAM + 1; t < game.getSetup().teams; t++) iBest = std::max(iBest, game.getScore(t));
+	return game.getScore(BLUE_TEAM) - iBest;
+}
+
+void VecEnv::begin(int e)
+{
+	Env &env = vEnvs[e];
+	if (env.game) env.game->restart(env.ullSeed); // Restarting keeps the tick scale, and gives the player a new tank with nothing pressed
+	else
+	{
+		env.game.reset(new Game(env.ullSeed, setup));
+		env.game->setTickScale((unsigned short)settings.iTickScale);
+	}
+	env.lTicks = 0;
+	env.iMargin = lead(*env.game);
+	env.iBody = 0;
+	env.iTurret = 0;
+}
+
+void VecEnv::act(int e)
+{
+	static const sf::Keyboard::Key s_kBodyKeys[5] = { sf::Keyboard::W, sf::Keyboard::W, sf::Keyboard::S, sf::Keyboard::A, sf::Keyboard::D };
+	static const sf::Keyboard::Key s_kTurretKeys[3] = { sf::Keyboard::Left, sf::Keyboard::Left, sf::Keyboard::Right };
+
+	Env &env = vEnvs[e];
+	Game &game = *env.game;
+	const float *pfAction = pfActions + (size_t)e * s_kiActionSize;
+
+	// Keys only change when the action does, as a person would hold them, so recordings stay short
+	int iBody = choice(pfAction[0], 4);
+	if (iBody != env.iBody)
+	{
+		if (iBody == 0) game.keyReleased(s_kBodyKeys[env.iBody]);
+		else game.keyPressed(s_kBodyKeys[iBody]);
+		env.iBody = iBody;
+	}
+
+	int iTurret = choice(pfAction[1], 2);
+	if (iTurret != env.iTurret)
+	{
+		if (iTurret == 0) game.keyReleased(s_kTurretKeys[env.iTurret]);
+		else game.keyPressed(s_kTurretKeys[iTurret]);
+		env.iTurret = iTurret;
+	}
+
+	if (pfAction[2] > 0.5f && game.player.canFire()) game.keyPressed(sf::Keyboard::Space);
+}
+
+void VecEnv::observe(int e)
+{
+	Env &env = vEnvs[e];
+	const Game &game = *env.game;
+	const PlayerTank &me = game.player;
+	const EntityStore &entities = game.getEntities();
+	int iTeam = game.getTankTeam(game.getPlayerIndex());
+	float *pfObservation = pfObservations + (size_t)e * iObservationSize;
+	float *pfState = pfObservation + s_kiGridChannels * s_kiGridWidth * s_kiGridHeight;
+
+	// Nodes take the first object marked, as a tank's map does, so what can hurt the player now wins a node over a building
+	env.grid.clear();
+
+	// Enemy tanks in sight, nearest first
+	env.vNearest.clear();
+	for (int i = 0; i < game.numTanks(); i++)
+	{
+		BoundingBox bb = entities.getTankBox(i);
+		if (game.getTankTeam(i) == iTeam || !me.canSee(bb)) continue;
+		env.grid.mark(bounds(bb), PLAYERTANK);
+		float fDx = bb.getXc() - me.getX();
+		float fDy = bb.getYc() - me.getY();
+		env.vNearest.push_back(std::make_pair(fDx * fDx + fDy * fDy, i));
+	}
+	int iSeen = (int)env.vNearest.size() < s_kiNearest ? (int)env.vNearest.size() : s_kiNearest;
+	std::partial_sort(env.vNearest.begin(), env.vNearest.begin() + iSeen, env.vNearest.end());
+	float *pfTanks = pfState + 9;
+	for (int n = 0; n < s_kiNearest; n++)
+	{
+		float *pfTank = pfTanks + n * 3;
+		if (n < iSeen)
+		{
+			BoundingBox bb = entities.getTankBox(env.vNearest[n].second);
+			pfTank[0] = (bb.getXc() - me.getX()) / setup.arenaWidth;
+			pfTank[1] = (bb.getYc() - me.getY()) / setup.arenaHeight;
+			pfTank[2] = 1.f;
+		}
+		else pfTank[0] = pfTank[1] = pfTank[2] = 0.f;
+	}
+
+	// Enemy shells in sight, nearest first
+	env.vNearest.clear();
+	for (int i = 0; i < entities.shellCount(); i++)
+	{
+		BoundingBox bb = entities.getShellBox(i);
+		if (entities.getShellTeam(i) == iTeam || !me.canSee(bb)) continue;
+		env.grid.mark(bounds(bb), PLAYERSHELL);
+		float fDx = bb.getXc() - me.getX();
+		float fDy = bb.getYc() - me.getY();
+		env.vNearest.push_back(std::make_pair(fDx * fDx + fDy * fDy, i));
+	}
+	iSeen = (int)env.vNearest.size() < s_kiNearest ? (int)env.vNearest.size() : s_kiNearest;
+	std::partial_sort(env.vNearest.begin(), env.vNearest.begin() + iSeen, env.vNearest.end());
+	float *pfShells = pfTanks + s_kiNearest * 3;
+	for (int n = 0; n < s_kiNearest; n++)
+	{
+		float *pfShell = pfShells + n * 5;
+		if (n < iSeen)
+		{
+			int iShell = env.vNearest[n].second;
+			BoundingBox bb = entities.getShellBox(iShell);
+			float fTh = DEG2RAD(entities.getShellPos(iShell).getTh());
+			pfShell[0] = (bb.getXc() - me.getX()) / setup.arenaWidth;
+			pfShell[1] = (bb.getYc() - me.getY()) / setup.arenaHeight;
+			pfShell[2] = sinf(fTh);
+			pfShell[3] = cosf(fTh);
+			pfShell[4] = 1.f;
+		}
+		else pfShell[0] = pfShell[1] = pfShell[2] = pfShell[3] = pfShell[4] = 0.f;
+	}
+
+	// Enemy buildings once the player has seen them, its own always
+	for (int b = 0; b < entities.size(); b++)
+	{
+		if (entities.isBuilding(b) && entities.getTeam(b) != iTeam && entities.isVisible(b)) env.grid.mark(bounds(entities.getBox(b)), PLAYERBASE);
+	}
+	for (int b = 0; b < entities.size(); b++)
+	{
+		if (entities.getTeam(b) == iTeam) env.grid.mark(bounds(entities.getBox(b)), OWNBASE);
+	}
+
+	// One hot channels, in channel, row, column order
+	memset(pfObservation, 0, s_kiGridChannels * s_kiGridWidth * s_kiGridHeight * sizeof(float));
+	for (int i = 0; i < s_kiGridWidth; i++)
+	{
+		for (int j = 0; j < s_kiGridHeight; j++)
+		{
+			int iObject = (int)env.grid.getNodeObject(i, j);
+			if (iObject != UNKNOWN) pfObservation[((iObject - 1) * s_kiGridHeight + j) * s_kiGridWidth + i] = 1.f;
+		}
+	}
+
+	float fTh = DEG2RAD(me.getTh());
+	float fTurretTh = DEG2RAD(me.getTurretTh());
+	pfState[0] = me.getX() / setup.arenaWidth;
+	pfState[1] = me.getY() / setup.arenaHeight;
+	pfState[2] = sinf(fTh);
+	pfState[3] = cosf(fTh);
+	pfState[4] = sinf(fTurretTh);
+	pfState[5] = cosf(fTurretTh);
+	pfState[6] = me.getNumberOfShells() / (float)Tank::startingShells;
+	pfState[7] = me.canFire() ? 1.f : 0.f;
+	pfState[8] = (float)env.lTicks / settings.lMaxTicks;
+}
+
+void VecEnv::stepEnv(int e)
+{
+	Env &env = vEnvs[e];
+	act(e);
+	env.game->play();
+	env.lTicks++;
+
+	int iMargin = lead(*env.game);
+	pfRewards[e] = (float)(iMargin - env.iMargin);
+	env.iMargin = iMargin;
+
+	bool bDone = env.game->gameOver() || env.lTicks >= settings.lMaxTicks;
+	pfDones[e] = bDone ? 1.f : 0.f;
+	if (bDone)
+	{
+		env.ullSeed += (unsigned long long)settings.iEnvs;
+		begin(e);
+	}
+	observe(e);
+}
+
+void VecEnv::reset()
+{
+	for (int e = 0; e < settings.iEnvs; e++)
+	{
+		pool.submit([this, e]
+		{
+			// An episode not yet stepped is already new, so resetting straight after building keeps the first seeds
+			Env &env = vEnvs[e];
+			if (env.lTicks > 0)
+			{
+				env.ullSeed += (unsigned long long)settings.iEnvs;
+				begin(e);
+			}
+			pfRewards[e] = 0.f;
+			pfDones[e] = 0.f;
+			observe(e);
+		});
+	}
+	pool.wait();
+}
+
+void VecEnv::step()
+{
+	for (int e = 0; e < settings.iEnvs; e++) pool.submit([this, e] { stepEnv(e); });
+	pool.wait();
+}
+
+bool VecEnv::serve()
+{
+	if (!isReady()) return false;
+
+	unsigned int uiAnswered = pHeader->uiCompleted.load();
+	int iIdle = 0;
+	for (;;)
+	{
+		unsigned int uiRequest = pHeader->uiRequest.load(std::memory_order_acquire);
+		if (uiRequest == uiAnswered)
+		{
+			// Spins a while, as a learner sends its next step soon after reading the last, then sleeps so a server left waiting doesn't hold a core
+			if (++iIdle < 1000) std::this_thread::yield();
+			else std::this_thread::sleep_for(std::chrono::microseconds(100));
+			continue;
+		}
+		iIdle = 0;
+
+		unsigned int uiCommand = pHeader->uiCommand.load(std::memory_order_acquire);
+		if (uiCommand == STEP) step();
+		else if (uiCommand == RESET) reset();
+		pHeader->uiCompleted.store(uiRequest, std::memory_order_release);
+		uiAnswered = uiRequest;
+		if (uiCommand == QUIT) return true;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,112 @@
+/*! \file workStealingPool.cpp
+* \brief Source file for the WorkStealingPool class.
+*
+* Contains the definitions for the WorkStealingPool class' constructor and methods.
+*/
+
+#include "workStealingPool.h"
+
+thread_local int WorkStealingPool::s_iWorkerIndex = -1;
+
+WorkStealingPool::WorkStealingPool(int iThreads)
+{
+	if (iThreads < 1) iThreads = (int)std::thread::hardware_concurrency();
+	if (iThreads < 1) iThreads = 1;
+
+	iQueued = 0;
+	iUnfinished = 0;
+	bStopping = false;
+	uiNextWorker = 0;
+
+	// Make every queue before starting any thread, so a thief never sees a half built list
+	for (int i = 0; i < iThreads; i++) vWorkers.push_back(std::unique_ptr<Worker>(new Worker));
+	for (int i = 0; i < iThreads; i++) vThreads.push_back(std::thread(&WorkStealingPool::workerLoop, this, i));
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+	wait();
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		bStopping = true;
+	}
+	cvWork.notify_all();
+
+	for (size_t i = 0; i < vThreads.size(); i++) vThreads[i].join();
+}
+
+void WorkStealingPool::submit(std::function<void()> task)
+{
+	// Keep work spawned by a task local to its worker, spread everything else round the queues
+	int iWorker = s_iWorkerIndex;
+	if (iWorker < 0) iWorker = (int)(uiNextWorker++ % vWorkers.size());
+
+	{
+		std::lock_guard<std::mutex> lock(vWorkers[iWorker]->mutex);
+		vWorkers[iWorker]->dqTasks.push_back(std::move(task));
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		iUnfinished++;
+		iQueued++;
+	}
+	cvWork.notify_one();
+}
+
+void WorkStealingPool::wait()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	cvDone.wait(lock, [this] { return iUnfinished == 0; });
+}
+
+bool WorkStealingPool::takeTask(int iWorker, std::function<void()> &task)
+{
+	int iCount = (int)vWorkers.size();
+	for (int n = 0; n < iCount; n++)
+	{
+		// Own queue first, newest task, then the other queues in turn, oldest task
+		int i = (iWorker + n) % iCount;
+		Worker &worker = *vWorkers[i];
+		std::lock_guard<std::mutex> lock(worker.mutex);
+		if (worker.dqTasks.empty()) continue;
+
+		if (n == 0)
+		{
+			task = std::move(worker.dqTasks.back());
+			worker.dqTasks.pop_back();
+		}
+		else
+		{
+			task = std::move(worker.dqTasks.front());
+			worker.dqTasks.pop_front();
+		}
+		iQueued--;
+		return true;
+	}
+	return false;
+}
+
+void WorkStealingPool::workerLoop(int iWorker)
+{
+	s_iWorkerIndex = iWorker;
+
+	for (;;)
+	{
+		std::function<void()> task;
+		if (takeTask(iWorker, task))
+		{
+			task();
+
+			std::lock_guard<std::mutex> lock(mutex);
+			if (--iUnfinished == 0) cvDone.notify_all();
+			continue;
+		}
+
+		// Nothing anywhere, sleep until something is submitted
+		std::unique_lock<std::mutex> lock(mutex);
+		cvWork.wait(lock, [this] { return bStopping || iQueued > 0; });
+		if (bStopping && iQueued == 0) return;
+	}
+}
\ No newline at end of file